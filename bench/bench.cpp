@@ -0,0 +1,1053 @@
+// Micro-benchmarks for the bound box kernels
+//  Usage: sandbox_bench [case ...]
+//  With no arguments, runs every case.  Build with -DSANDBOX_BUILD_BENCHMARKS=ON, in Release.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gaden/BoundBoxTools.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/ConvexHullHierarchy.hpp"
+#include "gaden/ConvexHullTools.hpp"
+#include "gaden/IndexedVector2.hpp"
+#include "gaden/Lattice.hpp"
+#include "gaden/PointCloudTools.hpp"
+#include "gaden/Surface3.hpp"
+#include "gaden/ThreadPool.hpp"
+#include "gaden/Vector3View.hpp"
+
+using namespace gaden;
+
+namespace { // anonymous namespace for local-only functionality
+
+    // Prevent the optimiser from discarding benchmarked results
+    volatile double g_sink = 0.0;
+
+    double nowNs() {
+        return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // Time fn over reps calls, return nanoseconds per call.  Best of three trials.
+    template <class Fn>
+    double timePerCall(int reps, Fn&& fn) {
+        double best = 1e300;
+        for (int trial = 0; trial < 3; ++trial) {
+            const double start = nowNs();
+            for (int r = 0; r < reps; ++r) {
+                fn(r);
+            }
+            best = std::min(best, (nowNs() - start)/reps);
+        }
+        return best;
+    }
+
+    // Convex polygon with n vertices, counter-clockwise, on a randomly rotated ellipse
+    IndexedVector2Field randomConvexPolygon(int n, std::mt19937& rng) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        const double a = 1.0 + 4.0*uniform(rng);
+        const double b = 1.0 + 4.0*uniform(rng);
+        const double rot = 2.0*3.14159265358979*uniform(rng);
+        std::vector<double> angles(n);
+        for (double& t : angles) {
+            t = 2.0*3.14159265358979*uniform(rng);
+        }
+        std::sort(angles.begin(), angles.end());
+        angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+
+        IndexedVector2Field poly;
+        poly.reserve(angles.size());
+        const double c = std::cos(rot);
+        const double s = std::sin(rot);
+        for (const double t : angles) {
+            const double x = a*std::cos(t);
+            const double y = b*std::sin(t);
+            poly.emplace_back(c*x - s*y, s*x + c*y, static_cast<int>(poly.size()));
+        }
+        return poly;
+    }
+
+    // ConvexHullTools::rotatingCalipers vs rotatingCalipersFast on hulls of 10 to 10,000 vertices
+    void benchCalipers() {
+        std::printf("calipers: reference vs trig-free rotating calipers\n");
+        std::printf("%8s %14s %14s %9s %12s\n", "hull", "ref ns/call", "fast ns/call", "speedup",
+            "max rel diff");
+        std::mt19937 rng(12345);
+        const int sizes[] = {10, 30, 100, 300, 1000, 3000, 10000};
+        for (const int n : sizes) {
+            const int nPolys = 16;
+            std::vector<IndexedVector2Field> polys;
+            for (int k = 0; k < nPolys; ++k) {
+                polys.push_back(randomConvexPolygon(n, rng));
+            }
+
+            double maxRelDiff = 0.0;
+            for (const IndexedVector2Field& poly : polys) {
+                const MinRect ref(ConvexHullTools::rotatingCalipers(poly));
+                const MinRect fast(ConvexHullTools::rotatingCalipersFast(poly));
+                maxRelDiff = std::max(maxRelDiff, std::fabs(fast.area() - ref.area())/ref.area());
+            }
+
+            const int reps = std::max(nPolys, 4000000/n);
+            const double refNs = timePerCall(reps, [&](int r) {
+                g_sink = g_sink + ConvexHullTools::rotatingCalipers(polys[r % nPolys]).area();
+            });
+            const double fastNs = timePerCall(reps, [&](int r) {
+                g_sink = g_sink + ConvexHullTools::rotatingCalipersFast(polys[r % nPolys]).area();
+            });
+            std::printf("%8d %14.1f %14.1f %8.2fx %12.2e\n", n, refNs, fastNs, refNs/fastNs,
+                maxRelDiff);
+        }
+    }
+
+    // n points on a randomly scaled ellipsoid surface, all of them on the 3d hull
+    Vector3Field randomEllipsoidPoints(int n, std::mt19937& rng) {
+        std::normal_distribution<double> normal(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(1.0, 5.0);
+        const Vector3 radii(uniform(rng), uniform(rng), uniform(rng));
+        Vector3Field pts;
+        pts.reserve(n);
+        while (static_cast<int>(pts.size()) < n) {
+            Vector3 d(normal(rng), normal(rng), normal(rng));
+            if (!d.normalise()) {
+                continue;
+            }
+            pts.emplace_back(d.x()*radii.x(), d.y()*radii.y(), d.z()*radii.z());
+        }
+        return pts;
+    }
+
+    // One grid window walked cell by cell, independent evaluations vs a coherent serpentine sweep
+    void benchSweep() {
+        std::printf("sweep: steps x steps grid over [0, pi/2]^2, independent vs coherent\n");
+        std::printf("%8s %6s %14s %14s %9s %9s\n", "points", "steps", "ind us/cell",
+            "coh us/cell", "speedup", "same");
+        std::mt19937 rng(4321);
+        const int sizes[] = {100, 1000, 10000};
+        const int stepCounts[] = {10, 40};
+        for (const int n : sizes) {
+            const Vector3Field pts(randomEllipsoidPoints(n, rng));
+            for (const int steps : stepCounts) {
+                const double delta = 0.5*3.14159265358979/steps;
+                double sumInd = 0.0;
+                double sumCoh = 0.0;
+                const double start = nowNs();
+                for (int thetaI = 0; thetaI < steps; ++thetaI) {
+                    for (int phiI = 0; phiI < steps; ++phiI) {
+                        sumInd += BoundBoxTools::evaluateOrientation(
+                            pts, thetaI*delta, phiI*delta, 1e-9
+                        ).volume();
+                    }
+                }
+                const double mid = nowNs();
+                BoundBoxTools::SweepState sweep;
+                for (int thetaI = 0; thetaI < steps; ++thetaI) {
+                    for (int k = 0; k < steps; ++k) {
+                        const int phiI = thetaI % 2 == 1 ? steps - 1 - k : k;
+                        sumCoh += BoundBoxTools::evaluateOrientation(
+                            pts, thetaI*delta, phiI*delta, 1e-9, sweep
+                        ).volume();
+                    }
+                }
+                const double end = nowNs();
+                const double nCells = steps*steps;
+                const double indUs = (mid - start)/nCells*1e-3;
+                const double cohUs = (end - mid)/nCells*1e-3;
+                g_sink = g_sink + sumInd + sumCoh;
+                std::printf("%8d %6d %14.1f %14.1f %8.2fx %9s\n", n, steps, indUs, cohUs,
+                    indUs/cohUs, std::fabs(sumInd - sumCoh) <= 1e-9*sumInd ? "yes" : "NO");
+            }
+        }
+    }
+
+    // Box extents along a slowly rotating frame, scan over all points vs hull graph hill-climbing
+    void benchSupport() {
+        std::printf("support: extents along a frame rotating 1 degree per query\n");
+        std::printf("%8s %10s %14s %14s %9s %11s %6s\n", "points", "build ms", "scan ns/query",
+            "graph ns/query", "speedup", "steps/query", "same");
+        std::mt19937 rng(2468);
+        const int sizes[] = {100, 1000, 10000};
+        for (const int n : sizes) {
+            const Vector3Field pts(randomEllipsoidPoints(n, rng));
+            const double buildStart = nowNs();
+            const ConvexHullGraph graph(pts, 1e-9);
+            const double buildMs = (nowNs() - buildStart)*1e-6;
+
+            const int nQueries = 360;
+            std::vector<Axes> frames;
+            for (int q = 0; q < nQueries; ++q) {
+                const double t = q*3.14159265358979/180.0;
+                const Vector3 x(std::cos(t), std::sin(t), 0.3);
+                const Vector3 z(0.2*std::sin(t), -0.3, 1.0);
+                Vector3 y(z.crossProduct(x));
+                Vector3 zz(x.crossProduct(y));
+                frames.emplace_back(x, y, zz);
+            }
+
+            std::vector<BoundBox> scanBbs(nQueries);
+            const int reps = std::max(1, 2000000/(n*nQueries));
+            const double scanNs = timePerCall(reps, [&](int) {
+                for (int q = 0; q < nQueries; ++q) {
+                    const Vector3* dirs[3] = {&frames[q].x(), &frames[q].y(), &frames[q].z()};
+                    double mins[3] = {1e300, 1e300, 1e300};
+                    double maxs[3] = {-1e300, -1e300, -1e300};
+                    for (const Vector3& p : pts) {
+                        for (int i = 0; i < 3; ++i) {
+                            const double val = p.dotProduct(*dirs[i]);
+                            mins[i] = std::min(mins[i], val);
+                            maxs[i] = std::max(maxs[i], val);
+                        }
+                    }
+                    scanBbs[q] = BoundBox(Vector3(mins[0], mins[1], mins[2]),
+                        Vector3(maxs[0], maxs[1], maxs[2]));
+                }
+            })/nQueries;
+
+            std::vector<BoundBox> graphBbs(nQueries);
+            const int graphReps = std::max(1, 20000000/(nQueries*100));
+            const double graphNs = timePerCall(graphReps, [&](int) {
+                index_t supports[ConvexHullGraph::nExtentSlots] = {-1, -1, -1, -1, -1, -1};
+                for (int q = 0; q < nQueries; ++q) {
+                    graphBbs[q] = graph.extents(frames[q], supports);
+                }
+            })/nQueries;
+
+            // Steps taken, and agreement with the scan
+            bool same = true;
+            long long nSteps = 0;
+            index_t supports[ConvexHullGraph::nExtentSlots] = {-1, -1, -1, -1, -1, -1};
+            for (int q = 0; q < nQueries; ++q) {
+                const Vector3 dirs[3] = {frames[q].x(), frames[q].y(), frames[q].z()};
+                for (int i = 0; i < 3; ++i) {
+                    int steps = 0;
+                    supports[2*i] = graph.support(dirs[i], supports[2*i], &steps);
+                    nSteps += steps;
+                    supports[2*i + 1] = graph.support(dirs[i]*-1.0, supports[2*i + 1], &steps);
+                    nSteps += steps;
+                }
+                const Vector3 d = graphBbs[q].maxPt() - scanBbs[q].maxPt();
+                const Vector3 e = graphBbs[q].minPt() - scanBbs[q].minPt();
+                same &= d.mag() + e.mag() < 1e-9;
+            }
+            std::printf("%8d %10.2f %14.1f %14.1f %8.1fx %11.2f %6s\n", n, buildMs, scanNs,
+                graphNs, scanNs/graphNs, static_cast<double>(nSteps)/nQueries,
+                same ? "yes" : "NO");
+        }
+    }
+
+    // Extreme vertex queries in unrelated directions: scan, hull graph hill-climbing from the last
+    // answer, and the hierarchy descent.  Then the grid solver using each for its box extents.
+    void benchHierarchy() {
+        std::printf("hierarchy: support queries in random directions\n");
+        std::printf("%8s %9s %7s %12s %12s %12s %9s %6s\n", "points", "build ms", "levels",
+            "scan ns", "graph ns", "hier ns", "visited", "same");
+        std::mt19937 rng(97531);
+        const int sizes[] = {100, 1000, 10000, 20000};
+        std::vector<Vector3Field> hulls;
+        std::vector<ConvexHullGraph> graphs;
+        for (const int n : sizes) {
+            hulls.push_back(randomEllipsoidPoints(n, rng));
+            graphs.emplace_back(hulls.back(), 1e-9);
+            const Vector3Field& pts = graphs.back().points();
+
+            const double buildStart = nowNs();
+            const ConvexHullHierarchy hierarchy(graphs.back());
+            const double buildMs = (nowNs() - buildStart)*1e-6;
+
+            const int nQueries = 1024;
+            std::normal_distribution<double> normal(0.0, 1.0);
+            std::vector<Vector3> dirs;
+            while (static_cast<int>(dirs.size()) < nQueries) {
+                Vector3 d(normal(rng), normal(rng), normal(rng));
+                if (d.normalise()) {
+                    dirs.push_back(d);
+                }
+            }
+
+            IndexField scanIdx(nQueries);
+            const double scanNs = timePerCall(std::max(1, 200000/n), [&](int) {
+                for (int q = 0; q < nQueries; ++q) {
+                    int best = 0;
+                    double bestVal = pts[0].dotProduct(dirs[q]);
+                    for (int i = 1; i < static_cast<int>(pts.size()); ++i) {
+                        const double val = pts[i].dotProduct(dirs[q]);
+                        if (val > bestVal) {
+                            bestVal = val;
+                            best = i;
+                        }
+                    }
+                    scanIdx[q] = best;
+                }
+            })/nQueries;
+
+            IndexField graphIdx(nQueries);
+            const double graphNs = timePerCall(20, [&](int) {
+                int start = 0;
+                for (int q = 0; q < nQueries; ++q) {
+                    start = graphs.back().support(dirs[q], start);
+                    graphIdx[q] = start;
+                }
+            })/nQueries;
+
+            IndexField hierIdx(nQueries);
+            const double hierNs = timePerCall(20, [&](int) {
+                for (int q = 0; q < nQueries; ++q) {
+                    hierIdx[q] = hierarchy.support(dirs[q]);
+                }
+            })/nQueries;
+
+            bool same = true;
+            long long nVisited = 0;
+            for (int q = 0; q < nQueries; ++q) {
+                int visited = 0;
+                hierarchy.support(dirs[q], &visited);
+                nVisited += visited;
+                const double ref = pts[scanIdx[q]].dotProduct(dirs[q]);
+                same &= std::fabs(pts[graphIdx[q]].dotProduct(dirs[q]) - ref) < 1e-9;
+                same &= std::fabs(pts[hierIdx[q]].dotProduct(dirs[q]) - ref) < 1e-9;
+            }
+            std::printf("%8d %9.2f %7d %12.1f %12.1f %12.1f %9.1f %6s\n", n, buildMs,
+                hierarchy.nLevels(), scanNs, graphNs, hierNs,
+                static_cast<double>(nVisited)/nQueries, same ? "yes" : "NO");
+        }
+
+        std::printf("\nhierarchy: grid solver (20 steps, 3 passes), box extents by each method\n");
+        std::printf("%8s %12s %12s %12s %12s %6s\n", "points", "scan ms", "graph ms", "coh ms",
+            "hier ms", "same");
+        for (size_t k = 0; k < graphs.size(); ++k) {
+            const Vector3Field& pts = graphs[k].points();
+            const ConvexHullHierarchy hierarchy(graphs[k]);
+            double vols[4];
+            double times[4];
+            for (int method = 0; method < 4; ++method) {
+                Axes axes;
+                Vector3 rotations;
+                const double start = nowNs();
+                const BoundBox bb = BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations,
+                    pts, 20, 3, 1e-9, 1, OrientedBoundBox(), method == 2,
+                    (method == 1 || method == 2) ? &graphs[k] : nullptr,
+                    method == 3 ? &hierarchy : nullptr
+                );
+                times[method] = (nowNs() - start)*1e-6;
+                const Vector3 span = bb.maxPt() - bb.minPt();
+                vols[method] = span.x()*span.y()*span.z();
+            }
+            bool same = true;
+            for (int method = 1; method < 4; ++method) {
+                same &= std::fabs(vols[method] - vols[0]) <= 1e-9*vols[0];
+            }
+            std::printf("%8d %12.1f %12.1f %12.1f %12.1f %6s\n", static_cast<int>(pts.size()),
+                times[0], times[1], times[2], times[3], same ? "yes" : "NO");
+        }
+    }
+
+    // std::sort vs the radix sort of projected points, to tune the PointCloudTools::sortLexicographic
+    // size range
+    void benchRadix() {
+        std::printf("radix: sorting projected points, std::sort vs radix sort\n");
+        std::printf("%8s %14s %14s %9s %6s\n", "points", "std ns/point", "radix ns/point",
+            "speedup", "same");
+        std::mt19937 rng(8642);
+        const int sizes[] = {64, 256, 512, 1024, 2048, 4096, 16384, 65536, 262144};
+        for (const int n : sizes) {
+            const Vector3Field pts(randomEllipsoidPoints(n, rng));
+            IndexedVector2Field projected;
+            PointCloudTools::projectPointsToPlane(pts, 0.3, 0.7, 0.0, projected);
+            // Back to projection order, before the sort
+            IndexedVector2Field unsorted(projected);
+            std::sort(unsorted.begin(), unsorted.end(),
+                [](const IndexedVector2& a, const IndexedVector2& b) { return a.idx() < b.idx(); });
+
+            IndexedVector2Field work;
+            const int reps = std::max(3, 4000000/n);
+            const double stdNs = timePerCall(reps, [&](int) {
+                work = unsorted;
+                std::sort(work.begin(), work.end());
+                g_sink = g_sink + work[0].x();
+            })/n;
+            IndexedVector2Field stdSorted(work);
+            const double radixNs = timePerCall(reps, [&](int) {
+                work = unsorted;
+                PointCloudTools::radixSortLexicographic(work);
+                g_sink = g_sink + work[0].x();
+            })/n;
+            bool same = true;
+            for (int k = 0; k < n; ++k) {
+                same &= work[k].idx() == stdSorted[k].idx();
+            }
+            std::printf("%8d %14.2f %14.2f %8.2fx %6s\n", n, stdNs, radixNs, stdNs/radixNs,
+                same ? "yes" : "NO");
+        }
+    }
+
+    // Lexicographic neighbour-only merge, as projection used before mergePoints2d
+    int mergeConsecutive(double tol, IndexedVector2Field& pts) {
+        int nKept = pts.empty() ? 0 : 1;
+        for (int i = 1; i < static_cast<int>(pts.size()); ++i) {
+            if ((pts[i] - pts[nKept - 1]).magSqr() > tol*tol) {
+                pts[nKept++] = pts[i];
+            }
+        }
+        return nKept;
+    }
+
+    // 2d merge of sorted projected points carrying near-duplicates: neighbour-only merge vs the
+    // grid hash merge
+    void benchMerge2d() {
+        std::printf("merge2d: sorted projection with 4 jittered copies per point\n");
+        std::printf("%8s %8s %14s %8s %14s %8s\n", "points", "tol", "neigh ns/point", "kept",
+            "grid ns/point", "kept");
+        std::mt19937 rng(1357);
+        std::uniform_real_distribution<double> jitter(-1.0, 1.0);
+        const int sizes[] = {1000, 10000, 100000};
+        for (const int n : sizes) {
+            const Vector3Field base(randomEllipsoidPoints(n/4, rng));
+            const double tol = 1e-3;
+            Vector3Field pts;
+            for (const Vector3& p : base) {
+                for (int c = 0; c < 4; ++c) {
+                    pts.push_back(p + Vector3(jitter(rng), jitter(rng), jitter(rng))*(0.3*tol));
+                }
+            }
+            IndexedVector2Field sorted;
+            PointCloudTools::projectPointsToPlane(pts, 0.3, 0.7, 0.0, sorted);
+
+            IndexedVector2Field work;
+            int neighKept = 0;
+            int gridKept = 0;
+            const int reps = std::max(3, 2000000/n);
+            const double neighNs = timePerCall(reps, [&](int) {
+                work = sorted;
+                neighKept = mergeConsecutive(tol, work);
+            })/n;
+            const double gridNs = timePerCall(reps, [&](int) {
+                work = sorted;
+                PointCloudTools::mergePoints2d(tol, work);
+                gridKept = static_cast<int>(work.size());
+            })/n;
+            std::printf("%8d %8.0e %14.2f %8d %14.2f %8d\n", n, tol, neighNs, neighKept, gridNs,
+                gridKept);
+        }
+    }
+
+    // Double precision evaluations vs the float32 screening kernel, then the grid solver with and
+    // without mixed precision
+    void benchFloat32() {
+        std::printf("float32: per-cell cost, double vs float32 screening\n");
+        std::printf("%8s %14s %14s %9s %14s\n", "points", "double us", "float32 us", "speedup",
+            "max rel diff");
+        std::mt19937 rng(7531);
+        const int sizes[] = {100, 1000, 10000};
+        std::vector<Vector3Field> clouds;
+        for (const int n : sizes) {
+            clouds.push_back(randomEllipsoidPoints(n, rng));
+            const Vector3Field& pts = clouds.back();
+            const BoundBoxTools::Float32Points fpts(BoundBoxTools::makeFloat32Points(pts));
+            const int steps = 10;
+            const double delta = 0.5*3.14159265358979/steps;
+            double maxRelDiff = 0.0;
+            for (int c = 0; c < steps*steps; ++c) {
+                const double theta = (c/steps)*delta;
+                const double phi = (c % steps)*delta;
+                const double vd = BoundBoxTools::evaluateOrientation(pts, theta, phi, 1e-9).volume();
+                const double vf =
+                    BoundBoxTools::evaluateOrientationFloat32(fpts, theta, phi).volume();
+                maxRelDiff = std::max(maxRelDiff, std::fabs(vf - vd)/vd);
+            }
+            const int reps = std::max(steps*steps, 2000000/n);
+            const double doubleUs = timePerCall(reps, [&](int r) {
+                const int c = r % (steps*steps);
+                g_sink = g_sink + BoundBoxTools::evaluateOrientation(
+                    pts, (c/steps)*delta, (c % steps)*delta, 1e-9
+                ).volume();
+            })*1e-3;
+            const double floatUs = timePerCall(reps, [&](int r) {
+                const int c = r % (steps*steps);
+                g_sink = g_sink + BoundBoxTools::evaluateOrientationFloat32(
+                    fpts, (c/steps)*delta, (c % steps)*delta
+                ).volume();
+            })*1e-3;
+            std::printf("%8d %14.2f %14.2f %8.2fx %14.2e\n", n, doubleUs, floatUs,
+                doubleUs/floatUs, maxRelDiff);
+        }
+
+        std::printf("\nfloat32: grid solver (20 steps, 3 passes), double vs float32 verifying 8\n");
+        std::printf("%8s %12s %12s %9s %14s\n", "points", "double ms", "mixed ms", "speedup",
+            "volume ratio");
+        for (const Vector3Field& pts : clouds) {
+            double vols[2];
+            double times[2];
+            for (int mixed = 0; mixed < 2; ++mixed) {
+                Axes axes;
+                Vector3 rotations;
+                const double start = nowNs();
+                const BoundBox bb = BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations,
+                    pts, 20, 3, 1e-9, 1, OrientedBoundBox(), false, nullptr, nullptr,
+                    mixed ? 8 : 0
+                );
+                times[mixed] = (nowNs() - start)*1e-6;
+                const Vector3 span = bb.maxPt() - bb.minPt();
+                vols[mixed] = span.x()*span.y()*span.z();
+            }
+            std::printf("%8d %12.1f %12.1f %8.2fx %14.8f\n", static_cast<int>(pts.size()),
+                times[0], times[1], times[0]/times[1], vols[1]/vols[0]);
+        }
+    }
+
+    // Merging and the 3d hull on the same cloud stored in double and in single precision
+    void benchPrecision() {
+        std::printf("precision: merge and 3d hull, Vector3Field vs Vector3fField\n");
+        std::printf("%8s %10s %10s %12s %12s %12s %12s %8s\n", "points", "double KB", "float KB",
+            "merge d ms", "merge f ms", "hull d ms", "hull f ms", "hull d/f");
+        std::mt19937 rng(97531);
+        const int sizes[] = {1000, 3000, 10000};
+        for (const int n : sizes) {
+            const Vector3Field pts(randomEllipsoidPoints(n, rng));
+            Vector3fField fpts;
+            fpts.reserve(pts.size());
+            for (const Vector3& p : pts) {
+                fpts.push_back(Vector3f(p));
+            }
+            const double tol = 1e-6;
+            IndexField map;
+            Vector3Field merged;
+            Vector3fField fmerged;
+            const double mergeMs = timePerCall(1, [&](int) {
+                PointCloudTools::mergePointsSubset(pts, tol, n, map, merged);
+            })*1e-6;
+            const double fmergeMs = timePerCall(1, [&](int) {
+                PointCloudTools::mergePointsSubset(fpts, tol, n, map, fmerged);
+            })*1e-6;
+
+            Vector3Field chPts;
+            IndexField chVertices;
+            std::vector<Face> chFaces;
+            int nHull[2] = {0, 0};
+            const double hullMs = timePerCall(1, [&](int) {
+                ConvexHullTools::calculateConvexHull3d(merged, tol, chPts, chVertices, chFaces);
+                nHull[0] = static_cast<int>(chVertices.size());
+            })*1e-6;
+            const double fhullMs = timePerCall(1, [&](int) {
+                ConvexHullTools::calculateConvexHull3d(fmerged, tol, chPts, chVertices, chFaces);
+                nHull[1] = static_cast<int>(chVertices.size());
+            })*1e-6;
+            std::printf("%8d %10.1f %10.1f %12.2f %12.2f %12.2f %12.2f %4d/%-4d\n", n,
+                n*sizeof(Vector3)/1024.0, n*sizeof(Vector3f)/1024.0, mergeMs, fmergeMs, hullMs,
+                fhullMs, nHull[0], nHull[1]);
+        }
+    }
+
+    // 3d hull on real coordinates vs lattice coordinates with exact predicates, on a random cloud
+    // and on a cube grid, where most surface points are coplanar with a face
+    void benchLattice() {
+        std::printf("lattice: 3d hull, double with tolerance vs lattice with exact predicates\n");
+        std::printf("%8s %8s %10s %10s %12s %12s %10s %10s\n", "cloud", "points", "double KB",
+            "lattice KB", "double ms", "lattice ms", "double hv", "lattice hv");
+        std::mt19937 rng(24680);
+        for (int c = 0; c < 4; ++c) {
+            const bool grid = c >= 2;
+            Vector3Field pts;
+            if (grid) {
+                const int side = c == 2 ? 10 : 20;
+                for (int i = 0; i < side; ++i) {
+                    for (int j = 0; j < side; ++j) {
+                        for (int k = 0; k < side; ++k) {
+                            pts.push_back(Vector3(0.1*i, 0.1*j, 0.1*k));
+                        }
+                    }
+                }
+            } else {
+                pts = randomEllipsoidPoints(c == 0 ? 1000 : 3000, rng);
+            }
+            const int n = static_cast<int>(pts.size());
+            const Lattice lattice(
+                Lattice::fit(BoundBox::calculateAxisAlignedBoundBox(pts), 1e-9)
+            );
+            const Vector3iField latticePts(lattice.quantize(pts));
+
+            Vector3Field chPts;
+            IndexField chVertices;
+            std::vector<Face> chFaces;
+            int nHull[2] = {0, 0};
+            const double doubleMs = timePerCall(1, [&](int) {
+                ConvexHullTools::calculateConvexHull3d(pts, 1e-9, chPts, chVertices, chFaces);
+                nHull[0] = static_cast<int>(chVertices.size());
+            })*1e-6;
+            const double latticeMs = timePerCall(1, [&](int) {
+                ConvexHullTools::calculateConvexHull3d(latticePts, chPts, chVertices, chFaces);
+                nHull[1] = static_cast<int>(chVertices.size());
+            })*1e-6;
+            std::printf("%8s %8d %10.1f %10.1f %12.2f %12.2f %10d %10d\n",
+                grid ? "grid" : "random", n, n*sizeof(Vector3)/1024.0,
+                n*sizeof(Vector3i)/1024.0, doubleMs, latticeMs, nHull[0], nHull[1]);
+        }
+    }
+
+    // Grid search on the full hull vs on its epsilon-kernel, re-measured on the full hull, for
+    // points on an ellipsoid, where every point is a hull vertex
+    void benchKernel() {
+        std::printf("kernel: grid search on the hull vs on an epsilon-kernel of it\n");
+        std::printf("%8s %8s %8s %10s %8s %12s %12s %10s %10s\n", "hull", "epsilon", "kernel",
+            "kernel ms", "eps out", "hull ms", "kernel+ ms", "vol ratio", "bound");
+        std::mt19937 rng(97531);
+        const int sizes[] = {2000, 8000};
+        const double epsilons[] = {0.1, 0.05, 0.02};
+        const auto volume = [](const BoundBox& bb) {
+            const Vector3 span(bb.maxPt() - bb.minPt());
+            return span.x()*span.y()*span.z();
+        };
+        for (const int n : sizes) {
+            const ConvexHullGraph graph(randomEllipsoidPoints(n, rng), 1e-9);
+            Axes axes;
+            Vector3 rotations;
+            double hullVolume = 0.0;
+            const double hullMs = timePerCall(1, [&](int) {
+                hullVolume = volume(BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations, graph.points(), 7, 2, 1e-9
+                ));
+            })*1e-6;
+            for (const double epsilon : epsilons) {
+                double epsilonOut = 0.0;
+                IndexField kernel;
+                const double kernelMs = timePerCall(1, [&](int) {
+                    kernel = graph.epsilonKernel(epsilon, epsilonOut);
+                })*1e-6;
+                Vector3Field kernelPts;
+                for (const index_t i : kernel) {
+                    kernelPts.push_back(graph.points()[i]);
+                }
+                double kernelVolume = 0.0;
+                const double solveMs = timePerCall(1, [&](int) {
+                    BoundBox::solveMinimumRotatedBoundBox(
+                        axes, rotations, kernelPts, 7, 2, 1e-9
+                    );
+                    index_t supports[ConvexHullGraph::nExtentSlots] = {-1, -1, -1, -1, -1, -1};
+                    kernelVolume = volume(graph.extents(axes, supports));
+                })*1e-6;
+                std::printf("%8d %8.3f %8d %10.2f %8.4f %12.2f %12.2f %10.4f %10.4f\n",
+                    graph.size(), epsilon, static_cast<int>(kernel.size()), kernelMs, epsilonOut,
+                    hullMs, kernelMs + solveMs, kernelVolume/hullVolume,
+                    1.0/std::pow(1.0 - epsilonOut, 3));
+            }
+        }
+    }
+
+    // Full solve (hull of every point, then grid search) vs the coarse-to-fine epsilon ladder, on
+    // a scan-like cloud: points on an ellipsoid surface, each one a hull vertex
+    void benchLadder() {
+        std::printf("ladder: hull of every point + grid vs coarse-to-fine epsilon ladder\n");
+        std::printf("%8s %10s %10s %6s %10s %10s\n", "points", "full ms", "ladder ms", "rungs",
+            "full vol", "ladder vol");
+        std::mt19937 rng(86420);
+        const int sizes[] = {5000, 20000};
+        for (const int n : sizes) {
+            const Vector3Field pts(randomEllipsoidPoints(n, rng));
+            const auto volume = [](const BoundBox& bb) {
+                const Vector3 span(bb.maxPt() - bb.minPt());
+                return span.x()*span.y()*span.z();
+            };
+            Axes axes;
+            Vector3 rotations;
+            double fullVolume = 0.0;
+            const double fullMs = timePerCall(1, [&](int) {
+                const ConvexHullGraph graph(pts, 1e-9);
+                fullVolume = volume(BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations, graph.points(), 7, 2, 1e-9, 1, OrientedBoundBox(), false,
+                    &graph
+                ));
+            })*1e-6;
+            double ladderVolume = 0.0;
+            int nRungs = 0;
+            const double ladderMs = timePerCall(1, [&](int) {
+                ladderVolume = volume(BoundBoxTools::solveEpsilonLadder(
+                    axes, rotations, nRungs, pts, 0.0, 1e-3, 1e-2, 7, 2, 1e-9
+                ));
+            })*1e-6;
+            std::printf("%8d %10.1f %10.1f %6d %10.4f %10.4f\n", n, fullMs, ladderMs, nRungs,
+                fullVolume, ladderVolume);
+        }
+    }
+
+    // Anytime search at increasing time budgets: best volume, certified gap, and how far past
+    // the deadline it returns
+    void benchAnytime() {
+        std::printf("anytime: branch-and-bound under a deadline, ellipsoid hull\n");
+        std::printf("%8s %10s %10s %12s %10s %12s\n", "hull", "budget ms", "evals", "volume",
+            "gap", "overrun ms");
+        std::mt19937 rng(11235);
+        const ConvexHullGraph graph(randomEllipsoidPoints(2000, rng), 1e-9);
+        const double budgets[] = {5.0, 20.0, 100.0, 500.0};
+        for (const double budget : budgets) {
+            BoundBoxTools::StopCondition stop;
+            const double start = nowNs();
+            stop.m_deadline = std::chrono::steady_clock::now()
+                + std::chrono::microseconds(static_cast<long long>(budget*1e3));
+            Axes axes;
+            Vector3 rotations;
+            double gap = 0.0;
+            int nEvals = 0;
+            const BoundBox bb(BoundBoxTools::solveAnytime(
+                axes, rotations, gap, nEvals, graph.points(), stop, 1e-9, OrientedBoundBox(),
+                &graph
+            ));
+            const double elapsedMs = (nowNs() - start)*1e-6;
+            const Vector3 span(bb.maxPt() - bb.minPt());
+            std::printf("%8d %10.0f %10d %12.5f %10.5f %12.2f\n", graph.size(), budget, nEvals,
+                span.x()*span.y()*span.z(), gap, elapsedMs - budget);
+        }
+    }
+
+    // Auto-tuned grid at decreasing target errors: schedule chosen, the model's estimate, the
+    // certified gap, and the error against a fine reference search
+    void benchAutoTune() {
+        std::printf("autotune: grid schedule chosen from a target relative volume error\n");
+        std::printf("%8s %10s %-24s %8s %10s %10s %10s %10s\n", "hull", "target", "steps",
+            "evals", "ms", "estimated", "certified", "true");
+        std::mt19937 rng(31415);
+        const ConvexHullGraph graph(randomEllipsoidPoints(500, rng), 1e-9);
+        const auto volume = [](const BoundBox& bb) {
+            const Vector3 span(bb.maxPt() - bb.minPt());
+            return span.x()*span.y()*span.z();
+        };
+        Axes axes;
+        Vector3 rotations;
+        const double reference = volume(BoundBox::solveMinimumRotatedBoundBox(
+            axes, rotations, graph.points(), 40, 6, 1e-9, 4
+        ));
+        const double grid = volume(BoundBox::solveMinimumRotatedBoundBox(
+            axes, rotations, graph.points(), 9, 6, 1e-9
+        ));
+        std::printf("%8d %10s %-24s %8d %10s %10s %10s %10.2e\n", graph.size(), "grid",
+            "9x6", 9*9*6, "", "", "", (grid - std::min(grid, reference))/reference);
+        const double targets[] = {1e-2, 1e-3, 1e-4, 1e-5};
+        for (const double target : targets) {
+            BoundBoxTools::AutoTuneReport report;
+            double achieved = 0.0;
+            const double ms = timePerCall(1, [&](int) {
+                achieved = volume(BoundBoxTools::solveAutoTuned(
+                    axes, rotations, report, graph.points(), target, 0.0, 1e-9,
+                    OrientedBoundBox(), &graph
+                ));
+            })*1e-6;
+            char schedule[64] = "";
+            for (const int steps : report.m_steps) {
+                char buf[16];
+                std::snprintf(buf, sizeof(buf), "%s%d", schedule[0] ? "," : "", steps);
+                std::strncat(schedule, buf, sizeof(schedule) - std::strlen(schedule) - 1);
+            }
+            std::printf("%8d %10.0e %-24s %8d %10.2f %10.2e %10.2e %10.2e\n", graph.size(),
+                target, schedule, report.m_nEvaluations, ms, report.m_estimatedError,
+                report.m_achievedError, (achieved - std::min(achieved, reference))/reference);
+        }
+    }
+
+    // Fixed up axis, one projection over every point with no 3d hull, and the axis cone on a hull
+    void benchFixedAxis() {
+        std::printf("fixedaxis: box with the third axis fixed to z, every point of a solid box\n");
+        std::printf("%8s %12s\n", "points", "us/part");
+        std::mt19937 rng(2718);
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        const Vector3 up(0.0, 0.0, 1.0);
+        for (const int n : {1000, 10000, 100000}) {
+            Vector3Field pts;
+            pts.reserve(n);
+            for (int i = 0; i < n; ++i) {
+                pts.emplace_back(3.0*uniform(rng), 2.0*uniform(rng), uniform(rng));
+            }
+            const double ns = timePerCall(std::max(1, 200000/n), [&](int) {
+                g_sink = g_sink + BoundBoxTools::solveFixedAxis(pts, up, 1e-9).volume();
+            });
+            std::printf("%8d %12.1f\n", n, ns*1e-3);
+        }
+
+        std::printf("\nfixedaxis: axis cone about z on an ellipsoid hull, steps 9, passes 6\n");
+        std::printf("%8s %12s %12s\n", "cone", "volume", "ms");
+        const Vector3Field hull(randomEllipsoidPoints(2000, rng));
+        for (const double cone : {0.0, 5.0, 15.0, 45.0, 90.0}) {
+            OrientedBoundBox obb;
+            const double ns = timePerCall(1, [&](int) {
+                obb = BoundBoxTools::solveAxisCone(hull, up, cone, 9, 6, 1e-9);
+            });
+            std::printf("%8.0f %12.4f %12.2f\n", cone, obb.volume(), ns*1e-6);
+        }
+        Axes axes;
+        Vector3 rotations;
+        BoundBox bb;
+        const double ns = timePerCall(1, [&](int) {
+            bb = BoundBox::solveMinimumRotatedBoundBox(axes, rotations, hull, 9, 6, 1e-9);
+        });
+        const Vector3 span(bb.maxPt() - bb.minPt());
+        std::printf("%8s %12.4f %12.2f\n", "free", span.x()*span.y()*span.z(), ns*1e-6);
+    }
+
+    // Candidate-enumeration small-hull solver against the default grid, both relative to
+    // branch-and-bound at a 1e-4 gap, on small ellipsoid hulls
+    void benchSmallHull() {
+        std::printf("smallhull: candidate-enumeration solver vs default grid (9 x 6)\n");
+        std::printf("%6s %10s %12s %12s %12s %12s\n", "verts", "candidates",
+            "small us", "grid us", "small err", "grid err");
+        std::mt19937 rng(1618);
+        const auto volume = [](const BoundBox& bb) {
+            const Vector3 span(bb.maxPt() - bb.minPt());
+            return span.x()*span.y()*span.z();
+        };
+        for (const int n : {6, 8, 10, 12, 16, 24, 32, 40}) {
+            const ConvexHullGraph graph(randomEllipsoidPoints(n, rng), 1e-9);
+            OrientedBoundBox small;
+            int nCandidates = 0;
+            const double smallNs = timePerCall(20, [&](int) {
+                small = BoundBoxTools::solveSmallHull(graph, &nCandidates);
+            });
+            Axes axes;
+            Vector3 rotations;
+            double grid = 0.0;
+            const double gridNs = timePerCall(20, [&](int) {
+                grid = volume(BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations, graph.points(), 9, 6, 1e-9
+                ));
+            });
+            double gap = 0.0;
+            int nEvals = 0;
+            const double reference = volume(BoundBoxTools::solveBranchAndBound(
+                axes, rotations, gap, nEvals, graph.points(), 1e-4, 1000000, 1e-9
+            ));
+            std::printf("%6d %10d %12.1f %12.1f %12.2e %12.2e\n", graph.size(), nCandidates,
+                smallNs*1e-3, gridNs*1e-3,
+                (small.volume() - reference)/reference, (grid - reference)/reference);
+        }
+    }
+
+    // Thread pool: one large hull's grid rows spread over the pool, and many small parts as one
+    // task each, against a single thread
+    void benchBatch() {
+        std::printf("batch: grid (9 x 6) on one 5000 vertex hull, rows spread over the pool\n");
+        std::printf("%8s %10s %12s %10s\n", "threads", "ms", "volume", "speedup");
+        std::mt19937 rng(4242);
+        const auto volume = [](const BoundBox& bb) {
+            const Vector3 span(bb.maxPt() - bb.minPt());
+            return span.x()*span.y()*span.z();
+        };
+        const int nHardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::vector<int> threadCounts{1, 2, 4};
+        if (nHardware > 4) {
+            threadCounts.push_back(nHardware);
+        }
+        const ConvexHullGraph big(randomEllipsoidPoints(5000, rng), 1e-9);
+        double serialMs = 0.0;
+        for (const int nThreads : threadCounts) {
+            ThreadPool pool(nThreads);
+            Axes axes;
+            Vector3 rotations;
+            double v = 0.0;
+            const double ms = timePerCall(1, [&](int) {
+                v = volume(BoundBox::solveMinimumRotatedBoundBox(
+                    axes, rotations, big.points(), 9, 6, 1e-9, 1, OrientedBoundBox(), false,
+                    &big, nullptr, 0, &pool
+                ));
+            })*1e-6;
+            serialMs = nThreads == 1 ? ms : serialMs;
+            std::printf("%8d %10.2f %12.6f %9.2fx\n", nThreads, ms, v, serialMs/ms);
+        }
+
+        std::printf("\nbatch: 64 parts of 200 hull vertices, one task per part\n");
+        std::printf("%8s %10s %10s\n", "threads", "ms", "speedup");
+        std::vector<ConvexHullGraph> parts;
+        for (int i = 0; i < 64; ++i) {
+            parts.emplace_back(randomEllipsoidPoints(200, rng), 1e-9);
+        }
+        for (const int nThreads : threadCounts) {
+            ThreadPool pool(nThreads);
+            std::vector<double> volumes(parts.size());
+            const double ms = timePerCall(1, [&](int) {
+                for (size_t i = 0; i < parts.size(); ++i) {
+                    pool.submit([&, i]() {
+                        Axes axes;
+                        Vector3 rotations;
+                        volumes[i] = volume(BoundBox::solveMinimumRotatedBoundBox(
+                            axes, rotations, parts[i].points(), 9, 6, 1e-9
+                        ));
+                    });
+                }
+                pool.waitIdle();
+            })*1e-6;
+            serialMs = nThreads == 1 ? ms : serialMs;
+            std::printf("%8d %10.2f %9.2fx\n", nThreads, ms, serialMs/ms);
+        }
+    }
+
+    // One csv of many parts with a part id column, read in one pass, against one stream per part,
+    // then the parts solved one task each
+    void benchMultiPart() {
+        std::printf("multipart: 1000 parts of 64 points, one csv with a part column vs a csv "
+            "each\n");
+        std::printf("%-22s %10s\n", "", "ms");
+        std::mt19937 rng(8080);
+        const int nParts = 1000;
+        std::string multi("Part,Face #,Point X,Point Y,Point Z,Normal X,Normal Y,Normal Z\n");
+        std::vector<std::string> singles(nParts);
+        char row[160];
+        for (int p = 0; p < nParts; ++p) {
+            singles[p] = "Face #,Point X,Point Y,Point Z,Normal X,Normal Y,Normal Z\n";
+            for (const Vector3& pt : randomEllipsoidPoints(64, rng)) {
+                std::snprintf(row, sizeof(row), "1,%.10g,%.10g,%.10g,0,0,1\n", pt.x(), pt.y(),
+                    pt.z());
+                multi += std::to_string(p) + "," + row;
+                singles[p] += row;
+            }
+        }
+        Surface3 surface;
+        const double multiMs = timePerCall(1, [&](int) {
+            std::istringstream is(multi);
+            surface = Surface3(is);
+        })*1e-6;
+        const double singlesMs = timePerCall(1, [&](int) {
+            for (const std::string& single : singles) {
+                std::istringstream is(single);
+                Surface3 part(is);
+                g_sink = g_sink + part.points().size();
+            }
+        })*1e-6;
+        std::printf("%-22s %10.2f\n", "read, part column", multiMs);
+        std::printf("%-22s %10.2f\n", "read, csv per part", singlesMs);
+
+        const int nHardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (const int nThreads : {1, nHardware}) {
+            ThreadPool pool(nThreads);
+            const double ms = timePerCall(1, [&](int) {
+                pool.parallelFor(0, static_cast<int>(surface.nParts()), 1, [&](int i) {
+                    const Surface3 part(surface.extractPart(i));
+                    const ConvexHullGraph graph(part.points(), 1e-9);
+                    Axes axes;
+                    Vector3 rotations;
+                    g_sink = g_sink + BoundBox::solveMinimumRotatedBoundBox(
+                        axes, rotations, graph.points(), 9, 6, 1e-9
+                    ).maxPt().x();
+                });
+            })*1e-6;
+            char label[32];
+            std::snprintf(label, sizeof(label), "solve, %d thread%s", nThreads,
+                nThreads == 1 ? "" : "s");
+            std::printf("%-22s %10.2f\n", label, ms);
+            if (nHardware == 1) {
+                break;
+            }
+        }
+    }
+
+    // Points held as packed x, y, z doubles, as a shared memory job holds them: the cost of taking
+    // them in as a csv, or as a copy into a field, against the hull read in place (Vector3View)
+    void benchInPlace() {
+        std::printf("inplace: points in a ball as packed doubles, csv read or copy vs hull\n");
+        std::printf("%8s %12s %10s %16s\n", "points", "csv read ms", "copy ms", "in place hull ms");
+        std::mt19937 rng(5050);
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        for (const int n : {10000, 100000, 1000000}) {
+            std::vector<double> xyz;
+            xyz.reserve(3*n);
+            while (static_cast<int>(xyz.size()) < 3*n) {
+                const double x = uniform(rng), y = uniform(rng), z = uniform(rng);
+                if (x*x + y*y + z*z <= 1.0) {
+                    xyz.insert(xyz.end(), {4.0*x, 2.0*y, z});
+                }
+            }
+            std::string csv("Face #,Point X,Point Y,Point Z,Normal X,Normal Y,Normal Z\n");
+            char row[160];
+            for (int i = 0; i < n; ++i) {
+                std::snprintf(row, sizeof(row), "1,%.17g,%.17g,%.17g,0,0,1\n", xyz[3*i],
+                    xyz[3*i + 1], xyz[3*i + 2]);
+                csv += row;
+            }
+            const int reps = n >= 1000000 ? 1 : 3;
+            const double csvMs = timePerCall(reps, [&](int) {
+                std::istringstream is(csv);
+                const Surface3 surface(is);
+                g_sink = g_sink + surface.points().size();
+            })*1e-6;
+            const double copyMs = timePerCall(reps, [&](int) {
+                Vector3Field pts;
+                pts.reserve(n);
+                for (int i = 0; i < n; ++i) {
+                    pts.push_back(Vector3(xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]));
+                }
+                g_sink = g_sink + pts.back().x();
+            })*1e-6;
+            Vector3Field chPts;
+            IndexField chVerts;
+            std::vector<Face> chFaces;
+            const double hullMs = timePerCall(reps, [&](int) {
+                ConvexHullTools::calculateConvexHull3d(
+                    Vector3View(xyz.data(), n), 1e-9, chPts, chVerts, chFaces
+                );
+                g_sink = g_sink + chPts.size();
+            })*1e-6;
+            std::printf("%8d %12.2f %10.2f %16.2f\n", n, csvMs, copyMs, hullMs);
+        }
+    }
+
+    struct BenchCase {
+        const char* name;
+        void (*run)();
+    };
+
+    const BenchCase benchCases[] = {
+        {"calipers", benchCalipers},
+        {"sweep", benchSweep},
+        {"support", benchSupport},
+        {"hierarchy", benchHierarchy},
+        {"radix", benchRadix},
+        {"merge2d", benchMerge2d},
+        {"float32", benchFloat32},
+        {"precision", benchPrecision},
+        {"lattice", benchLattice},
+        {"kernel", benchKernel},
+        {"ladder", benchLadder},
+        {"anytime", benchAnytime},
+        {"autotune", benchAutoTune},
+        {"fixedaxis", benchFixedAxis},
+        {"smallhull", benchSmallHull},
+        {"batch", benchBatch},
+        {"multipart", benchMultiPart},
+        {"inplace", benchInPlace}
+    };
+}
+
+
+int main(int argc, char** argv)
+{
+    // Rows appear as they finish, also when redirected
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    int nRun = 0;
+    for (const BenchCase& bc : benchCases) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected |= std::strcmp(argv[i], bc.name) == 0;
+        }
+        if (selected) {
+            bc.run();
+            std::printf("\n");
+            ++nRun;
+        }
+    }
+    if (nRun == 0) {
+        std::fprintf(stderr, "Unknown benchmark.  Available:");
+        for (const BenchCase& bc : benchCases) {
+            std::fprintf(stderr, " %s", bc.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+/* Shared memory job client for the solver service, and its round-trip latency benchmark.
+ *
+ *     shm_client <socket> [--points <n>] [--repeat <n>] [--frame] [--name </segment>]
+ *
+ * Puts n random points (default 10000) in a shared memory job segment (gaden/SharedJob.h), then
+ * asks the service on <socket> (sandbox --serve <socket>) to solve it repeat times (default 100),
+ * timing each round trip.  --frame sends the points over the socket in a points frame instead,
+ * for comparison.  Prints the last box and the latency mean and percentiles. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gaden/SharedJob.h"
+
+static int writeAll(int fd, const void* data, size_t n) {
+    const char* p = (const char*)data;
+    while (n > 0) {
+        const ssize_t put = write(fd, p, n);
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            return 0;
+        }
+        p += put;
+        n -= (size_t)put;
+    }
+    return 1;
+}
+
+static int readAll(int fd, void* data, size_t n) {
+    char* p = (char*)data;
+    while (n > 0) {
+        const ssize_t got = read(fd, p, n);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return 0;
+        }
+        p += got;
+        n -= (size_t)got;
+    }
+    return 1;
+}
+
+/* A frame is a 4 byte little-endian length, then that many bytes */
+static int writeFrame(int fd, const void* data, uint32_t n) {
+    const unsigned char prefix[4] = {
+        (unsigned char)(n & 0xff), (unsigned char)(n >> 8 & 0xff),
+        (unsigned char)(n >> 16 & 0xff), (unsigned char)(n >> 24 & 0xff)
+    };
+    return writeAll(fd, prefix, 4) && writeAll(fd, data, n);
+}
+
+/* Read a frame into *frame, grown as needed, zero terminated */
+static int readFrame(int fd, char** frame, size_t* capacity) {
+    unsigned char prefix[4];
+    if (!readAll(fd, prefix, 4)) {
+        return 0;
+    }
+    const uint32_t n =
+        prefix[0] | prefix[1] << 8 | prefix[2] << 16 | (uint32_t)prefix[3] << 24;
+    if (n + 1 > *capacity) {
+        char* grown = (char*)realloc(*frame, n + 1);
+        if (!grown) {
+            return 0;
+        }
+        *frame = grown;
+        *capacity = n + 1;
+    }
+    (*frame)[n] = '\0';
+    return readAll(fd, *frame, n);
+}
+
+static double nowMs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e3 + t.tv_nsec*1e-6;
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Uniform in a tilted 4 x 2 x 1 ellipsoid, so the box is not axis aligned */
+static void randomPoints(double* xyz, uint64_t n) {
+    const double c = cos(0.5);
+    const double s = sin(0.5);
+    srand(2024);
+    for (uint64_t i = 0; i < n; ++i) {
+        double x, y, z;
+        do {
+            x = 2.0*rand()/RAND_MAX - 1.0;
+            y = 2.0*rand()/RAND_MAX - 1.0;
+            z = 2.0*rand()/RAND_MAX - 1.0;
+        } while (x*x + y*y + z*z > 1.0);
+        x *= 4.0;
+        y *= 2.0;
+        xyz[3*i] = c*x - s*y;
+        xyz[3*i + 1] = s*x + c*y;
+        xyz[3*i + 2] = z;
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "Usage: shm_client <socket> [--points <n>] [--repeat <n>] [--frame] "
+        "[--name </segment>]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    const char* socketPath = argv[1];
+    uint64_t nPoints = 10000;
+    int nRepeat = 100;
+    int frameMode = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "/gaden-shm-%ld", (long)getpid());
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            nPoints = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            nRepeat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frame") == 0) {
+            frameMode = 1;
+        } else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            snprintf(name, sizeof(name), "%s", argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (nPoints == 0 || nRepeat < 1) {
+        usage();
+        return 1;
+    }
+
+    /* The job segment, header then points */
+    const size_t size = gadenShmSize(nPoints);
+    const int shmFd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (shmFd < 0 || ftruncate(shmFd, (off_t)size) != 0) {
+        fprintf(stderr, "Cannot create shared memory '%s': %s\n", name, strerror(errno));
+        if (shmFd >= 0) {
+            shm_unlink(name);
+        }
+        return 1;
+    }
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    close(shmFd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Cannot map shared memory '%s': %s\n", name, strerror(errno));
+        shm_unlink(name);
+        return 1;
+    }
+    GadenShmHeader* job = (GadenShmHeader*)data;
+    job->magic = GADEN_SHM_MAGIC;
+    job->version = GADEN_SHM_VERSION;
+    job->capacity = nPoints;
+    job->nPoints = nPoints;
+    job->sequence = 0;
+    randomPoints(gadenShmPoints(job), nPoints);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socketPath);
+    if (fd < 0 || connect(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "Cannot connect to '%s': %s\n", socketPath, strerror(errno));
+        munmap(data, size);
+        shm_unlink(name);
+        return 1;
+    }
+
+    double* latencyMs = (double*)malloc(nRepeat*sizeof(double));
+    char* response = NULL;
+    size_t responseCapacity = 0;
+    char request[128];
+    int failed = 0;
+    for (int k = 0; k < nRepeat && !failed; ++k) {
+        const double t0 = nowMs();
+        int sent;
+        if (frameMode) {
+            const int n = snprintf(request, sizeof(request), "{\"id\":%d,\"points\":%llu}", k,
+                (unsigned long long)nPoints);
+            sent = writeFrame(fd, request, (uint32_t)n)
+                && writeFrame(fd, gadenShmPoints(job), (uint32_t)(nPoints*3*sizeof(double)));
+        } else {
+            job->sequence = (uint64_t)k + 1;
+            job->result.status = GADEN_SHM_PENDING;
+            const int n = snprintf(request, sizeof(request), "{\"id\":%d,\"shm\":\"%s\"}", k,
+                name);
+            sent = writeFrame(fd, request, (uint32_t)n);
+        }
+        if (!sent || !readFrame(fd, &response, &responseCapacity)) {
+            fprintf(stderr, "Lost the service connection\n");
+            failed = 1;
+            break;
+        }
+        latencyMs[k] = nowMs() - t0;
+        if (frameMode) {
+            failed = strstr(response, "\"status\":\"ok\"") == NULL;
+        } else {
+            failed = job->result.sequence != job->sequence
+                || job->result.status != GADEN_SHM_SOLVED;
+        }
+        if (failed) {
+            fprintf(stderr, "Job failed: %s\n", response);
+        }
+    }
+
+    if (!failed) {
+        if (frameMode) {
+            printf("%s\n", response);
+        } else {
+            const GadenShmResult* r = &job->result;
+            printf("Volume   : %.10g\n", r->volume);
+            printf("Min      : (%.10g, %.10g, %.10g)\n", r->minPt[0], r->minPt[1], r->minPt[2]);
+            printf("Max      : (%.10g, %.10g, %.10g)\n", r->maxPt[0], r->maxPt[1], r->maxPt[2]);
+            for (int i = 0; i < 3; ++i) {
+                printf("Axis %c   : (%.10g, %.10g, %.10g)\n", "xyz"[i], r->axes[i][0],
+                    r->axes[i][1], r->axes[i][2]);
+            }
+            printf("Rotations: (%.10g, %.10g, %.10g)\n", r->rotations[0], r->rotations[1],
+                r->rotations[2]);
+            printf("Hull     : %llu points, solved in %.3f ms\n",
+                (unsigned long long)r->nHullPoints, r->ms);
+        }
+        double sum = 0.0;
+        for (int k = 0; k < nRepeat; ++k) {
+            sum += latencyMs[k];
+        }
+        qsort(latencyMs, nRepeat, sizeof(double), compareDoubles);
+        printf("%s, %llu points, %d round trips, ms: mean %.3f, min %.3f, p50 %.3f, p90 %.3f, "
+            "p99 %.3f, max %.3f\n", frameMode ? "points frame" : "shared memory",
+            (unsigned long long)nPoints, nRepeat, sum/nRepeat, latencyMs[0],
+            latencyMs[nRepeat/2], latencyMs[(int)(0.9*nRepeat)], latencyMs[(int)(0.99*nRepeat)],
+            latencyMs[nRepeat - 1]);
+    }
+
+    free(response);
+    free(latencyMs);
+    close(fd);
+    munmap(data, size);
+    shm_unlink(name);
+    return failed;
+}
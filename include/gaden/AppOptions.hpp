@@ -0,0 +1,205 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "gaden/Vector3.hpp"
+
+namespace gaden {
+
+// Options of the sandbox application, as read from its command line
+struct AppOptions {
+    double epsilon = 1.0e-9;
+    bool hasEpsilon = false;
+
+    int steps = 7;
+    bool hasSteps = false;
+
+    int passes = 1;
+    bool hasPasses = false;
+
+    // Grid solver beam width, number of candidate cells refined in each pass
+    int beam = 1;
+    bool hasBeam = false;
+
+    // present => true
+    bool mergePoints = false;
+
+    // present => true, grid walks each window in serpentine order, reusing sorted projections
+    bool coherent = false;
+
+    // Grid solver mixed precision, cells screened in float32, this many verified in double
+    // per pass, 0 is off
+    int float32 = 0;
+    bool hasFloat32 = false;
+
+    // present => true, read points in single precision, halving the memory of the raw cloud.
+    // Merging and the 3d hull still measure in double.  Ignored with --quantize, --ladder or a
+    // fixed --axis.
+    bool singlePoints = false;
+
+    // present => true, snap points to an integer lattice of spacing epsilon (coarsened to fit
+    // 30 bits), merging exactly and building the hull with exact predicates
+    bool quantize = false;
+
+    // Search on an epsilon-kernel of the hull, within (1 - kernel)^-3 of the hull's minimum
+    // volume, then re-measure the box on the full hull.  0 is off.
+    double kernel = 0.0;
+    bool hasKernel = false;
+
+    // Progressive solve: merge at a coarse tolerance (0 => 2% of the bound box diagonal),
+    // solve, tighten by 4x per rung down to epsilon, stop when the volume changes by less
+    // than ladderChange
+    bool ladder = false;
+    double ladderTolerance = 0.0;
+    double ladderChange = 1.0e-2;
+    bool hasLadderChange = false;
+
+    // present => true, warm start grid / bnb from PCA, hull face normals and surface normals
+    bool seed = false;
+
+    // Orientation search: grid | bnb | seeded | normals
+    std::string solver = "grid";
+    bool hasSolver = false;
+
+    // Branch-and-bound termination: relative optimality gap and evaluation limit
+    double gap = 1.0e-2;
+    bool hasGap = false;
+
+    int maxEvals = 20000;
+    bool hasMaxEvals = false;
+
+    // Latency budget for the whole run, the orientation search becomes the anytime solver and
+    // stops with the best box so far when it runs out.  0 is off.
+    int timeBudgetMs = 0;
+
+    // Auto-tuned grid steps and passes for this target relative volume error, within
+    // timeBudgetMs if given.  0 is off.
+    double autoAccuracy = 0.0;
+
+    // Constrained box, the third box axis is fixed to axis, or tilts up to coneDegrees from it
+    bool hasAxis = false;
+    Vector3 axis;
+    double coneDegrees = 0.0;
+
+    std::string filePath;
+
+    // Batch mode: solve every part listed in a manifest, or every .csv in a directory, one
+    // result line each to batchOutput (.csv or .jsonl, empty is csv to stdout)
+    std::string batchPath;
+    std::string batchOutput;
+
+    // Thread pool size, 0 is one per hardware thread.  Single file runs use a pool only when
+    // this is given.
+    int threads = 0;
+    bool hasThreads = false;
+
+    // Batch mode as a pipeline of ingest, merge / hull and solve stages on their own threads,
+    // with queues of this many items between them.  0 is off.
+    int pipelineDepth = 0;
+
+    // Resident service: answer solve requests over this Unix domain socket, or stdin / stdout
+    // for "-", until a shutdown request
+    std::string servePath;
+
+    friend std::ostream& operator<<(std::ostream& os, const AppOptions& ao) {
+        if (ao.hasEpsilon) {
+            os << "Found 'epsilon': " << ao.epsilon << "\n";
+        } else {
+            os << "No 'epsilon' option found, using default: " << ao.epsilon << "\n";
+        }
+        if (ao.hasSteps) {
+            os << "Found 'steps': " << ao.steps << "\n";
+        } else {
+            os << "No 'steps' option found, using default: " << ao.steps << "\n";
+        }
+        if (ao.hasPasses) {
+            os << "Found 'passes': " << ao.passes << "\n";
+        } else {
+            os << "No 'passes' option found, using default: " << ao.passes << "\n";
+        }
+        if (ao.hasBeam) {
+            os << "Found 'beam': " << ao.beam << "\n";
+        } else {
+            os << "No 'beam' option found, using default: " << ao.beam << "\n";
+        }
+        if (ao.hasFloat32) {
+            os << "Found 'float32': " << ao.float32 << "\n";
+        }
+        if (ao.hasKernel) {
+            os << "Found 'kernel': " << ao.kernel << "\n";
+        }
+        if (ao.ladder) {
+            os << "Found 'ladder': " << ao.ladderTolerance << "\n";
+            if (ao.hasLadderChange) {
+                os << "Found 'ladderChange': " << ao.ladderChange << "\n";
+            } else {
+                os << "No 'ladderChange' option found, using default: " << ao.ladderChange
+                    << "\n";
+            }
+        }
+        if (ao.hasAxis) {
+            os << "Found 'axis': " << ao.axis << "\n";
+            if (ao.coneDegrees > 0.0) {
+                os << "Found 'cone': " << ao.coneDegrees << "\n";
+            }
+        }
+        if (ao.mergePoints) {
+            os << "Found 'mergePoints': true\n";
+        }
+        if (ao.coherent) {
+            os << "Found 'coherent': true\n";
+        }
+        if (ao.quantize) {
+            os << "Found 'quantize': true\n";
+        }
+        if (ao.singlePoints) {
+            os << "Found 'singlePoints': true\n";
+        }
+        if (ao.seed) {
+            os << "Found 'seed': true\n";
+        }
+        if (ao.hasSolver) {
+            os << "Found 'solver': " << ao.solver << "\n";
+        } else {
+            os << "No 'solver' option found, using default: " << ao.solver << "\n";
+        }
+        if (ao.solver == "bnb") {
+            if (ao.hasGap) {
+                os << "Found 'gap': " << ao.gap << "\n";
+            } else {
+                os << "No 'gap' option found, using default: " << ao.gap << "\n";
+            }
+            if (ao.hasMaxEvals) {
+                os << "Found 'maxEvals': " << ao.maxEvals << "\n";
+            } else {
+                os << "No 'maxEvals' option found, using default: " << ao.maxEvals << "\n";
+            }
+        }
+        if (ao.autoAccuracy > 0.0) {
+            os << "Found 'auto': " << ao.autoAccuracy << "\n";
+        }
+        if (ao.timeBudgetMs > 0) {
+            os << "Found 'timeBudgetMs': " << ao.timeBudgetMs << "\n";
+        }
+        if (!ao.batchPath.empty()) {
+            os << "Found 'batch': " << ao.batchPath << "\n";
+            os << "Batch output = "
+                << (ao.batchOutput.empty() ? std::string("stdout") : ao.batchOutput) << "\n";
+        }
+        if (ao.hasThreads) {
+            os << "Found 'threads': " << ao.threads << "\n";
+        }
+        if (ao.pipelineDepth > 0) {
+            os << "Found 'pipeline': " << ao.pipelineDepth << "\n";
+        }
+        if (!ao.servePath.empty()) {
+            os << "Found 'serve': " << ao.servePath << "\n";
+        }
+        os << "File path = " << ao.filePath << "\n";
+        return os;
+    }
+
+};
+
+} // end namespace gaden
@@ -1,25 +1,29 @@
 #pragma once
 
-#include <vector>
-#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
 #include <utility>
+#include <vector>
 
 #include "gaden/VectorNField.hpp"
 #include "gaden/Field.hpp"
 
 namespace gaden {
 
-class AutoMergingPointCloud {
+// Point cloud that merges each appended point into any existing point within the merge tolerance.
+// Points are stored in Scalar precision, distances are measured in double precision.
+template <class Scalar>
+class AutoMergingPointCloudT {
 
     // Private data
 
-        static const IntField m_empty;
-
         // Indexed together
 
             // Underlying pointList
             // autoPtr<DynamicList<point>> pointsPtr_;
-            Vector3Field m_points;
+            VectorNField<Vector3T<Scalar>> m_points;
 
             // Associated squared distance
             ScalarField m_magSqrDist;
@@ -34,7 +38,9 @@ class AutoMergingPointCloud {
         //      * candidateIndices = msdBucketIndices_[bucketIndex]
 
         // HashTable<DynamicList<label>, label> msdBucketIndices_;
-        std::unordered_map<int, IntField> m_msdBucketIndices;
+        //  Ordered, so a merge search visits only the occupied buckets of its range: far from the
+        //  origin the range spans many more buckets than there are points
+        std::map<std::int64_t, IndexField> m_msdBucketIndices;
 
         // Merge tolerance
         const double m_mergeTol;
@@ -45,24 +51,15 @@ class AutoMergingPointCloud {
     // Private Member Functions
 
         //- Get bucket index for a given magSqrDist
-        inline int getBucketIndex(double magSqrDist) const
+        //  Floored and clamped, msd/tol passes 2^31 a few units from the origin at small tolerances
+        inline std::int64_t getBucketIndex(double magSqrDist) const
         {
-            return magSqrDist*m_invMergeTol;
+            const double maxBucket = 4.0e18;
+            const double bucket = std::floor(magSqrDist*m_invMergeTol);
+            return static_cast<std::int64_t>(std::max(-maxBucket, std::min(bucket, maxBucket)));
         }
 
-        //- Get list of candidate indices for a given bucketIndex
-        //  Returns empty list if not found
-        inline const IntField& getCandidateIndicies(int bucketIndex) const
-        {
-            const auto iter = m_msdBucketIndices.find(bucketIndex);
-            if (iter == m_msdBucketIndices.cend())
-            {
-                return m_empty;
-            }
-            return iter->second;
-        }
-
-        void addToBucketIndices(double msd, int pointIndex);
+        void addToBucketIndices(double msd, index_t pointIndex);
 
 
 public:
@@ -70,14 +67,14 @@ public:
     // Constructors
 
         //- Construct given input components
-        AutoMergingPointCloud(int estimatedSize, double mergeTol, std::string name="");
+        AutoMergingPointCloudT(index_t estimatedSize, double mergeTol, std::string name="");
 
         // //- Copy constructor
-        // AutoMergingPointCloud(const AutoMergingPointCloud&);
+        // AutoMergingPointCloudT(const AutoMergingPointCloudT&);
 
 
     //- Destructor
-    ~AutoMergingPointCloud() = default;
+    ~AutoMergingPointCloudT() = default;
 
 
     // Member Functions
@@ -86,19 +83,19 @@ public:
 
             //- Return underlying points
             //  Non-const access achieved through transfer()
-            inline const Vector3Field& points() const
+            inline const VectorNField<Vector3T<Scalar>>& points() const
             {
                 return m_points;
             }
 
             //- Return current number of points
-            inline int size() const
+            inline index_t size() const
             {
                 return m_points.size();
             }
 
             //- Return i^th element
-            inline const Vector3& operator[](const int i)
+            inline const Vector3T<Scalar>& operator[](const index_t i)
             {
                 return m_points.at(i);
             }
@@ -108,10 +105,10 @@ public:
 
             //- Append new point to list, merging as required
             //  Returns <new point, point index> after merging
-            std::pair<bool, int> append(const Vector3&);
+            std::pair<bool, index_t> append(const Vector3T<Scalar>&);
 
             // Hand over ownership of data, invalidates in-class data
-            Vector3Field transfer() && noexcept {
+            VectorNField<Vector3T<Scalar>> transfer() && noexcept {
                 // tidy up related caches
                 m_magSqrDist.clear();
                 m_scaledTolSqr.clear();
@@ -120,7 +117,10 @@ public:
             }
 
             // Safety - forbid transfer() on lvalues
-            Vector3Field transfer() & = delete;
+            VectorNField<Vector3T<Scalar>> transfer() & = delete;
 };
 
+typedef AutoMergingPointCloudT<double> AutoMergingPointCloud;
+typedef AutoMergingPointCloudT<float> AutoMergingPointCloudf;
+
 } // end namespace gaden
\ No newline at end of file
@@ -24,6 +24,11 @@ public:
         normalise();
     }
 
+    // Accessors
+    const Vector3& x() const { return m_x; }
+    const Vector3& y() const { return m_y; }
+    const Vector3& z() const { return m_z; }
+
     bool normalise() {
         // bitwise & operator to prevent short-circuiting
         return (
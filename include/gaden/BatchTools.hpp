@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gaden/AppOptions.hpp"
+#include "gaden/BatchWriter.hpp"
+#include "gaden/ThreadPool.hpp"
+
+namespace gaden {
+
+// Batch mode (--batch): solve every part file of a directory or manifest, on one thread pool or
+// as a pipeline of stages, streaming a result line per part
+class BatchTools {
+
+public:
+
+    // Part files of a batch: the .csv files of a directory, or the lines of a manifest, skipping
+    // blank lines and # comments, relative paths taken from the manifest's directory.  Sorted
+    // largest first, so the big parts start early and small ones fill in behind them.
+    static bool listParts(std::vector<std::string>& partsOut, const std::string& batchPath);
+
+    // Read and solve one file of a batch, writing a line per part.  Returns the number of parts
+    // that failed.
+    static int solveFile(
+        BatchWriter& writer,
+        const AppOptions& opt,
+        const std::string& filePath,
+        ThreadPool& pool
+    );
+
+    // Batch as three stages on their own threads: ingest reads whole files (the disk), merge /
+    // hull parses, merges and hulls them, solve runs the orientation search, streaming results to
+    // writer.  Bounded queues between the stages hold back a stage that runs ahead, so reading
+    // file k + 1 overlaps solving file k without buffering the whole batch.  Reports throughput
+    // per stage.  Returns the number of parts that failed.
+    static int solvePipelined(
+        BatchWriter& writer,
+        const AppOptions& opt,
+        const std::vector<std::string>& files
+    );
+
+    // Solve every file of opt.batchPath on one pool, streaming the results.  Returns the number of
+    // parts that failed, or -1 if the batch could not be started.
+    static int solveBatch(const AppOptions& opt);
+
+};
+
+} // end namespace gaden
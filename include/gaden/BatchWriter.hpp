@@ -0,0 +1,50 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include "gaden/AppOptions.hpp"
+#include "gaden/PartTools.hpp"
+
+namespace gaden {
+
+// Batch result writer, one line per part in the order they finish, as csv or json lines.  Safe to
+// call from the solving threads.
+class BatchWriter {
+
+    // Private data
+
+    std::ostream& m_os;
+    bool m_json;
+    std::mutex m_mutex;
+
+
+public:
+
+    // Construct writing to os, json lines or csv with a header line
+    BatchWriter(std::ostream& os, bool json);
+
+    // Write the result of a part of filePath
+    void write(const std::string& filePath, const PartResult& result);
+
+
+    // Static helpers
+
+    // Quote a csv field
+    static std::string csvField(const std::string& s);
+
+    // A part's result as a json object, without the file when filePath is empty
+    static std::string resultJson(const std::string& filePath, const PartResult& result);
+
+    // Output stream for result lines: opt.batchOutput opened in file, or stdout when it is
+    // empty.  Null if the file cannot be opened.
+    static std::ostream* openOutput(std::ofstream& file, const AppOptions& opt);
+
+    // JSON lines for a .jsonl output, csv otherwise
+    static bool outputIsJson(const AppOptions& opt);
+
+};
+
+} // end namespace gaden
@@ -7,6 +7,11 @@
 
 namespace gaden {
 
+class ConvexHullGraph;
+class ConvexHullHierarchy;
+struct OrientedBoundBox;
+class ThreadPool;
+
 class BoundBox {
     Vector3 m_min;
     Vector3 m_max;
@@ -124,13 +129,41 @@ public:
     static BoundBox calculateAxisAlignedBoundBox(const Vector3Field& ptsIn);
 
     // Return the minimum BoundBox resulting from an iterative search through steps x steps
-    // variations on rotations, passes times
+    // variations on rotations, passes times.  Each pass narrows the search window around the best
+    // cells; beamWidth > 1 carries that many distinct cells (beam search) into the next pass,
+    // each refined in its own window, to avoid locking onto the wrong one of several near-equal
+    // minima.
+    static BoundBox solveMinimumRotatedBoundBox(
+        // outputs
+        Axes& resultAxes, Vector3& resultRotations,
+
+        // inputs
+        const Vector3Field& pts, int steps, int passes, double epsilon, int beamWidth=1
+    );
+
+    // As above, starting from a known incumbent (e.g. BoundBoxTools::solveSeeded).  The seed is
+    // kept unless the grid beats it, and focuses the first narrowing when it lies in the grid
+    // domain, theta and phi in [0, pi/2].
+    // coherent walks each window in serpentine order, reusing the previous cell's sorted
+    // projection and calipers supports (see BoundBoxTools::SweepState).  Box extents
+    // come from hill-climbing on hullGraph, if given, instead of a scan over pts.  hullGraph must
+    // be the hull of pts (see ConvexHullGraph).  hullHierarchy, if given, is used instead of
+    // hullGraph; it needs no warm start, so it suits coarse grids and large hulls.
+    // float32Verify > 0 screens every cell in single precision
+    // (BoundBoxTools::evaluateOrientationFloat32) and re-evaluates only the float32Verify best
+    // cells of each pass in double precision, the result is always a double precision box.
+    // pool, if given, evaluates the theta rows of each window in parallel, with the same result.
     static BoundBox solveMinimumRotatedBoundBox(
         // outputs
         Axes& resultAxes, Vector3& resultRotations,
 
         // inputs
-        const Vector3Field& pts, int steps, int passes, double epsilon
+        const Vector3Field& pts, int steps, int passes, double epsilon, int beamWidth,
+        const OrientedBoundBox& seed, bool coherent=false,
+        const ConvexHullGraph* hullGraph=nullptr,
+        const ConvexHullHierarchy* hullHierarchy=nullptr,
+        int float32Verify=0,
+        ThreadPool* pool=nullptr
     );
 
     friend std::ostream& operator<<(std::ostream& os, const BoundBox& c) {
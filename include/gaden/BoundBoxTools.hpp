@@ -0,0 +1,393 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/ConvexHullHierarchy.hpp"
+#include "gaden/Face.hpp"
+#include "gaden/OrientedBoundBox.hpp"
+#include "gaden/VectorNField.hpp"
+
+namespace gaden {
+
+// A collection of algorithms that search orientation space for the minimum volume bound box
+class BoundBoxTools {
+
+public:
+
+    // Convert a look direction into (theta, phi), flipping it into the upper hemisphere first
+    // (w and -w give the same box).  theta is in [0, 2pi), phi in [0, pi/2].
+    static void directionToAngles(const Vector3& w, double& thetaOut, double& phiOut);
+
+    // True if (theta, phi) lies in the domain searched by solveMinimumRotatedBoundBox
+    static bool inGridDomain(double theta, double phi) {
+        return theta >= 0.0 && theta <= constants::piByTwo && phi >= 0.0 && phi <= constants::piByTwo;
+    }
+
+    // Evaluate a single look direction (theta, phi):
+    //  * project pts to the (u, v) plane and compute the 2d convex hull
+    //  * rotating calipers gives the optimal in-plane roll, psi
+    //  * extents along (u', v', w') give the bound box
+    // Returns an invalid OrientedBoundBox if the frame or projection is degenerate
+    static OrientedBoundBox evaluateOrientation(
+        const Vector3Field& pts,
+        double theta,
+        double phi,
+        double epsilon
+    );
+
+    // Carried between evaluations of neighbouring orientations in a sweep
+    struct SweepState {
+        // Reuse the sorted projection order and calipers supports from the last evaluation
+        bool m_coherent = true;
+
+        // Sorted order of the projected points from the last evaluation
+        IndexField m_order;
+
+        // Calipers support indices on the first edge of the last 2d hull
+        index_t m_supports[4] = {-1, -1, -1, -1};
+
+        // Optional hull graph of the points, the box extents are then found by hill-climbing from
+        // m_extremes rather than by a scan over all points.  Not owned.
+        const ConvexHullGraph* m_hullGraph = nullptr;
+
+        // Support vertex per extent slot from the last evaluation, see ConvexHullGraph::extents
+        index_t m_extremes[ConvexHullGraph::nExtentSlots] = {-1, -1, -1, -1, -1, -1};
+
+        // Optional hull hierarchy of the points, the box extents are then found by O(log n)
+        // descents, with no warm start needed.  Takes precedence over m_hullGraph.  Not owned.
+        const ConvexHullHierarchy* m_hullHierarchy = nullptr;
+    };
+
+    // As evaluateOrientation, using and updating the caches in state.  Same result, up to the
+    // hull tolerance when m_hullGraph is set, and cheaper when successive orientations are close,
+    // e.g. a serpentine walk over a grid.
+    static OrientedBoundBox evaluateOrientation(
+        const Vector3Field& pts,
+        double theta,
+        double phi,
+        double epsilon,
+        SweepState& state
+    );
+
+    // Single precision copy of a point cloud for screening orientations.  Points are centred on
+    // their bound box and scaled into [-1, 1], so float keeps ~7 significant digits of the shape,
+    // and stored as separate x, y, z arrays so that the projection loop vectorises at twice the
+    // lane width of double.
+    struct Float32Points {
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+
+        // Original point = m_centre + m_scale*(x, y, z)
+        Vector3 m_centre;
+        double m_scale = 1.0;
+    };
+
+    // Build the Float32Points of a point cloud
+    static Float32Points makeFloat32Points(const Vector3Field& pts);
+
+    // Screening evaluation of the look direction (theta, phi) in single precision: projection, 2d
+    // hull and calipers area, times the depth along w.  Only valid, volume, theta and phi are set,
+    // good for ranking orientations to ~1e-6 relative.  Re-evaluate the winners with
+    // evaluateOrientation for the box itself.
+    static OrientedBoundBox evaluateOrientationFloat32(
+        const Float32Points& fpts,
+        double theta,
+        double phi
+    );
+
+    // Bounding data for the branch-and-bound volume lower bound, precomputed once from the hull
+    struct VolumeBoundData {
+        // Centroid of the points, support function is measured from here
+        Vector3 m_centre;
+
+        // Largest distance from m_centre to any point
+        double m_radius = 0.0;
+
+        // Area-weighted outward normals of the hull faces (normal * area)
+        std::vector<Vector3> m_faceAreaNormals;
+
+        // Total hull surface area
+        double m_surfaceArea = 0.0;
+
+        // Hull volume - no box can be smaller
+        double m_hullVolume = 0.0;
+
+        // Shadow area of the hull looking along unit direction w: 0.5 * sum |n_f . w| A_f
+        double projectedArea(const Vector3& w) const;
+    };
+
+    // Compute VolumeBoundData from a 3d point cloud, rebuilding the hull faces internally.
+    // withHull false skips the rebuild: no faces or hull volume, only the support function bound,
+    // for when the rebuild would cost more than the time there is.
+    static VolumeBoundData calculateVolumeBoundData(
+        const Vector3Field& pts,
+        double epsilon,
+        bool withHull=true
+    );
+
+    // Lower bound on the volume of any box having one axis within angularRadius (radians) of the
+    // evaluated look direction in centre.  Uses:
+    //  * box depth along w >= extent(w), and extent is 2*radius Lipschitz in w
+    //  * rotating any such box onto the centre direction changes each width by at most
+    //    2*radius*chord, and the centre box is already optimal in psi, so its face area is at
+    //    least what the centre face area allows for widths no larger than the centre face
+    //    diagonal
+    //  * box face area >= hull shadow area, bounded face by face over the patch
+    //  * box volume >= hull volume
+    static double volumeLowerBound(
+        const VolumeBoundData& bounds,
+        const OrientedBoundBox& centre,
+        double angularRadius
+    );
+
+    // When an anytime solver must stop, checked between orientation evaluations
+    struct StopCondition {
+        // Stop once this time has passed, never by default
+        std::chrono::steady_clock::time_point m_deadline =
+            std::chrono::steady_clock::time_point::max();
+
+        // Stop once this is set, e.g. by another thread or a signal handler.  Not owned.
+        const std::atomic<bool>* m_cancel = nullptr;
+
+        // True if either condition is met
+        bool reached() const {
+            return
+                (m_cancel && m_cancel->load(std::memory_order_relaxed))
+             || std::chrono::steady_clock::now() >= m_deadline;
+        }
+    };
+
+    // Branch-and-bound search over orientation space.  Every box has an axis (up to sign) with
+    // declination phi >= asin(1/sqrt(3)), so the search domain is that polar cap,
+    // theta = [0, 2pi).  The domain is split into (theta, phi) patches, each patch is evaluated
+    // at its centre and assigned a volume lower bound; patches that cannot beat the incumbent are
+    // pruned, the remaining patch with the lowest bound is split next.
+    //  Inputs
+    //      * pts - the point cloud, ideally the 3d convex hull points
+    //      * relativeGap - stop once (incumbent - lowerBound)/incumbent <= relativeGap
+    //      * maxEvaluations - hard limit on the number of orientations evaluated
+    //      * epsilon - projection merge / hull tolerance
+    //      * seed - optional incumbent (e.g. from solveSeeded), prunes patches from the start
+    //      * hullGraph - optional hull graph of pts, box extents by hill-climbing instead of a scan
+    //      * hullHierarchy - optional hull hierarchy of pts, used in place of hullGraph
+    //      * stop - optional, ends the search early once there is a valid box; the gap is then
+    //        1 if the initial 16 patches were not all evaluated.  The hull is not rebuilt for the
+    //        volume bound (see calculateVolumeBoundData), so evaluations start at once.
+    //  Outputs
+    //      * resultAxes, resultRotations - as solveMinimumRotatedBoundBox
+    //      * optimalityGapOut - certified relative gap between result and the global optimum
+    //      * nEvaluationsOut - number of orientations evaluated
+    static BoundBox solveBranchAndBound(
+        // outputs
+        Axes& resultAxes, Vector3& resultRotations,
+        double& optimalityGapOut, int& nEvaluationsOut,
+
+        // inputs
+        const Vector3Field& pts, double relativeGap, int maxEvaluations, double epsilon,
+        const OrientedBoundBox& seed=OrientedBoundBox(),
+        const ConvexHullGraph* hullGraph=nullptr,
+        const ConvexHullHierarchy* hullHierarchy=nullptr,
+        const StopCondition* stop=nullptr
+    );
+
+    // Anytime search, runs until stop is reached and returns the best box so far.  The principal
+    // axes of the points come first (unless a valid seed is given), a few evaluations with no
+    // hull rebuild, so even a short budget is met with a box.  Then branch-and-bound
+    // refines coarse-to-fine, best patch first, with no evaluation limit, so an early stop already
+    // has a good box.  optimalityGapOut is the certified gap at the time of stopping, 1 if none
+    // could be certified, at most 1e-9 once the search completes.  Other arguments are as
+    // solveBranchAndBound.
+    static BoundBox solveAnytime(
+        // outputs
+        Axes& resultAxes, Vector3& resultRotations,
+        double& optimalityGapOut, int& nEvaluationsOut,
+
+        // inputs
+        const Vector3Field& pts, const StopCondition& stop, double epsilon,
+        const OrientedBoundBox& seed=OrientedBoundBox(),
+        const ConvexHullGraph* hullGraph=nullptr,
+        const ConvexHullHierarchy* hullHierarchy=nullptr
+    );
+
+    // Schedule chosen by solveAutoTuned, and its accuracy
+    struct AutoTuneReport {
+        // Measured cost of one orientation evaluation on the given points
+        double m_evaluationMs = 0.0;
+
+        // Grid steps of each pass, in order: the coarse pass, then the passes of each basin
+        std::vector<int> m_steps;
+
+        // Basins refined
+        int m_nBasins = 0;
+
+        // Orientations evaluated, including the cost probes and the certification
+        int m_nEvaluations = 0;
+
+        // Model relative volume error after the last pass of the basin holding the result: as
+        // predicted before the pass ran, and as estimated from the improvement it made.  -1 when
+        // there was too little history.  Neither is a bound.
+        double m_predictedError = -1.0;
+        double m_estimatedError = -1.0;
+
+        // Certified relative gap between the result and the global optimum, branch-and-bound's,
+        // 1 if the budget ran out before it covered the domain
+        double m_achievedError = 1.0;
+    };
+
+    // Grid search with a schedule chosen at runtime, certified by branch-and-bound:
+    //  * a coarse pass (12 x 12 unless the budget is short) over the whole (theta, phi) domain
+    //  * the best few local minima of the coarse pass are refined separately, each by s x s
+    //    serpentine sweeps of a window narrowed around its best box, as
+    //    BoundBox::solveMinimumRotatedBoundBox.  The relative volume error after a pass is
+    //    modelled as C*h^2, h the pass's cell size (the volume is smooth at its minimum); C is
+    //    fitted to the improvement between passes, and s for the next pass is the smallest that
+    //    reaches targetAccuracy.  A basin is done once the model says targetAccuracy is met.
+    //  * solveBranchAndBound, seeded with the best box, to a gap of targetAccuracy.  Its gap is
+    //    the error reported, the model only sizes the passes.
+    // Passes end when the next would not fit in timeBudgetMs (<= 0 for none), at the measured
+    // cost per evaluation.  Certification stops at the budget, or after 20000 evaluations when
+    // there is none, and reports the gap it reached.  seed, hullGraph and hullHierarchy are as
+    // solveBranchAndBound.
+    static BoundBox solveAutoTuned(
+        // outputs
+        Axes& resultAxes, Vector3& resultRotations, AutoTuneReport& reportOut,
+
+        // inputs
+        const Vector3Field& pts, double targetAccuracy, double timeBudgetMs, double epsilon,
+        const OrientedBoundBox& seed=OrientedBoundBox(),
+        const ConvexHullGraph* hullGraph=nullptr,
+        const ConvexHullHierarchy* hullHierarchy=nullptr
+    );
+
+    // Candidate look directions that are cheap to guess, a minimum-volume box is often flush with
+    // a hull face:
+    //  * the principal axes of the hull-surface covariance
+    //  * the maxFaceNormals dominant hull face normals, near-parallel faces (within 1 degree) are
+    //    grouped and ranked by total area
+    static std::vector<Vector3> calculateSeedDirections(
+        const Vector3Field& pts,
+        double epsilon,
+        int maxFaceNormals
+    );
+
+    // Evaluate each direction as a look direction and return the best box.  The best box is then
+    // re-evaluated looking along each of its other axes, preferring a representation that lies in
+    // the grid search domain so that it can also focus the grid.
+    static OrientedBoundBox evaluateDirections(
+        const Vector3Field& pts,
+        const std::vector<Vector3>& directions,
+        double epsilon
+    );
+
+    // Warm start: evaluate calculateSeedDirections and return the best as the incumbent for the
+    // grid or branch-and-bound solvers, or as a fast final answer
+    static OrientedBoundBox solveSeeded(
+        const Vector3Field& pts,
+        double epsilon,
+        int maxFaceNormals=8
+    );
+
+    // Evaluate the box with w as its third axis and u as its first, u need not be exactly
+    // orthogonal to w.  No projection or calipers, only the O(n) extents.  Rotations are reported
+    // in the same (theta, phi, psi) convention as evaluateOrientation.
+    static OrientedBoundBox evaluateFrame(
+        const Vector3Field& pts,
+        const Vector3& w,
+        const Vector3& u
+    );
+
+    // Cluster surface normals (e.g. the per-face normals from a Surface3) into dominant directions.
+    // n and -n are the same box axis, so normals are folded onto the upper hemisphere and binned
+    // in roughly equal-area cells of binDegrees.  Bins are then merged greedily, most populated
+    // first, into clusters within 2*binDegrees of each other.
+    //  Returns up to maxClusters (direction, count) pairs, sorted by decreasing count
+    static std::vector<std::pair<Vector3, double>> clusterNormals(
+        const Vector3Field& normals,
+        int maxClusters,
+        double binDegrees=1.0
+    );
+
+    // Fast initial solution from the surface normals, for machined / CAD-exported parts whose
+    // optimal box is usually aligned with the dominant normal directions:
+    //  * cluster the normals, keep the top maxClusters directions
+    //  * evaluate every pair of clusters within orthogonalDegrees of orthogonal as a frame directly
+    //  * evaluate unpaired clusters as look directions, letting the calipers choose the roll
+    //  * re-evaluate the best box along each of its axes, as evaluateDirections
+    static OrientedBoundBox solveFromNormals(
+        const Vector3Field& pts,
+        const Vector3Field& normals,
+        double epsilon,
+        int maxClusters=6,
+        double orthogonalDegrees=2.0
+    );
+
+    // Coarse-to-fine solve for very large inputs, a quick box without a hull of every point.
+    // Each rung merges pts at a tolerance (PointCloudTools::mergePointsSubset), builds the hull of
+    // what is left and runs the grid search on it, seeded with the previous rung's orientation;
+    // the tolerance is then divided by ratio.  Stops once the volume changes by less than
+    // relativeChange from one rung to the next, or after the rung at fineTolerance.
+    //  Inputs
+    //      * coarseTolerance - first merge tolerance, <= 0 takes 2% of the bound box diagonal
+    //      * steps, passes, epsilon - as solveMinimumRotatedBoundBox, for every rung
+    //  Outputs
+    //      * resultAxes, resultRotations - as solveMinimumRotatedBoundBox
+    //      * nRungsOut - number of tolerances solved
+    // The box is measured over every point of pts at the end, so it contains them all.
+    static BoundBox solveEpsilonLadder(
+        // outputs
+        Axes& resultAxes, Vector3& resultRotations, int& nRungsOut,
+
+        // inputs
+        const Vector3Field& pts, double coarseTolerance, double fineTolerance,
+        double relativeChange, int steps, int passes, double epsilon, double ratio=4.0
+    );
+
+    // Largest hull solved by solveSmallHull
+    static const int smallHullMaxVerts = 40;
+
+    // Largest hull solveSmallHull is picked for in place of the default grid.  Measured (bench
+    // smallhull): several times faster than the grid up to 12 vertices, level with it (within 5%)
+    // from 16 to 40, and exact where the grid is not.
+    static const int smallHullAutoMaxVerts = 40;
+
+    // Candidate-enumeration solve (SmallHullSolver) for hulls of at most smallHullMaxVerts
+    // vertices, exact to a relative 1e-10 in volume, with the smallest
+    // SmallHullSolver capacity (8, 16, 24 or 40) that fits.  Returns an invalid box for larger
+    // or empty hulls.  nCandidatesOut, if given, receives the number of box volumes evaluated.
+    static OrientedBoundBox solveSmallHull(
+        const ConvexHullGraph& hullGraph,
+        int* nCandidatesOut=nullptr
+    );
+
+    // Constrained box with axis as its third axis (e.g. gravity or the CAD z axis), the minimum
+    // over the roll about it.  A single evaluateOrientation, projection along axis, 2d hull and
+    // calipers, so the result is exact and O(n log n); no 3d hull is needed.
+    static OrientedBoundBox solveFixedAxis(
+        const Vector3Field& pts,
+        const Vector3& axis,
+        double epsilon
+    );
+
+    // As solveFixedAxis, with the third axis free to tilt up to coneDegrees from axis.  Searches a
+    // polar grid of (tilt, azimuth) about axis, steps x steps cells, narrowing around the best
+    // cell for each of passes passes, as solveMinimumRotatedBoundBox.  axis itself is always a
+    // candidate, so the box is never worse than solveFixedAxis.
+    static OrientedBoundBox solveAxisCone(
+        const Vector3Field& pts,
+        const Vector3& axis,
+        double coneDegrees,
+        int steps,
+        int passes,
+        double epsilon
+    );
+
+};
+
+} // end namespace gaden
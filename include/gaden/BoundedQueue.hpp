@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace gaden {
+
+// Blocking FIFO queue of at most capacity items, handing work from one pipeline stage to the
+// next.  push waits while the queue is full, so a fast producer is held back to the pace of its
+// consumers, and pop waits while it is empty.  Once closed, push fails and pop drains what is
+// left, then fails.
+template <class Type>
+class BoundedQueue {
+
+    // Private data
+
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<Type> m_items;
+    size_t m_capacity;
+    bool m_closed;
+
+
+public:
+
+    // Construct empty, holding at most capacity items (at least 1)
+    explicit BoundedQueue(size_t capacity) :
+        m_capacity(capacity < 1 ? 1 : capacity),
+        m_closed(false)
+    {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+
+    // Accessors
+
+    size_t capacity() const { return m_capacity; }
+
+
+    // Functionality
+
+    // Append item, waiting for room.  False if the queue is closed, item is then dropped.
+    bool push(Type item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Take the oldest item, waiting for one.  False once the queue is closed and empty.
+    bool pop(Type& itemOut) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) {
+            return false;
+        }
+        itemOut = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    // No more items will be pushed, wakes every waiting thread
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+};
+
+} // end namespace gaden
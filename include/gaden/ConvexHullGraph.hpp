@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/Face.hpp"
+#include "gaden/VectorNField.hpp"
+
+namespace gaden {
+
+// Vertex adjacency graph of a 3d convex hull, for extreme vertex (support) queries.  On a convex
+// polyhedron the support function has no local maxima other than the global one, so the extreme
+// vertex in direction d is found by hill-climbing along edges from any start vertex.  Starting
+// from the previous answer for a nearby direction, this takes a handful of steps instead of a
+// scan over every point.
+//
+// The graph is immutable once built, callers keep their own per-slot cache of start vertices, so
+// one graph can serve several concurrent sweeps.
+class ConvexHullGraph {
+
+    // Private data
+
+    // Hull vertex positions
+    Vector3Field m_points;
+
+    // Compressed adjacency, the neighbours of vertex i are
+    //  m_neighbours[m_offsets[i]] .. m_neighbours[m_offsets[i + 1] - 1]
+    IndexField m_offsets;
+    IndexField m_neighbours;
+
+
+public:
+
+    // Number of support slots used by extents, (max, min) for each of the three axes
+    static const int nExtentSlots = 6;
+
+    // Construct null
+    ConvexHullGraph() {}
+
+    // Construct from the output of ConvexHullTools::calculateConvexHull3d
+    //  * chPts - hull points
+    //  * chVertices - chPts[k] == ptsIn[chVertices[k]], sorted
+    //  * chFaces - quickhull faces, indexing ptsIn, removed faces are skipped
+    ConvexHullGraph(
+        const Vector3Field& chPts,
+        const IndexField& chVertices,
+        const std::vector<Face>& chFaces
+    );
+
+    // Construct from a point cloud, calculating its 3d convex hull first
+    ConvexHullGraph(const Vector3Field& pts, double epsilon);
+
+
+    // Accessors
+
+    const Vector3Field& points() const { return m_points; }
+    index_t size() const { return static_cast<index_t>(m_points.size()); }
+
+    // True if no 3d hull was formed, queries are not available
+    bool empty() const { return m_points.empty(); }
+
+    // Number of neighbours of vertex i
+    index_t degree(index_t i) const { return m_offsets[i + 1] - m_offsets[i]; }
+
+    // Neighbours of vertex i, as [begin, end) pointers
+    const index_t* neighboursBegin(index_t i) const { return m_neighbours.data() + m_offsets[i]; }
+    const index_t* neighboursEnd(index_t i) const { return m_neighbours.data() + m_offsets[i + 1]; }
+
+
+    // Queries
+
+    // Index of the vertex furthest along d, hill-climbing from vertex start (clamped into range).
+    // nStepsOut, if given, receives the number of vertices moved.
+    index_t support(const Vector3& d, index_t start, int* nStepsOut=nullptr) const;
+
+    // Extents of the hull along each axis, as a BoundBox in the (x, y, z) axes frame.
+    // supportsInOut caches the support vertex per slot, (max x, min x, max y, min y, max z, min z);
+    // pass -1s on first use, it is updated for the next, nearby, query.
+    BoundBox extents(const Axes& axes, index_t supportsInOut[nExtentSlots]) const;
+
+    // Directional epsilon-kernel, the vertices extreme along a fixed set of directions.  In every
+    // direction the kernel's width is at least (1 - epsilonOut) times the hull's, so in any
+    // orientation its box has at least (1 - epsilonOut)^3 of the volume of the hull's box, and the
+    // minimum box searched on the kernel, re-measured on the hull, is within (1 - epsilonOut)^-3
+    // of the minimum box of the hull.  epsilonOut is at most epsilon unless maxDirections caps
+    // the number of directions first.  Returns vertex indices, ascending.
+    IndexField epsilonKernel(double epsilon, double& epsilonOut, int maxDirections=100000) const;
+
+};
+
+} // end namespace gaden
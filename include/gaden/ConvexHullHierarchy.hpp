@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/VectorNField.hpp"
+
+namespace gaden {
+
+// Dobkin-Kirkpatrick style hierarchy over a 3d convex hull, for extreme vertex (support) queries
+// in O(log n) without a warm start.
+//
+// Level 0 is the hull graph.  Each next level removes an independent set of low-degree vertices
+// and reconnects each hole: the new facets of the hull without vertex v only use v's neighbours,
+// so they are found among the triangles of those few neighbours.  Levels shrink geometrically
+// until a small top level remains.
+//
+// A query scans the top level, then descends: the extreme vertex of level i is a vertex of level
+// i - 1, and the extreme vertex there is reached by hill-climbing a step or two from it.
+//
+// Adjacency at higher levels may hold extra edges (e.g. both diagonals of a planar quad), these
+// do not affect the queries.
+class ConvexHullHierarchy {
+
+    // A level of the hierarchy, vertices are a subset of the level below
+    struct Level {
+        // Index of each vertex in m_points
+        IndexField m_vertices;
+
+        // Compressed adjacency in local (this level) indices, see ConvexHullGraph
+        IndexField m_offsets;
+        IndexField m_neighbours;
+
+        // Local index of each vertex in the level below, empty for level 0
+        IndexField m_below;
+    };
+
+    // Private data
+
+    // Hull vertex positions, level 0 order
+    Vector3Field m_points;
+
+    // Level 0 (full hull) first
+    std::vector<Level> m_levels;
+
+
+public:
+
+    // Construct null
+    ConvexHullHierarchy() {}
+
+    // Build from a hull graph
+    //  * maxDegree - only vertices with at most this many neighbours are removed
+    //  * topSize - stop once a level has at most this many vertices
+    explicit ConvexHullHierarchy(const ConvexHullGraph& graph, int maxDegree=8, int topSize=16);
+
+
+    // Accessors
+
+    const Vector3Field& points() const { return m_points; }
+    bool empty() const { return m_points.empty(); }
+    int nLevels() const { return static_cast<int>(m_levels.size()); }
+    index_t levelSize(int i) const { return static_cast<index_t>(m_levels[i].m_vertices.size()); }
+
+
+    // Queries
+
+    // Index (into points()) of the vertex furthest along d.  nVisitedOut, if given, receives the
+    // number of vertices evaluated.
+    index_t support(const Vector3& d, int* nVisitedOut=nullptr) const;
+
+    // Extents of the hull along each axis, as a BoundBox in the (x, y, z) axes frame
+    BoundBox extents(const Axes& axes) const;
+
+};
+
+} // end namespace gaden
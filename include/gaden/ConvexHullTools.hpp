@@ -3,6 +3,7 @@
 #include "gaden/Edge.hpp"
 #include "gaden/Face.hpp"
 #include "gaden/MinRect.hpp"
+#include "gaden/Vector3View.hpp"
 #include "gaden/VectorNField.hpp"
 
 namespace gaden {
@@ -13,6 +14,8 @@ class ConvexHullTools {
 public:
 
     // Calculates which vertices belong in the convex hull, fills m_convexHullIndices
+    // chFacesOut receives the quickhull faces (indices into ptsIn), check Face::alive() - removed
+    // faces are retained in the list.
     // Returns number of valid topological dimensions carved out by the hull, -1 for insufficient
     // points
     static int calculateConvexHull3d(
@@ -22,8 +25,47 @@ public:
 
         // Outputs
         Vector3Field& ptsOut,
-        IntField& chVerticesOut,
-        std::vector<Face> chFacesOut
+        IndexField& chVerticesOut,
+        std::vector<Face>& chFacesOut
+    );
+
+    // As above, for single precision input points.  The hull is calculated in double precision,
+    // ptsOut is widened to double.
+    static int calculateConvexHull3d(
+        // Inputs
+        const Vector3fField& ptsIn,
+        double toleranceIn,
+
+        // Outputs
+        Vector3Field& ptsOut,
+        IndexField& chVerticesOut,
+        std::vector<Face>& chFacesOut
+    );
+
+    // As above, reading points in place from memory held elsewhere (see Vector3View).  ptsOut
+    // receives copies of the hull points only.
+    static int calculateConvexHull3d(
+        // Inputs
+        const Vector3View& ptsIn,
+        double toleranceIn,
+
+        // Outputs
+        Vector3Field& ptsOut,
+        IndexField& chVerticesOut,
+        std::vector<Face>& chFacesOut
+    );
+
+    // As above, for lattice coordinates (see Lattice).  Every orientation test is exact, so no
+    // tolerance is needed and points on a face plane are never hull vertices.  ptsOut and the face
+    // planes are in lattice units, Lattice::toWorld converts the points.
+    static int calculateConvexHull3d(
+        // Inputs
+        const Vector3iField& ptsIn,
+
+        // Outputs
+        Vector3Field& ptsOut,
+        IndexField& chVerticesOut,
+        std::vector<Face>& chFacesOut
     );
 
     // Create a 2D convex hull for the supplied ptsIn.  Outputs:
@@ -40,7 +82,7 @@ public:
 
         // Outputs
         IndexedVector2Field& ptsOut,
-        IntField& verticesOut
+        IndexField& verticesOut
     );
 
     // Converts the nDimensions returned by convex hull calculation functions into a user-facing
@@ -74,6 +116,19 @@ public:
     //  * parentEdge (int) - associated outer edge that resulted in the minimum rectangle
     static MinRect rotatingCalipers(const IndexedVector2Field& ptsIn);
 
+    // As rotatingCalipers, with identical results up to round-off, but cheaper per edge:
+    //  * widths are measured along the unnormalised edge vector e and its normal, and areas are
+    //    compared as width*height/|e|^2, so no sqrt per edge
+    //  * sqrt and atan2 are deferred to the single winning edge
+    //  * support pointers wrap around without a modulo or a branch
+    static MinRect rotatingCalipersFast(const IndexedVector2Field& ptsIn);
+
+    // As rotatingCalipersFast, with the initial support indices (uMax, uMin, vMax, vMin) for the
+    // first hull edge taken from supportsInOut and hill-climbed from there, instead of scanning
+    // the hull.  Pass -1s for no hint.  Used for sweeps where each hull is close to the last, the
+    // supports found are written back for the next call.
+    static MinRect rotatingCalipersFast(const IndexedVector2Field& ptsIn, index_t supportsInOut[4]);
+
 };
 
 } // end namespace gaden
\ No newline at end of file
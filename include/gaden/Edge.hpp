@@ -1,22 +1,25 @@
 #pragma once
 
+#include <type_traits>
+
+#include "gaden/Index.hpp"
 #include "gaden/Vector3.hpp"
 
 namespace gaden {
 
 class Edge {
     // directed edge u->v on horizon (kept CCW around the perspective point)
-    int m_u;
-    int m_v;
+    index_t m_u;
+    index_t m_v;
 
 public:
-    Edge(int u, int v):
+    Edge(index_t u, index_t v):
         m_u(u),
         m_v(v)
     {}
 
-    int u() const { return m_u; }
-    int v() const { return m_v; }
+    index_t u() const { return m_u; }
+    index_t v() const { return m_v; }
 
     bool operator==(const Edge& o) const { return m_u==o.m_u && m_v==o.m_v; }
 };
@@ -24,7 +27,8 @@ public:
 // Functor for hashing
 struct EdgeHash {
     std::size_t operator()(const Edge& e) const noexcept {
-        return (e.u() * 1315423911u) ^ (e.v() + 0x9e3779b97f4a7c15ull);
+        return (static_cast<std::make_unsigned_t<index_t>>(e.u())*1315423911u)
+            ^ (e.v() + 0x9e3779b97f4a7c15ull);
     }
 };
 
@@ -9,9 +9,9 @@ namespace gaden {
 
 class Face {
     // Point indices, CCW from exterior
-    int m_ptA;
-    int m_ptB;
-    int m_ptC;
+    index_t m_ptA;
+    index_t m_ptB;
+    index_t m_ptC;
 
     // Normal
     Vector3 m_normal;
@@ -22,7 +22,7 @@ class Face {
     // Non encapsulated metadata for Convex Hull
 
     // Point indices strictly outside (n·p + d > eps)
-    std::vector<int> m_outside;
+    std::vector<index_t> m_outside;
 
     // Status
     bool m_alive;
@@ -30,16 +30,19 @@ class Face {
 public:
     Face() {};
 
-    // Construct from components and reference to point list
-    Face(int a, int b, int c, const Vector3Field& pts, double eps):
+    // Construct from components and reference to point list, a field of any Vector3T (e.g.
+    // Vector3fField, or Vector3iField lattice coordinates).  The plane is always in double
+    // precision.
+    template <class PointField>
+    Face(index_t a, index_t b, index_t c, const PointField& pts, double eps):
         m_ptA(a),
         m_ptB(b),
         m_ptC(c),
         m_alive(true)
     {
-        const Vector3& pA = pts[a];
-        const Vector3& pB = pts[b];
-        const Vector3& pC = pts[c];
+        const Vector3 pA(pts[a]);
+        const Vector3 pB(pts[b]);
+        const Vector3 pC(pts[c]);
 
         // n = (B - A) x (C - A)
         m_normal = (pB - pA).crossProduct(pC - pA);
@@ -65,16 +68,16 @@ public:
     }
 
     // Accessors
-    int a() const { return m_ptA; }
-    int b() const { return m_ptB; }
-    int c() const { return m_ptC; }
+    index_t a() const { return m_ptA; }
+    index_t b() const { return m_ptB; }
+    index_t c() const { return m_ptC; }
 
     const Vector3& normal() const { return m_normal; }
 
     double offset() const { return m_offset; }
 
-    const std::vector<int>& outside() const { return m_outside; }
-    std::vector<int>& outside() { return m_outside; }
+    const std::vector<index_t>& outside() const { return m_outside; }
+    std::vector<index_t>& outside() { return m_outside; }
 
     bool alive() const { return m_alive; }
     bool& alive() { return m_alive; }
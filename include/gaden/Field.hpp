@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "gaden/Index.hpp"
 #include "gaden/Logger.hpp"
 #include "gaden/ObjectBase.hpp"
 #include "gaden/Vector3.hpp"
@@ -13,6 +14,7 @@ namespace gaden {
 
 template <class Type> class Field;
 typedef Field<int> IntField;
+typedef Field<index_t> IndexField;
 typedef Field<double> ScalarField;
 // Vector3Field is not derived from this template
 
@@ -28,13 +30,13 @@ public:
     {}
 
     // Construct given size
-    Field(int size, std::string name=""):
+    Field(index_t size, std::string name=""):
         ObjectBase(name == "" ? "Field" : name),
         m_vec(size)
     {}
 
     // Construct given size and initial element
-    Field(int size, Type elem, std::string name=""):
+    Field(index_t size, Type elem, std::string name=""):
         ObjectBase(name == "" ? "Field" : name),
         m_vec(size, elem)
     {}
@@ -186,7 +188,7 @@ public:
         Field::iterator iter = result.begin();
         Field::const_iterator citer = cbegin();
         for (;iter != result.end(); ++iter, ++citer) {
-            (*iter) = abs(*citer);
+            (*iter) = std::abs(*citer);
         }
         return result;
     }
@@ -371,7 +373,7 @@ public:
     }
 
     // Write out ith element
-    void writeElem(std::ostream& os, int i) const {
+    void writeElem(std::ostream& os, index_t i) const {
         os << m_vec.at(i);
     }
 
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gaden {
+
+// Frames of one service connection: a 4 byte little-endian length, then that many bytes.  Over a
+// socket, or stdin / stdout when fd is -1.
+class FrameChannel {
+
+    // Private data
+
+    int m_fd;
+
+
+    // Private member functions
+
+    // Read or write exactly n bytes, false if the stream ends or fails first
+    bool readBytes(char* data, std::size_t n);
+    bool writeBytes(const char* data, std::size_t n);
+
+    // Read and drop n bytes
+    bool skipBytes(std::size_t n);
+
+
+public:
+
+    // Longest frame read, some 11 million points.  Larger jobs go through a file or shared memory.
+    static constexpr std::uint32_t maxFrameBytes = 256u << 20;
+
+    // Construct on socket fd, or stdin / stdout for -1.  The channel does not own fd.
+    explicit FrameChannel(int fd) : m_fd(fd) {}
+
+    // False at the end of the stream.  A frame longer than maxFrameBytes is skipped, so the
+    // stream stays in step, frameOut is then empty and tooLongOut set.
+    bool readFrame(std::string& frameOut, bool& tooLongOut);
+
+    // Write frame, false if the connection is gone
+    bool writeFrame(const std::string& frame);
+
+};
+
+} // end namespace gaden
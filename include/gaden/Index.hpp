@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gaden {
+
+// Type of point, face and edge indices, and of field sizes.  32-bit by default, which halves the
+// memory of every index field; configure with -DIndex64=ON for inputs beyond 2^31 points.
+#ifdef GADEN_INDEX64
+typedef std::int64_t index_t;
+#else
+typedef std::int32_t index_t;
+#endif
+
+} // end namespace gaden
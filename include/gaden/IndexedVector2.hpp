@@ -1,102 +1,111 @@
 #pragma once
 
+#include <type_traits>
+
+#include "gaden/Index.hpp"
 #include "Vector2.hpp"
 
 namespace gaden {
 
-class IndexedVector2 {
+template <class Scalar>
+class IndexedVector2T {
     // 2D vector value
-    Vector2 m_v;
+    Vector2T<Scalar> m_v;
 
     // Optional index tag
-    int m_idx;
+    index_t m_idx;
 
 public:
 
     // Null constructor
-    IndexedVector2() : m_v(), m_idx(-1) {}
+    IndexedVector2T() : m_v(), m_idx(-1) {}
 
     // Construct from components
-    IndexedVector2(double x, double y, int idx = -1) : m_v(x, y), m_idx(idx) {}
+    IndexedVector2T(Scalar x, Scalar y, index_t idx = -1) : m_v(x, y), m_idx(idx) {}
 
     // Construct from Vector2 and index
-    IndexedVector2(const Vector2& v, int idx = -1) : m_v(v), m_idx(idx) {}
+    IndexedVector2T(const Vector2T<Scalar>& v, index_t idx = -1) : m_v(v), m_idx(idx) {}
+
+    // Convert from another precision, implicit only when widening
+    template <class Other>
+    explicit(sizeof(Other) > sizeof(Scalar)) IndexedVector2T(const IndexedVector2T<Other>& v) :
+        m_v(static_cast<Vector2T<Scalar>>(v.v())), m_idx(v.idx()) {}
 
     // Accessors
-    Vector2& v() { return m_v; }
-    const Vector2& v() const { return m_v; }
+    Vector2T<Scalar>& v() { return m_v; }
+    const Vector2T<Scalar>& v() const { return m_v; }
 
-    double x() const { return m_v.x(); }
-    double& x() { return m_v.x(); }
-    double y() const { return m_v.y(); }
-    double& y() { return m_v.y(); }
+    Scalar x() const { return m_v.x(); }
+    Scalar& x() { return m_v.x(); }
+    Scalar y() const { return m_v.y(); }
+    Scalar& y() { return m_v.y(); }
 
-    int idx() const { return m_idx; }
-    int& idx() { return m_idx; }
+    index_t idx() const { return m_idx; }
+    index_t& idx() { return m_idx; }
 
     // Cross product (2D vector math)
-    double crossProduct(const IndexedVector2& rhs) const { return m_v.crossProduct(rhs.m_v); }
+    Scalar crossProduct(const IndexedVector2T& rhs) const { return m_v.crossProduct(rhs.m_v); }
 
     // Dot product (inner product)
-    double dotProduct(const IndexedVector2& rhs) const { return m_v.dotProduct(rhs.m_v); }
+    Scalar dotProduct(const IndexedVector2T& rhs) const { return m_v.dotProduct(rhs.m_v); }
 
     // Magnitude, squared
-    double magSqr() const { return m_v.magSqr(); }
+    Scalar magSqr() const { return m_v.magSqr(); }
 
     // Magnitude (length)
-    double mag() const { return m_v.mag(); }
+    Scalar mag() const { return m_v.mag(); }
 
     // Turn into a unit vector, returns false if magnitude is near-zero
     bool normalise() { return m_v.normalise(); }
 
     // Binary operations
 
-    IndexedVector2& operator*=(double val) {
+    IndexedVector2T& operator*=(Scalar val) {
         m_v *= val;
         return *this;
     }
 
-    IndexedVector2& operator/=(double val) {
+    IndexedVector2T& operator/=(Scalar val) {
         m_v /= val;
         return *this;
     }
 
     // * Vectors
 
-    IndexedVector2& operator+=(const IndexedVector2& vec) {
+    IndexedVector2T& operator+=(const IndexedVector2T& vec) {
         // index policy: keep lhs index
         m_v += vec.m_v;
         return *this;
     }
 
-    IndexedVector2& operator-=(const IndexedVector2& vec) {
+    IndexedVector2T& operator-=(const IndexedVector2T& vec) {
         // index policy: keep lhs index
         m_v -= vec.m_v;
         return *this;
     }
 
-    IndexedVector2 operator+(const IndexedVector2& vec) const {
-        return IndexedVector2(*this) += vec;
+    IndexedVector2T operator+(const IndexedVector2T& vec) const {
+        return IndexedVector2T(*this) += vec;
     }
 
-    IndexedVector2 operator-(const IndexedVector2& vec) const {
-        return IndexedVector2(*this) -= vec;
+    IndexedVector2T operator-(const IndexedVector2T& vec) const {
+        return IndexedVector2T(*this) -= vec;
     }
 
-    IndexedVector2 operator*(double scalar) const {
-        IndexedVector2 tmp(*this);
+    IndexedVector2T operator*(Scalar scalar) const {
+        IndexedVector2T tmp(*this);
         tmp *= scalar;
         return tmp;
     }
 
-    IndexedVector2 operator/(double scalar) const {
-        IndexedVector2 tmp(*this);
+    IndexedVector2T operator/(Scalar scalar) const {
+        IndexedVector2T tmp(*this);
         tmp /= scalar;
         return tmp;
     }
 
     // Precedence (optional): delegate to value; tie-break on idx if desired
-    bool operator<(const IndexedVector2& rhs) const {
+    bool operator<(const IndexedVector2T& rhs) const {
         if (m_v < rhs.m_v) { return true; }
         if (rhs.m_v < m_v) { return false; }
         return m_idx < rhs.m_idx;
@@ -104,8 +113,14 @@ public:
 };
 
 // Symmetric scalar multiply (scalar * vec)
-inline IndexedVector2 operator*(double scalar, const IndexedVector2& v) {
+template <class Scalar>
+inline IndexedVector2T<Scalar> operator*(
+    std::type_identity_t<Scalar> scalar, const IndexedVector2T<Scalar>& v
+) {
     return v * scalar;
 }
 
+typedef IndexedVector2T<double> IndexedVector2;
+typedef IndexedVector2T<float> IndexedVector2f;
+
 } // end namespace gaden
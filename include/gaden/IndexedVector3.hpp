@@ -1,57 +1,68 @@
 #pragma once
 
+#include <type_traits>
+
+#include "gaden/Index.hpp"
 #include "Vector3.hpp"
 
 namespace gaden {
 
-class IndexedVector3 {
-    Vector3 m_v;
-    int m_idx;
+template <class Scalar>
+class IndexedVector3T {
+    Vector3T<Scalar> m_v;
+    index_t m_idx;
 
 public:
 
     // Construct from components
-    IndexedVector3(double x_in, double y_in, double z_in, int idx_in = -1):
+    IndexedVector3T(Scalar x_in, Scalar y_in, Scalar z_in, index_t idx_in = -1):
         m_v(x_in, y_in, z_in),
         m_idx(idx_in)
     {}
 
     // Null constructor
-    IndexedVector3():
+    IndexedVector3T():
         m_v(),
         m_idx(-1)
     {}
 
     // Construct from Vector3 and index
-    IndexedVector3(const Vector3& v_in, int idx_in = -1):
+    IndexedVector3T(const Vector3T<Scalar>& v_in, index_t idx_in = -1):
         m_v(v_in),
         m_idx(idx_in)
     {}
 
+    // Convert from another precision, implicit only when widening
+    template <class Other>
+    explicit(sizeof(Other) > sizeof(Scalar)) IndexedVector3T(const IndexedVector3T<Other>& v):
+        m_v(static_cast<Vector3T<Scalar>>(v.v())),
+        m_idx(v.idx())
+    {}
+
     // Accessors
 
-    Vector3& v() { return m_v; }
-    const Vector3& v() const { return m_v; }
+    Vector3T<Scalar>& v() { return m_v; }
+    const Vector3T<Scalar>& v() const { return m_v; }
 
-    double x() const { return m_v.x(); }
-    double& x() { return m_v.x(); }
-    double y() const { return m_v.y(); }
-    double& y() { return m_v.y(); }
-    double z() const { return m_v.z(); }
-    double& z() { return m_v.z(); }
+    Scalar x() const { return m_v.x(); }
+    Scalar& x() { return m_v.x(); }
+    Scalar y() const { return m_v.y(); }
+    Scalar& y() { return m_v.y(); }
+    Scalar z() const { return m_v.z(); }
+    Scalar& z() { return m_v.z(); }
 
-    int idx() const { return m_idx; }
-    int& idx() { return m_idx; }
+    index_t idx() const { return m_idx; }
+    index_t& idx() { return m_idx; }
 
     // Unary operations
 
     // Magnitude, squared x^2,y^2,z^2
-    double magSqr() const {
+    Scalar magSqr() const {
         return m_v.magSqr();
     }
 
     // Magnitude (i.e. length)
-    double mag() const {
+    Scalar mag() const {
         return m_v.mag();
     }
 
@@ -64,62 +75,68 @@ public:
 
     // * Scalars
 
-    IndexedVector3& operator*=(double val) {
+    IndexedVector3T& operator*=(Scalar val) {
         m_v *= val;
         return *this;
     }
 
-    IndexedVector3& operator/=(double val) {
+    IndexedVector3T& operator/=(Scalar val) {
         m_v /= val;
         return *this;
     }
 
     // * Vectors
 
-    IndexedVector3& operator+=(const IndexedVector3& vec) {
+    IndexedVector3T& operator+=(const IndexedVector3T& vec) {
         m_v += vec.m_v;        // index policy: keep lhs index
         return *this;
     }
 
-    IndexedVector3& operator-=(const IndexedVector3& vec) {
+    IndexedVector3T& operator-=(const IndexedVector3T& vec) {
         m_v -= vec.m_v;        // index policy: keep lhs index
         return *this;
     }
 
-    IndexedVector3 operator+(const IndexedVector3& vec) const {
-        return IndexedVector3(*this) += vec;
+    IndexedVector3T operator+(const IndexedVector3T& vec) const {
+        return IndexedVector3T(*this) += vec;
     }
 
-    IndexedVector3 operator-(const IndexedVector3& vec) const {
-        return IndexedVector3(*this) -= vec;
+    IndexedVector3T operator-(const IndexedVector3T& vec) const {
+        return IndexedVector3T(*this) -= vec;
     }
 
-    IndexedVector3 operator*(double scalar) const {
-        IndexedVector3 tmp(*this);
+    IndexedVector3T operator*(Scalar scalar) const {
+        IndexedVector3T tmp(*this);
         tmp *= scalar;
         return tmp;
     }
 
-    IndexedVector3 operator/(double scalar) const {
-        IndexedVector3 tmp(*this);
+    IndexedVector3T operator/(Scalar scalar) const {
+        IndexedVector3T tmp(*this);
         tmp /= scalar;
         return tmp;
     }
 
     // Returns result=(*this) crossProduct rhs, carrying lhs index
-    IndexedVector3 crossProduct(const IndexedVector3& rhs) const {
-        return IndexedVector3(m_v.crossProduct(rhs.m_v), m_idx);
+    IndexedVector3T crossProduct(const IndexedVector3T& rhs) const {
+        return IndexedVector3T(m_v.crossProduct(rhs.m_v), m_idx);
     }
 
     // Returns result=(*this) dotProduct rhs
-    double dotProduct(const IndexedVector3& rhs) const {
+    Scalar dotProduct(const IndexedVector3T& rhs) const {
         return m_v.dotProduct(rhs.m_v);
     }
 };
 
 // Symmetric scalar multiply (scalar * vec)
-inline IndexedVector3 operator*(double scalar, const IndexedVector3& v) {
+template <class Scalar>
+inline IndexedVector3T<Scalar> operator*(
+    std::type_identity_t<Scalar> scalar, const IndexedVector3T<Scalar>& v
+) {
     return v * scalar;
 }
 
+typedef IndexedVector3T<double> IndexedVector3;
+typedef IndexedVector3T<float> IndexedVector3f;
+
 } // end namespace gaden
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+namespace gaden {
+
+// Just enough json for the batch results and the service's requests: flat objects, read with a
+// regex, no nesting
+class JsonTools {
+
+public:
+
+    // Escape s as a quoted json string
+    static std::string quote(const std::string& s);
+
+    // Raw value of "key" in a flat json object: a quoted string with its quotes, or a number.
+    // False if it is not there.
+    static bool field(std::string& valueOut, const std::string& json, const std::string& key);
+
+    // A quoted json string's contents, with \" and \\ unescaped
+    static std::string unquote(const std::string& quoted);
+
+};
+
+} // end namespace gaden
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gaden/BoundBox.hpp"
+#include "gaden/Vector3.hpp"
+#include "gaden/VectorNField.hpp"
+
+namespace gaden {
+
+// An integer lattice for quantized point coordinates, world = origin + spacing*(i, j, k).
+//
+// Lattice coordinates lie in [0, maxCoord], so coordinate differences fit in 31 bits and the
+// cross product of two differences fits in int64.  That keeps the orientation predicates below
+// exact without wider integer types: a point is on, above or below a plane with no tolerance.
+class Lattice {
+
+    // Private data
+
+    // World position of lattice point (0, 0, 0)
+    Vector3 m_origin;
+
+    // Distance between neighbouring lattice points
+    double m_spacing;
+
+
+public:
+
+    // Largest lattice coordinate
+    static const std::int32_t maxCoord = (1 << 30) - 1;
+
+    // Construct null, unit spacing at the world origin
+    Lattice(): m_origin(), m_spacing(1.0) {}
+
+    // Construct from components
+    Lattice(const Vector3& origin, double spacing):
+        m_origin(origin),
+        m_spacing(spacing)
+    {}
+
+    // Lattice covering bb, with the smallest spacing of minSpacing*2^k that keeps every
+    // coordinate within maxCoord.  minSpacing <= 0 takes the finest spacing that fits.
+    static Lattice fit(const BoundBox& bb, double minSpacing);
+
+
+    // Accessors
+
+    const Vector3& origin() const { return m_origin; }
+    double spacing() const { return m_spacing; }
+
+
+    // Conversion
+
+    // Nearest lattice point to pt, clamped into [0, maxCoord]
+    Vector3i quantize(const Vector3& pt) const;
+
+    // World position of lattice point, or of any point in lattice units
+    Vector3 toWorld(const Vector3& latticePt) const { return m_origin + latticePt*m_spacing; }
+
+    // Field versions of the above
+    Vector3iField quantize(const Vector3Field& ptsIn) const;
+    Vector3Field toWorld(const Vector3Field& latticePtsIn) const;
+
+
+    // Exact predicates
+
+    // (b - a) x (c - a), exact
+    static void crossProduct(
+        // outputs
+        std::int64_t crossOut[3],
+
+        // inputs
+        const Vector3i& a, const Vector3i& b, const Vector3i& c
+    );
+
+    // True if a, b and c lie on one line, exact
+    static bool collinear(const Vector3i& a, const Vector3i& b, const Vector3i& c);
+
+    // ((b - a) x (c - a)) . (d - a), six times the signed volume of tetrahedron abcd.  The sign
+    // is exact, positive when d is on the side the normal of triangle abc points to; the
+    // magnitude is rounded to double.  Evaluated in double first, the integer evaluation only runs
+    // when that is within its error bound of zero.
+    static double orient3d(const Vector3i& a, const Vector3i& b, const Vector3i& c,
+        const Vector3i& d);
+
+};
+
+} // end namespace gaden
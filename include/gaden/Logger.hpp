@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -87,6 +88,8 @@ public:
 
     void log(LogLevel level, const std::string& msg) {
         if (!m_enabled || level < m_minLevel) return;
+        // Batch mode logs from several threads, keep each message whole
+        std::lock_guard<std::mutex> lock(m_mutex);
         std::string levelStr = "[" + levelToString(level) + "] ";
         std::cerr << levelStr << msg << std::endl;
         if (m_ossPtr) {
@@ -208,6 +211,7 @@ private:
     }
     bool m_enabled = true;
     LogLevel m_minLevel = LogLevel::Info;
+    std::mutex m_mutex;
     static std::ofstream* m_ossPtr;
     int m_indent;
     std::string m_indentStr;
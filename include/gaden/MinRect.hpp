@@ -31,7 +31,7 @@ struct MinRect {
     double m_height;
 
     // hull edge index that defined psi
-    int m_parentEdge;
+    index_t m_parentEdge;
 
 public:
 
@@ -50,8 +50,8 @@ public:
     double& width() { return m_width; }
     double height() const { return m_height; }
     double& height() { return m_height; }
-    int parentEdge() const { return m_parentEdge; }
-    int& parentEdge() { return m_parentEdge; }
+    index_t parentEdge() const { return m_parentEdge; }
+    index_t& parentEdge() { return m_parentEdge; }
 
     // Functionality
 
@@ -67,7 +67,7 @@ public:
     // Calculate axial edges from the i'th edge in a planar polygon, return as output parameters
     static void calculateEdgeFrame(
         // inputs
-        int i, int hullSize, const IndexedVector2Field& polygon,
+        index_t i, index_t hullSize, const IndexedVector2Field& polygon,
 
         // outputs
         IndexedVector2& ue, IndexedVector2& ve
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <limits>
+
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/Vector3.hpp"
+
+namespace gaden {
+
+struct OrientedBoundBox {
+    // Plain old data container, a single candidate orientation from the minimum bound box search,
+    //  and the bound box it produces
+
+    // False if the orientation could not be evaluated (degenerate frame or projection)
+    bool m_valid;
+
+    // Bound box volume, infinity when not valid
+    double m_volume;
+
+    // Angles of rotation in 3d space:
+    //  * theta (heading / yaw)
+    //  * phi (declination / pitch)
+    //  * psi (roll)
+    double m_theta;
+    double m_phi;
+    double m_psi;
+
+    // min/max in the rotated (u', v', w') frame
+    BoundBox m_localBb;
+
+    // world-space orthonormal basis (u', v', w')
+    Axes m_axes;
+
+public:
+
+    // Construct null
+    OrientedBoundBox() { clear(); }
+
+    // Accessors
+
+    bool valid() const { return m_valid; }
+    bool& valid() { return m_valid; }
+    double volume() const { return m_volume; }
+    double& volume() { return m_volume; }
+    double theta() const { return m_theta; }
+    double& theta() { return m_theta; }
+    double phi() const { return m_phi; }
+    double& phi() { return m_phi; }
+    double psi() const { return m_psi; }
+    double& psi() { return m_psi; }
+    const BoundBox& localBb() const { return m_localBb; }
+    BoundBox& localBb() { return m_localBb; }
+    const Axes& axes() const { return m_axes; }
+    Axes& axes() { return m_axes; }
+
+    // Rotations as (theta, phi, psi)
+    Vector3 rotations() const { return Vector3(m_theta, m_phi, m_psi); }
+
+    // Functionality
+
+    void clear() {
+        m_valid = false;
+        m_volume = std::numeric_limits<double>::infinity();
+        m_theta = 0.0;
+        m_phi = 0.0;
+        m_psi = 0.0;
+        m_localBb = BoundBox();
+        m_axes = Axes();
+    }
+
+    // True if this is a strictly smaller valid box than rhs
+    bool betterThan(const OrientedBoundBox& rhs) const {
+        return m_valid && m_volume < rhs.m_volume;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const OrientedBoundBox& c) {
+        return os << "{volume=" << c.m_volume << ", rotations=" << c.rotations()
+            << ", bb=" << c.m_localBb << "}";
+    }
+};
+
+} // end namespace gaden
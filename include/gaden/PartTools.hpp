@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gaden/AppOptions.hpp"
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBox.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/ConvexHullHierarchy.hpp"
+#include "gaden/Face.hpp"
+#include "gaden/Index.hpp"
+#include "gaden/Surface3.hpp"
+#include "gaden/ThreadPool.hpp"
+#include "gaden/Vector3.hpp"
+#include "gaden/Vector3View.hpp"
+#include "gaden/VectorNField.hpp"
+
+namespace gaden {
+
+// Result of solving one part file
+struct PartResult {
+    bool m_ok = false;
+    std::string m_error;
+
+    // Part id, for the parts of a multi-part file
+    bool m_hasPartId = false;
+    index_t m_partId = 0;
+
+    // Unique points read (after merging) and hull points searched
+    index_t m_nPoints = 0;
+    index_t m_nHullPoints = 0;
+
+    BoundBox m_bb;
+    Axes m_axes;
+    Vector3 m_rotations;
+
+    // Wall time of the part, reading included unless the file holds many parts
+    double m_ms = 0.0;
+
+    // Mark as solved, timed from startTime
+    void finish(const std::chrono::steady_clock::time_point& startTime) {
+        m_ok = true;
+        m_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startTime
+        ).count();
+    }
+};
+
+
+// A part's hull, ready for the orientation search
+struct PreparedHull {
+    // Hull points searched (kernel points with --kernel) and the surface normals
+    Vector3Field m_chPts;
+    Vector3Field m_normals;
+
+    // Graph of m_chPts, and of the full hull when m_chPts is a kernel
+    ConvexHullGraph m_hullGraph;
+    ConvexHullGraph m_fullGraph;
+    ConvexHullHierarchy m_hullHierarchy;
+
+    // Unique points read and hull points
+    index_t m_nPoints = 0;
+    index_t m_nHullPoints = 0;
+};
+
+
+// Reading, hulling and solving the parts of the application, as its options ask.  Shared by the
+// single file, batch and service modes.
+class PartTools {
+
+    // Private member functions
+
+    // Graph, optional kernel and hierarchy of a part's 3d hull of nPts points, as prepareHull
+    // and prepareHullInPlace finish.  chPts and normals are taken, chVerts and chFaces cleared.
+    static void buildHull(
+        // outputs
+        PreparedHull& hullOut,
+
+        // inputs
+        const AppOptions& opt,
+        Vector3Field& chPts,
+        IndexField& chVerts,
+        std::vector<Face>& chFaces,
+        Vector3Field& normals,
+        int nDims,
+        index_t nPts
+    );
+
+
+public:
+
+    // Hulls with at least this many vertices spread the grid's rows over the thread pool, smaller
+    // ones are cheaper solved on one thread, alongside other parts
+    static const int parallelGridMinVerts = 1000;
+
+    // Set on SIGINT during a time-budgeted search, which then stops with the best box so far
+    static std::atomic<bool> interrupted;
+
+    // Merge tolerance while reading, 0 when the points are merged later or not at all
+    static double readEpsilon(const AppOptions& opt);
+
+    // True if points are read in single precision: --single-points, and the part is hulled from
+    // its points as read or merged (no --quantize, --ladder or fixed --axis)
+    static bool readsSinglePrecision(const AppOptions& opt);
+
+    // Read a part file, merging points and in the precision opt asks.  False with errorOut set if it cannot be
+    // opened.
+    static bool readSurface(
+        // outputs
+        Surface3& surfaceOut,
+        std::string& errorOut,
+
+        // inputs
+        const AppOptions& opt,
+        const std::string& filePath
+    );
+
+    // nPoints given as packed x, y, z doubles into surfaceOut, merging them as readSurface would
+    static void surfaceFromXyz(
+        // outputs
+        Surface3& surfaceOut,
+
+        // inputs
+        const AppOptions& opt,
+        const double* xyz,
+        size_t nPoints
+    );
+
+    // Merge and hull the points of one part with the options in opt, timed from startTime.  The
+    // surface's points are taken.  Returns false if the part needs no hull (--ladder, --axis),
+    // it is then already solved in resultOut.
+    static bool prepareHull(
+        // outputs
+        PreparedHull& hullOut,
+        PartResult& resultOut,
+
+        // inputs
+        const AppOptions& opt,
+        Surface3& surface,
+        const std::chrono::steady_clock::time_point& startTime
+    );
+
+    // True if opt hulls the points just as they are given: they are neither merged nor quantized
+    // first, and the part needs a hull (no --ladder or fixed --axis)
+    static bool hullsInPlace(const AppOptions& opt);
+
+    // As prepareHull when hullsInPlace(opt), reading the points where they are instead of taking
+    // them from a surface.  There are no surface normals.
+    static void prepareHullInPlace(
+        // outputs
+        PreparedHull& hullOut,
+
+        // inputs
+        const AppOptions& opt,
+        const Vector3View& pts
+    );
+
+    // Orientation search on a prepared hull with the options in opt, timed from startTime.  pool,
+    // if given, is used by the grid solver on large hulls.
+    static void solveHull(
+        // outputs
+        PartResult& resultOut,
+
+        // inputs
+        const AppOptions& opt,
+        PreparedHull& hull,
+        ThreadPool* pool,
+        const std::chrono::steady_clock::time_point& startTime
+    );
+
+    // Hull and solve the points of one part, see prepareHull and solveHull
+    static void solveSurface(
+        // outputs
+        PartResult& resultOut,
+
+        // inputs
+        const AppOptions& opt,
+        Surface3& surface,
+        ThreadPool* pool,
+        const std::chrono::steady_clock::time_point& startTime
+    );
+
+    // Hull and solve nPoints given as packed x, y, z doubles.  They are read in place when opt
+    // allows (see hullsInPlace), and copied into a surface only to be merged or quantized.
+    static void solvePoints(
+        // outputs
+        PartResult& resultOut,
+
+        // inputs
+        const AppOptions& opt,
+        const double* xyz,
+        size_t nPoints,
+        ThreadPool* pool,
+        const std::chrono::steady_clock::time_point& startTime
+    );
+
+    // Solve each part of a multi-part surface as a task on pool, largest first, calling onResult
+    // from the solving thread as each finishes.  Returns the number of parts that failed.
+    static int solveParts(
+        const std::function<void(const PartResult&)>& onResult,
+        const AppOptions& opt,
+        const Surface3& surface,
+        ThreadPool& pool
+    );
+
+};
+
+} // end namespace gaden
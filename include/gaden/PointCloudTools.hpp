@@ -19,8 +19,8 @@ public:
     static void mergePointsMap(
         const Vector3Field& ptsIn,
         double mergeTol,
-        int estimatedSize,
-        IntField& mapOut
+        index_t estimatedSize,
+        IndexField& mapOut
     );
 
     // Identify mergable points and return the merged subset as well as the map from old to new
@@ -34,15 +34,103 @@ public:
     static void mergePointsSubset(
         const Vector3Field& ptsIn,
         double mergeTol,
-        int estimatedSize,
-        IntField& mapOut,
+        index_t estimatedSize,
+        IndexField& mapOut,
         Vector3Field& ptsOut
     );
 
+    // Single precision counterparts of mergePointsMap and mergePointsSubset, distances are still
+    // measured in double precision
+    static void mergePointsMap(
+        const Vector3fField& ptsIn,
+        double mergeTol,
+        index_t estimatedSize,
+        IndexField& mapOut
+    );
+    static void mergePointsSubset(
+        const Vector3fField& ptsIn,
+        double mergeTol,
+        index_t estimatedSize,
+        IndexField& mapOut,
+        Vector3fField& ptsOut
+    );
+
+    // Lattice counterpart of mergePointsSubset (see Lattice): points merge when their lattice
+    // coordinates are equal, found by exact hash equality, no tolerance.  Kept points are in
+    // order of first occurrence.
+    //  Outputs
+    //      * mapOut - map from old to new: mapOut[ptsInIndex] = subsetIndex
+    //      * ptsOut - copy of the ptsIn, with the duplicate (merged) points removed
+    static void mergeLatticeSubset(
+        const Vector3iField& ptsIn,
+        IndexField& mapOut,
+        Vector3iField& ptsOut
+    );
+
+    // 2d counterpart of mergePointsMap, with the same tolerance semantics as AutoMergingPointCloud:
+    // points are taken in order, and each merges into the earliest kept point within mergeTol.
+    // Candidates come from a hash grid of 2*mergeTol cells, searching the 2 x 2 cells nearest each
+    // point, so any two points within tolerance are found, whatever their order.
+    //  Inputs
+    //      * ptsIn - the 2d points
+    //      * mergeTol - the maximum distance between mergable points
+    //  Outputs
+    //      * mapOut - map from old to new: mapOut[ptsInIndex] = subsetIndex
+    static void mergePoints2dMap(
+        const IndexedVector2Field& ptsIn,
+        double mergeTol,
+        IndexField& mapOut
+    );
+
+    // As mergePoints2dMap, also returning the merged subset, in input order
+    //  Outputs
+    //      * mapOut - map from old to new: mapOut[ptsInIndex] = subsetIndex
+    //      * ptsOut - copy of the ptsIn, with the duplicate (merged) points removed
+    static void mergePoints2dSubset(
+        const IndexedVector2Field& ptsIn,
+        double mergeTol,
+        IndexField& mapOut,
+        IndexedVector2Field& ptsOut
+    );
+
+    // As mergePoints2dSubset, in place.  Kept points stay in their input order, so a sorted input
+    // stays sorted.
+    static void mergePoints2d(double mergeTol, IndexedVector2Field& ptsInOut);
+
+    // sortLexicographic uses the radix sort for sizes in [radixSortMinSize, radixSortMaxSize] and
+    // std::sort otherwise.  Below the range the fixed cost dominates, above it the scatter passes
+    // miss cache.  Tuned with sandbox_bench radix.
+    static const int radixSortMinSize = 2048;
+    static const int radixSortMaxSize = 131072;
+
+    // Sort 2d points by (x, y, idx), as IndexedVector2::operator<.  Dispatches on size between
+    // std::sort and radixSortLexicographic.
+    static void sortLexicographic(IndexedVector2Field& pts);
+
+    // LSD radix sort by (x, y, idx).  x maps to an order-preserving 64-bit key, a compact
+    // (key, index) array is sorted a byte at a time, skipping bytes that all keys share, then the
+    // points are gathered and the rare runs of equal x are sorted by y.  Ties are ordered by laying
+    // the array out in idx order, so the idx tags must be a permutation of [0, n), as for
+    // projected points; otherwise this falls back to std::sort.
+    static void radixSortLexicographic(IndexedVector2Field& pts);
+
+    // Build the orthonormal (u, v, w) frame used for projection, where w is the look direction:
+    //  thetaIn (heading / yaw, rotation about z axis)
+    //  phiIn   (declination / pitch)
+    // Returns false if the frame could not be normalised
+    static bool calculateProjectionFrame(
+        double thetaIn,
+        double phiIn,
+        Vector3& uOut,
+        Vector3& vOut,
+        Vector3& wOut
+    );
+
     // Project to plane with rotation:
     //  thetaIn (heading / yaw, rotation about z axis)
     //  phiIn   (declination / pitch)
     // toleranceIn is used in determining if two projected points overlapp and can be merged
+    // (see mergePoints2d)
     static void projectPointsToPlane(
         const Vector3Field& ptsIn,
         double thetaIn,
@@ -50,6 +138,20 @@ public:
         double toleranceIn,
         IndexedVector2Field& ptsOut
     );
+
+    // As projectPointsToPlane, for sweeps over nearby orientations.  orderInOut carries the sorted
+    // order (point indices) from the previous call, points are projected in that order and
+    // re-sorted by insertion sort, close to linear when the rotation is small.  Falls back to a
+    // full sort when orderInOut is empty or the order has changed too much.  Gives the same
+    // ptsOut as projectPointsToPlane.
+    static void projectPointsToPlaneCoherent(
+        const Vector3Field& ptsIn,
+        double thetaIn,
+        double phiIn,
+        double toleranceIn,
+        IndexField& orderInOut,
+        IndexedVector2Field& ptsOut
+    );
 };
 
 } // end namespace gaden
\ No newline at end of file
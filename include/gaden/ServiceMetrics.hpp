@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gaden {
+
+// Latency of the requests a service has answered.  Safe to add to from the connection threads.
+class ServiceMetrics {
+
+    // Private data
+
+    // Totals of the last nRecent requests, for the percentiles
+    static constexpr std::size_t nRecent = 1024;
+
+    std::mutex m_mutex;
+    long long m_nRequests = 0;
+    long long m_nFailed = 0;
+    std::vector<double> m_recentMs;
+    std::size_t m_next = 0;
+
+
+public:
+
+    // Count a request, totalMs from its first byte read to its response written
+    void add(double totalMs, bool ok);
+
+    // Counts, and the mean and percentiles of the recent totals, as a json object
+    std::string json();
+
+};
+
+} // end namespace gaden
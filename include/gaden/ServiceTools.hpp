@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+#include "gaden/AppOptions.hpp"
+#include "gaden/FrameChannel.hpp"
+#include "gaden/ServiceMetrics.hpp"
+#include "gaden/SharedJobSegment.hpp"
+#include "gaden/ThreadPool.hpp"
+
+namespace gaden {
+
+// Resident solver service (--serve): json requests in frames, over a Unix domain socket or stdin
+// / stdout, with the points in a frame of their own or a shared memory job (gaden/SharedJob.h)
+class ServiceTools {
+
+public:
+
+    // Response to a request that could not be answered
+    static std::string errorResponse(const std::string& id, const std::string& error);
+
+    // Answer one request of a service connection.  header is the request's json frame, a points
+    // request is followed by a frame of its points, a shm request names a job in segment.  Sets
+    // shutdownOut on a shutdown request.
+    static std::string answerRequest(
+        // outputs
+        bool& shutdownOut,
+
+        // inputs
+        FrameChannel& channel,
+        SharedJobSegment& segment,
+        const std::string& header,
+        const AppOptions& opt,
+        ThreadPool& pool,
+        ServiceMetrics& metrics
+    );
+
+    // Answer the requests of one connection until it closes or asks for a shutdown.  Returns true
+    // on a shutdown request.
+    static bool serveConnection(
+        FrameChannel& channel,
+        const AppOptions& opt,
+        ThreadPool& pool,
+        ServiceMetrics& metrics
+    );
+
+    // Resident service on opt.servePath, a Unix domain socket with a thread per connection, or
+    // stdin / stdout for "-".  The thread pool lives as long as the service.
+    static int serve(const AppOptions& opt);
+
+};
+
+} // end namespace gaden
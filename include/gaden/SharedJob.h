@@ -0,0 +1,77 @@
+/* Layout of a shared memory job, shared by the service (--serve) and its C clients.
+ *
+ * A job segment is a GadenShmHeader, then from GADEN_SHM_POINTS_OFFSET room for capacity points
+ * as packed x, y, z doubles.  The client creates the segment (shm_open, ftruncate to
+ * gadenShmSize(capacity), mmap), fills in the header and points, and sends the service a request
+ * {"shm": "/name"}.  The service reads the points in place and fills in the result slot before
+ * it replies, the client must leave the segment alone until then.  Repeat jobs on a connection
+ * reuse the service's mapping, so a client keeps one segment and bumps sequence per job.
+ *
+ * Plain C, so clients need no C++.  Native byte order and padding: client and service share a
+ * machine. */
+#ifndef GADEN_SHAREDJOB_H
+#define GADEN_SHAREDJOB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* "GSHM" */
+#define GADEN_SHM_MAGIC 0x4d485347u
+/* 2: nHullPoints is 64-bit */
+#define GADEN_SHM_VERSION 2u
+
+/* Byte offset of the points, the header padded to whole cache lines */
+#define GADEN_SHM_POINTS_OFFSET 256u
+
+/* GadenShmResult status */
+#define GADEN_SHM_PENDING 0
+#define GADEN_SHM_SOLVED 1
+#define GADEN_SHM_FAILED 2
+
+typedef struct GadenShmResult {
+    /* Header sequence of the job solved, status is for that job only */
+    uint64_t sequence;
+    int32_t status;
+    int32_t reserved;
+
+    /* Hull points searched */
+    uint64_t nHullPoints;
+
+    /* Box in its own axes (BoundBox), and its volume */
+    double minPt[3];
+    double maxPt[3];
+    double volume;
+
+    /* Box x, y and z axes (Axes), unit vectors in world coordinates, and their rotations */
+    double axes[3][3];
+    double rotations[3];
+
+    /* Solve time in the service, milliseconds */
+    double ms;
+} GadenShmResult;
+
+typedef struct GadenShmHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    /* Points the segment has room for, and points in this job */
+    uint64_t capacity;
+    uint64_t nPoints;
+
+    /* Set by the client per job, copied to result.sequence when the job is answered */
+    uint64_t sequence;
+
+    GadenShmResult result;
+} GadenShmHeader;
+
+/* Segment bytes for capacity points */
+static inline size_t gadenShmSize(uint64_t capacity) {
+    return GADEN_SHM_POINTS_OFFSET + (size_t)capacity*3*sizeof(double);
+}
+
+/* The points of a mapped segment */
+static inline double* gadenShmPoints(GadenShmHeader* header) {
+    return (double*)((char*)header + GADEN_SHM_POINTS_OFFSET);
+}
+
+#endif /* GADEN_SHAREDJOB_H */
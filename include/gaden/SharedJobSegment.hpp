@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "gaden/PartTools.hpp"
+#include "gaden/SharedJob.h"
+
+namespace gaden {
+
+// A client's shared memory job segment (gaden/SharedJob.h), mapped by a service connection.  It
+// stays mapped, with its descriptor open, while the client keeps naming it, so repeat jobs cost
+// one open and fstat but no mmap or page faults.  It is mapped again when the segment's size or
+// inode changes, i.e. the client has grown it or removed and created it again.
+class SharedJobSegment {
+
+    // Private data
+
+    std::string m_name;
+    int m_fd = -1;
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+
+    // Device and inode of the mapped segment
+    std::uint64_t m_device = 0;
+    std::uint64_t m_inode = 0;
+
+
+    // Private member functions
+
+    // Drop the mapping, if any
+    void unmap();
+
+
+public:
+
+    // Construct unmapped
+    SharedJobSegment() = default;
+
+    // Not copyable, the mapping has one owner
+    SharedJobSegment(const SharedJobSegment&) = delete;
+    SharedJobSegment& operator=(const SharedJobSegment&) = delete;
+
+    ~SharedJobSegment() { unmap(); }
+
+    // Header of the job in segment name, mapping it unless it is mapped already, and the job's
+    // point count, read once.  Null with errorOut set if the segment cannot be mapped or its
+    // header is not a job that fits it, gadenShmSize(capacity) beyond the segment's size.
+    GadenShmHeader* map(
+        // outputs
+        std::string& errorOut,
+        std::uint64_t& nPointsOut,
+
+        // inputs
+        const std::string& name
+    );
+
+    // Fill in the result slot of a shared memory job, numbered sequence
+    static void writeResult(GadenShmHeader& job, std::uint64_t sequence, const PartResult& result);
+
+};
+
+} // end namespace gaden
@@ -0,0 +1,1119 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "gaden/Axes.hpp"
+#include "gaden/BoundBoxTools.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/OrientedBoundBox.hpp"
+#include "gaden/Vector3.hpp"
+
+namespace gaden {
+
+// Exact candidate-enumeration box for hulls of at most MaxVerts vertices, with every working
+// array sized at compile time and held on the stack.
+//
+// A minimum-volume box has two adjacent faces flush with edges of the hull (O'Rourke 1985), and
+// is usually flush with a whole hull face.  Both kinds of candidate are enumerated:
+//  * face-flush - each hull face normal as the third axis, the roll about it solved exactly by
+//    projection, 2d hull and rotating calipers
+//  * edge-pair - for each pair of hull edges, the frames with one face flush with the first edge
+//    and an adjacent face flush with the second.  These form a one-parameter family, the first
+//    face normal turning through the normal arc of its edge.  The angles where the family exists
+//    are found in closed form, then the family is minimised by branch-and-bound on the angle.
+//    With the extreme vertices of an interval's centre frame held fixed the volume is a rational
+//    function of tan(angle), whose stationary points are the roots of a polynomial of degree 6.
+//    Held vertices are never further out than the true extremes, so its minimum bounds the
+//    interval from below; the interval is solved when the box measured there meets that bound,
+//    and is otherwise split where an extreme vertex changes.
+// Intervals that cannot beat the best box are pruned first on cheap bounds: the least width on
+// each edge's normal arc, and the widths at the centre less how far the axes can turn.
+template <int MaxVerts>
+class SmallHullSolver {
+
+    // Extreme vertices of a frame along and against each of its axes, and its widths
+    struct Supports {
+        std::array<int, 3> m_hi;
+        std::array<int, 3> m_lo;
+        std::array<double, 3> m_widths;
+
+        double volume() const { return m_widths[0]*m_widths[1]*m_widths[2]; }
+    };
+
+
+    // Private data
+
+    // Relative gap between an interval's bound and its measured box at which it is solved
+    static constexpr double solvedGap = 1e-10;
+
+    // Intervals of one edge pair awaiting the search, more than the depth it ever reaches
+    static const int maxPending = 64;
+
+    // Hull vertices, and the graph's field of them for measuring the final box
+    const Vector3Field* m_field;
+    int m_nVerts;
+    std::array<Vector3, MaxVerts> m_points;
+
+    // Coordinates of m_points less their centroid, padded to MaxVerts with copies of the first
+    // vertex.  The padding does not change any extent, so extent loops run to the compile-time
+    // MaxVerts and unroll.  m_radius is the largest distance of a vertex from the centroid.
+    std::array<double, MaxVerts> m_xs;
+    std::array<double, MaxVerts> m_ys;
+    std::array<double, MaxVerts> m_zs;
+    double m_radius;
+
+    // Hull edges, at most 3*MaxVerts - 6: unit direction and the outward normals of the two
+    // faces that share it.  The normal arc from m_edgeNormalsA to m_edgeNormalsB, turning about
+    // the edge, holds every direction in which the edge is extreme.  m_edgeTangents is the unit
+    // direction the arc leaves m_edgeNormalsA in, m_edgeArcs its angle.  m_edgeMinWidths bounds
+    // the hull's width from below in any direction on the arc.  m_edgeMids is the midpoint of
+    // the arc, m_edgeHalfArcCosines and m_edgeHalfArcSines the cosine and sine of half its angle.
+    // m_edgeVertices is an end of the edge, extreme along the arc, m_edgeEnds the other end and
+    // m_edgeAntipodes a vertex extreme against its midpoint.
+    int m_nEdges;
+    std::array<Vector3, 3*MaxVerts> m_edges;
+    std::array<Vector3, 3*MaxVerts> m_edgeNormalsA;
+    std::array<Vector3, 3*MaxVerts> m_edgeNormalsB;
+    std::array<Vector3, 3*MaxVerts> m_edgeTangents;
+    std::array<double, 3*MaxVerts> m_edgeArcs;
+    std::array<double, 3*MaxVerts> m_edgeMinWidths;
+    std::array<Vector3, 3*MaxVerts> m_edgeMids;
+    std::array<double, 3*MaxVerts> m_edgeHalfArcCosines;
+    std::array<double, 3*MaxVerts> m_edgeHalfArcSines;
+    std::array<int, 3*MaxVerts> m_edgeVertices;
+    std::array<int, 3*MaxVerts> m_edgeEnds;
+    std::array<int, 3*MaxVerts> m_edgeAntipodes;
+
+    // Lower bound on the hull's width in any direction.  The least width is across a face or a
+    // pair of edges, so along a direction on some edge's normal arc.
+    double m_minWidth;
+
+    // Outward unit normals of the hull faces, at most 2*MaxVerts - 4
+    int m_nFaces;
+    std::array<Vector3, 2*MaxVerts> m_faceNormals;
+
+
+    // Private member functions
+
+    // Centred coordinates of vertex i
+    Vector3 vertex(int i) const {
+        return Vector3(m_xs[i], m_ys[i], m_zs[i]);
+    }
+
+    // Outward unit normal of triangle (i, j, k) if it is a hull face, every other vertex on or
+    // behind its plane, false otherwise
+    bool faceNormal(int i, int j, int k, Vector3& normalOut) const {
+        normalOut = (m_points[j] - m_points[i]).crossProduct(m_points[k] - m_points[i]);
+        if (!normalOut.normalise()) {
+            return false;
+        }
+        // Tolerance relative to the hull's diameter, at most twice its radius
+        const double tol = 2e-10*m_radius;
+        const double offset = normalOut.dotProduct(vertex(i));
+        double lo = offset;
+        double hi = offset;
+        for (int l = 0; l < MaxVerts; ++l) {
+            const double dist =
+                m_xs[l]*normalOut.x() + m_ys[l]*normalOut.y() + m_zs[l]*normalOut.z();
+            lo = std::min(lo, dist);
+            hi = std::max(hi, dist);
+        }
+        const bool above = hi - offset > tol;
+        const bool below = lo - offset < -tol;
+        if (above && below) {
+            return false;
+        }
+        if (above) {
+            normalOut *= -1.0;
+        }
+        return true;
+    }
+
+    // Extreme vertices and widths of the frame (a, b, c) of edge pair (k, l).  Edge k is
+    // extreme along a and edge l along b or -b, so only the opposite sides are searched there.
+    void frameSupports(
+        int k,
+        int l,
+        const Vector3& a,
+        const Vector3& b,
+        const Vector3& c,
+        Supports& out
+    ) const {
+        const int vk = m_edgeVertices[k];
+        const int vl = m_edgeVertices[l];
+        const double bSign = b.dotProduct(m_edgeMids[l]) > 0.0 ? 1.0 : -1.0;
+        const Vector3 bs(b*bSign);
+        double loA = m_xs[0]*a.x() + m_ys[0]*a.y() + m_zs[0]*a.z();
+        double loB = m_xs[0]*bs.x() + m_ys[0]*bs.y() + m_zs[0]*bs.z();
+        double loC = m_xs[0]*c.x() + m_ys[0]*c.y() + m_zs[0]*c.z();
+        double hiC = loC;
+        int iLoA = 0;
+        int iLoB = 0;
+        int iLoC = 0;
+        int iHiC = 0;
+        for (int i = 1; i < MaxVerts; ++i) {
+            const double pa = m_xs[i]*a.x() + m_ys[i]*a.y() + m_zs[i]*a.z();
+            const double pb = m_xs[i]*bs.x() + m_ys[i]*bs.y() + m_zs[i]*bs.z();
+            const double pc = m_xs[i]*c.x() + m_ys[i]*c.y() + m_zs[i]*c.z();
+            iLoA = pa < loA ? i : iLoA;
+            loA = pa < loA ? pa : loA;
+            iLoB = pb < loB ? i : iLoB;
+            loB = pb < loB ? pb : loB;
+            iLoC = pc < loC ? i : iLoC;
+            loC = pc < loC ? pc : loC;
+            iHiC = pc > hiC ? i : iHiC;
+            hiC = pc > hiC ? pc : hiC;
+        }
+        out.m_hi[0] = vk;
+        out.m_lo[0] = iLoA;
+        out.m_hi[1] = bSign > 0.0 ? vl : iLoB;
+        out.m_lo[1] = bSign > 0.0 ? iLoB : vl;
+        out.m_lo[2] = iLoC;
+        out.m_hi[2] = iHiC;
+        out.m_widths[0] = a.dotProduct(vertex(vk)) - loA;
+        out.m_widths[1] = bs.dotProduct(vertex(vl)) - loB;
+        out.m_widths[2] = hiC - loC;
+    }
+
+    // Vertices of edge pair (k, l) held for frame (a, b, c) without a pass over the hull for a
+    // and b: the edges are extreme along a and along b or -b, their antipodes opposite.  Any pair
+    // of vertices bounds a width from below, these are exact or close for an axis near the arc
+    // midpoints.
+    void edgePairSupports(
+        int k,
+        int l,
+        const Vector3& a,
+        const Vector3& b,
+        const Vector3& c,
+        Supports& out
+    ) const {
+        out.m_hi[0] = m_edgeVertices[k];
+        out.m_lo[0] = m_edgeAntipodes[k];
+        const bool along = b.dotProduct(m_edgeMids[l]) > 0.0;
+        out.m_hi[1] = along ? m_edgeVertices[l] : m_edgeAntipodes[l];
+        out.m_lo[1] = along ? m_edgeAntipodes[l] : m_edgeVertices[l];
+        double lo = m_xs[0]*c.x() + m_ys[0]*c.y() + m_zs[0]*c.z();
+        double hi = lo;
+        int iLo = 0;
+        int iHi = 0;
+        for (int i = 1; i < MaxVerts; ++i) {
+            const double p = m_xs[i]*c.x() + m_ys[i]*c.y() + m_zs[i]*c.z();
+            iLo = p < lo ? i : iLo;
+            lo = p < lo ? p : lo;
+            iHi = p > hi ? i : iHi;
+            hi = p > hi ? p : hi;
+        }
+        out.m_lo[2] = iLo;
+        out.m_hi[2] = iHi;
+        out.m_widths[0] = a.dotProduct(vertex(out.m_hi[0]) - vertex(out.m_lo[0]));
+        out.m_widths[1] = b.dotProduct(vertex(out.m_hi[1]) - vertex(out.m_lo[1]));
+        out.m_widths[2] = hi - lo;
+    }
+
+    // True if n lies on the normal arc of edge k, or of its opposite edge (the box face on the
+    // other side)
+    bool onNormalArc(int k, const Vector3& n) const {
+        const Vector3& nA = m_edgeNormalsA[k];
+        const Vector3& nB = m_edgeNormalsB[k];
+        const Vector3 axis(nA.crossProduct(nB));
+        const double tol = -1e-12;
+        const double from = nA.crossProduct(n).dotProduct(axis);
+        const double to = n.crossProduct(nB).dotProduct(axis);
+        return (from >= tol && to >= tol) || (from <= -tol && to <= -tol);
+    }
+
+    // Best box with third axis w, returns its volume and its first axis.  Infinity if degenerate,
+    // or if the outline's own area shows it cannot improve on bestVolume.
+    double evaluate(const Vector3& w, double bestVolume, Vector3& uOut) const {
+        const double great = std::numeric_limits<double>::infinity();
+
+        // Frame (u, v, w), depth along w
+        const Vector3 t =
+            (std::fabs(w.z()) < 0.9) ? Vector3(0.0, 0.0, 1.0) : Vector3(1.0, 0.0, 0.0);
+        Vector3 u(t - w*w.dotProduct(t));
+        if (!u.normalise()) {
+            return great;
+        }
+        const Vector3 v(w.crossProduct(u));
+        double minW = great;
+        double maxW = -great;
+        for (int i = 0; i < MaxVerts; ++i) {
+            const double pw = m_xs[i]*w.x() + m_ys[i]*w.y() + m_zs[i]*w.z();
+            minW = std::min(minW, pw);
+            maxW = std::max(maxW, pw);
+        }
+        const double depth = maxW - minW;
+
+        // Only the ends of the rim edges, those with a face either side of w, can be corners of
+        // the outline
+        std::array<char, MaxVerts> onRim{};
+        for (int k = 0; k < m_nEdges; ++k) {
+            if (m_edgeNormalsA[k].dotProduct(w)*m_edgeNormalsB[k].dotProduct(w) <= 0.0) {
+                onRim[m_edgeVertices[k]] = 1;
+                onRim[m_edgeEnds[k]] = 1;
+            }
+        }
+        std::array<double, MaxVerts> xs;
+        std::array<double, MaxVerts> ys;
+        std::array<int, MaxVerts> order;
+        int nRim = 0;
+        for (int i = 0; i < m_nVerts; ++i) {
+            if (!onRim[i]) {
+                continue;
+            }
+            xs[i] = m_points[i].dotProduct(u);
+            ys[i] = m_points[i].dotProduct(v);
+
+            // Insertion sort by (x, y), cheaper than std::sort at this size
+            int k = nRim++;
+            while (k > 0 && (
+                xs[order[k - 1]] > xs[i] || (xs[order[k - 1]] == xs[i] && ys[order[k - 1]] > ys[i])
+            )) {
+                order[k] = order[k - 1];
+                --k;
+            }
+            order[k] = i;
+        }
+
+        // Andrew's monotone chain, counter-clockwise, collinear points dropped
+        std::array<int, MaxVerts + 1> hull;
+        const auto cross = [&](int o, int a, int b) {
+            return (xs[a] - xs[o])*(ys[b] - ys[o]) - (ys[a] - ys[o])*(xs[b] - xs[o]);
+        };
+        int h = 0;
+        for (int k = 0; k < nRim; ++k) {
+            while (h >= 2 && cross(hull[h - 2], hull[h - 1], order[k]) <= 0.0) {
+                --h;
+            }
+            hull[h++] = order[k];
+        }
+        for (int k = nRim - 2, lower = h + 1; k >= 0; --k) {
+            while (h >= lower && cross(hull[h - 2], hull[h - 1], order[k]) <= 0.0) {
+                --h;
+            }
+            hull[h++] = order[k];
+        }
+        --h;
+        if (h < 3) {
+            return great;
+        }
+
+        // The rectangle holds the outline
+        double outline = 0.0;
+        for (int k = 0; k < h; ++k) {
+            outline += cross(hull[0], hull[k], hull[k + 1]);
+        }
+        if (0.5*outline*depth >= bestVolume) {
+            return great;
+        }
+
+        // Rotating calipers, the rectangle flush with each hull edge in turn.  right, far and left
+        // are the supports along the edge, normal to it and against it, each only moves forward.
+        std::array<double, MaxVerts + 1> hxs;
+        std::array<double, MaxVerts + 1> hys;
+        for (int k = 0; k < h; ++k) {
+            hxs[k] = xs[hull[k]];
+            hys[k] = ys[hull[k]];
+        }
+        const auto wrap = [h](int k) {
+            while (k >= h) {
+                k -= h;
+            }
+            return k;
+        };
+        const auto px = [&](int k) { return hxs[wrap(k)]; };
+        const auto py = [&](int k) { return hys[wrap(k)]; };
+        double bestArea = great;
+        int right = 1;
+        int far = 1;
+        int left = 1;
+        for (int i = 0; i < h; ++i) {
+            double ex = px(i + 1) - px(i);
+            double ey = py(i + 1) - py(i);
+            const double len = std::sqrt(ex*ex + ey*ey);
+            ex /= len;
+            ey /= len;
+            const auto along = [&](int k) { return (px(k) - px(i))*ex + (py(k) - py(i))*ey; };
+            // Inward, the hull is counter-clockwise
+            const auto normal = [&](int k) { return (py(k) - py(i))*ex - (px(k) - px(i))*ey; };
+            right = std::max(right, i + 1);
+            for (int n = 0; n < h && along(right + 1) > along(right); ++n) {
+                ++right;
+            }
+            far = std::max(far, right);
+            for (int n = 0; n < h && normal(far + 1) >= normal(far); ++n) {
+                ++far;
+            }
+            left = std::max(left, far);
+            for (int n = 0; n < h && along(left + 1) < along(left); ++n) {
+                ++left;
+            }
+            const double area = (along(right) - along(left))*normal(far);
+            if (area < bestArea) {
+                bestArea = area;
+                uOut = u*ex + v*ey;
+            }
+        }
+        return bestArea*depth;
+    }
+
+
+    // Frame of edge pair (k, l) at angle t along the normal arc of edge k: the first face normal,
+    // and the second at right angles to it and to edge l.  False if edge l is along that normal.
+    bool edgePairFrame(int k, int l, double t, Vector3& aOut, Vector3& bOut) const {
+        aOut = m_edgeNormalsA[k]*std::cos(t) + m_edgeTangents[k]*std::sin(t);
+        bOut = aOut.crossProduct(m_edges[l]);
+        const double mag = bOut.mag();
+        if (mag < 1e-9) {
+            return false;
+        }
+        bOut /= mag;
+        return true;
+    }
+
+    // Intervals of t in [0, arc of edge k] where edge pair (k, l) has a frame, the second face
+    // normal on the normal arc of edge l (or of its opposite).  That normal is a(t) x edge l, so
+    // it lies between the arc's end normals nA and nB exactly when (nA.a)(nB.a) <= 0, a product
+    // of two sinusoids n.nA cos t + n.tangent sin t.  Each has at most one zero inside the arc
+    // (arc < pi) and only then is its angle needed; membership of the pieces between the zeros
+    // is the sign of the product at their middle direction, so no other trig is done.
+    // Returns the number of intervals.
+    int feasibleIntervals(
+        int k,
+        int l,
+        std::array<double, 3>& losOut,
+        std::array<double, 3>& hisOut
+    ) const {
+        const double halfCos = m_edgeHalfArcCosines[k];
+        const double halfSin = m_edgeHalfArcSines[k];
+        const double cosArc = halfCos*halfCos - halfSin*halfSin;
+        const double sinArc = 2.0*halfCos*halfSin;
+        const std::array<double, 2> cs = {
+            m_edgeNormalsA[l].dotProduct(m_edgeNormalsA[k]),
+            m_edgeNormalsB[l].dotProduct(m_edgeNormalsA[k])
+        };
+        const std::array<double, 2> ss = {
+            m_edgeNormalsA[l].dotProduct(m_edgeTangents[k]),
+            m_edgeNormalsB[l].dotProduct(m_edgeTangents[k])
+        };
+
+        // Cuts in increasing t with their directions (cos t, sin t), kept unnormalised
+        std::array<double, 4> cuts;
+        std::array<double, 4> cutCos;
+        std::array<double, 4> cutSin;
+        int nCuts = 0;
+        cuts[nCuts] = 0.0;
+        cutCos[nCuts] = 1.0;
+        cutSin[nCuts++] = 0.0;
+        for (int i = 0; i < 2; ++i) {
+            const double start = cs[i];
+            const double end = cs[i]*cosArc + ss[i]*sinArc;
+            if (!((start < 0.0 && end > 0.0) || (start > 0.0 && end < 0.0))) {
+                continue;
+            }
+            // Zero direction (-s, c) or (s, -c), whichever has sin t > 0
+            const double x = (cs[i] > 0.0) ? -ss[i] : ss[i];
+            const double y = std::fabs(cs[i]);
+            const double root = std::atan2(y, x);
+            int at = nCuts;
+            for (; at > 1 && cuts[at - 1] > root; --at) {
+                cuts[at] = cuts[at - 1];
+                cutCos[at] = cutCos[at - 1];
+                cutSin[at] = cutSin[at - 1];
+            }
+            cuts[at] = root;
+            cutCos[at] = x;
+            cutSin[at] = y;
+            ++nCuts;
+        }
+        cuts[nCuts] = m_edgeArcs[k];
+        cutCos[nCuts] = cosArc;
+        cutSin[nCuts++] = sinArc;
+
+        int nIntervals = 0;
+        for (int c = 0; c + 1 < nCuts; ++c) {
+            // Middle direction of the piece, the pieces being shorter than pi
+            const double r0 = std::sqrt(cutCos[c]*cutCos[c] + cutSin[c]*cutSin[c]);
+            const double r1 = std::sqrt(cutCos[c + 1]*cutCos[c + 1] + cutSin[c + 1]*cutSin[c + 1]);
+            const double x = cutCos[c]*r1 + cutCos[c + 1]*r0;
+            const double y = cutSin[c]*r1 + cutSin[c + 1]*r0;
+            if ((cs[0]*x + ss[0]*y)*(cs[1]*x + ss[1]*y) > 0.0) {
+                continue;
+            }
+            if (nIntervals > 0 && hisOut[nIntervals - 1] == cuts[c]) {
+                hisOut[nIntervals - 1] = cuts[c + 1];
+            } else {
+                losOut[nIntervals] = cuts[c];
+                hisOut[nIntervals] = cuts[c + 1];
+                ++nIntervals;
+            }
+        }
+        return nIntervals;
+    }
+
+    // Value of the polynomial c[0] + c[1] x + ... + c[degree] x^degree
+    static double polyValue(const double* c, int degree, double x) {
+        double value = c[degree];
+        for (int i = degree - 1; i >= 0; --i) {
+            value = value*x + c[i];
+        }
+        return value;
+    }
+
+    // Bernstein coefficients on [lo, hi] of the polynomial c of degree at most 6
+    static void bernstein(const double* c, int degree, double lo, double hi, double* bernOut) {
+        static constexpr double binomials[7][7] = {
+            {1, 0, 0, 0, 0, 0, 0},
+            {1, 1, 0, 0, 0, 0, 0},
+            {1, 2, 1, 0, 0, 0, 0},
+            {1, 3, 3, 1, 0, 0, 0},
+            {1, 4, 6, 4, 1, 0, 0},
+            {1, 5, 10, 10, 5, 1, 0},
+            {1, 6, 15, 20, 15, 6, 1}
+        };
+
+        // Power coefficients in u, x = lo + (hi - lo) u
+        std::array<double, 7> shifted{};
+        for (int i = 0; i <= degree; ++i) {
+            shifted[i] = c[i];
+        }
+        for (int i = 0; i < degree; ++i) {
+            for (int j = degree - 1; j >= i; --j) {
+                shifted[j] += lo*shifted[j + 1];
+            }
+        }
+        double scale = 1.0;
+        for (int j = 0; j <= degree; ++j) {
+            shifted[j] *= scale;
+            scale *= hi - lo;
+        }
+        for (int i = 0; i <= degree; ++i) {
+            bernOut[i] = 0.0;
+            for (int j = 0; j <= i; ++j) {
+                bernOut[i] += binomials[i][j]/binomials[degree][j]*shifted[j];
+            }
+        }
+    }
+
+    // Root of the polynomial c, with derivative dc, in [a, b] where it changes sign once.  Newton
+    // steps are kept inside the bracket; Newton converges from one side, so they stop on the step
+    // rather than the bracket.
+    static double polyRoot(const double* c, const double* dc, int degree, double a, double b) {
+        const bool rising = polyValue(c, degree, b) > 0.0;
+        double x = 0.5*(a + b);
+        double step = b - a;
+        for (int iter = 0; iter < 60 && step > 1e-14*(1.0 + std::fabs(x)); ++iter) {
+            const double f = polyValue(c, degree, x);
+            if (f == 0.0) {
+                break;
+            }
+            if ((f > 0.0) == rising) {
+                b = x;
+            } else {
+                a = x;
+            }
+            const double slope = polyValue(dc, degree - 1, x);
+            const double newton = slope != 0.0 ? x - f/slope : a;
+            const double next = newton > a && newton < b ? newton : 0.5*(a + b);
+            step = std::fabs(next - x);
+            x = next;
+        }
+        return x;
+    }
+
+    // Real roots in [lo, hi] of the polynomial c of degree at most 6, ascending.  The sign
+    // changes of its Bernstein coefficients on an interval are at least its roots there, of the
+    // same parity: none means no root, one means one root, found by Newton steps.  Otherwise the
+    // interval is halved by de Casteljau's algorithm, until the roots are isolated or closer
+    // than can be told apart.  Returns the number of roots.
+    static int polyRoots(const double* c, int degree, double lo, double hi, double* rootsOut) {
+        while (degree > 0 && c[degree] == 0.0) {
+            --degree;
+        }
+        if (degree == 0) {
+            return 0;
+        }
+        if (degree == 1) {
+            const double root = -c[0]/c[1];
+            rootsOut[0] = root;
+            return root >= lo && root <= hi ? 1 : 0;
+        }
+        std::array<double, 6> derivative{};
+        for (int i = 1; i <= degree; ++i) {
+            derivative[i - 1] = i*c[i];
+        }
+
+        // Pieces awaiting isolation, right half pushed first so roots come out ascending
+        struct Piece {
+            std::array<double, 7> m_bern;
+            double m_lo;
+            double m_hi;
+        };
+        std::array<Piece, 32> pieces;
+        int nPieces = 1;
+        bernstein(c, degree, lo, hi, pieces[0].m_bern.data());
+        pieces[0].m_lo = lo;
+        pieces[0].m_hi = hi;
+        int nRoots = 0;
+        while (nPieces > 0) {
+            const Piece piece = pieces[--nPieces];
+            int nChanges = 0;
+            double last = 0.0;
+            for (int i = 0; i <= degree; ++i) {
+                const double coeff = piece.m_bern[i];
+                nChanges += (last < 0.0 && coeff > 0.0) || (last > 0.0 && coeff < 0.0);
+                last = coeff != 0.0 ? coeff : last;
+            }
+            const double fLo = piece.m_bern[0];
+            const double fHi = piece.m_bern[degree];
+            if (nChanges == 0) {
+                if (fLo == 0.0) {
+                    rootsOut[nRoots++] = piece.m_lo;
+                }
+                continue;
+            }
+            if (nChanges == 1 && fLo*fHi < 0.0) {
+                rootsOut[nRoots++] = polyRoot(c, derivative.data(), degree, piece.m_lo, piece.m_hi);
+                continue;
+            }
+            const double mid = 0.5*(piece.m_lo + piece.m_hi);
+            if (
+                nPieces + 2 > static_cast<int>(pieces.size())
+             || piece.m_hi - piece.m_lo < 1e-12*(1.0 + std::fabs(mid))
+            ) {
+                rootsOut[nRoots++] = mid;
+                continue;
+            }
+
+            // de Casteljau at the midpoint: the left half's coefficients are the first of each
+            // row of averages, the right half's the last
+            std::array<double, 7> row(piece.m_bern);
+            Piece& right = pieces[nPieces++];
+            Piece& left = pieces[nPieces++];
+            left.m_bern[0] = row[0];
+            right.m_bern[degree] = row[degree];
+            for (int r = 1; r <= degree; ++r) {
+                for (int i = 0; i <= degree - r; ++i) {
+                    row[i] = 0.5*(row[i] + row[i + 1]);
+                }
+                left.m_bern[r] = row[0];
+                right.m_bern[degree - r] = row[degree - r];
+            }
+            left.m_lo = piece.m_lo;
+            left.m_hi = mid;
+            right.m_lo = mid;
+            right.m_hi = piece.m_hi;
+        }
+        return nRoots;
+    }
+
+    // Coefficients ascending of the product of polynomials p (degree m) and q (degree n)
+    static void polyMultiply(const double* p, int m, const double* q, int n, double* productOut) {
+        for (int i = 0; i <= m + n; ++i) {
+            productOut[i] = 0.0;
+        }
+        for (int i = 0; i <= m; ++i) {
+            for (int j = 0; j <= n; ++j) {
+                productOut[i + j] += p[i]*q[j];
+            }
+        }
+    }
+
+    // Search the family of edge pair (k, l) for t in [lo, hi], improving on bestVolumeInOut
+    void searchEdgePair(
+        // outputs
+        double& bestVolumeInOut,
+        Vector3& bestWInOut,
+        Vector3& bestUInOut,
+        int& nCandidatesInOut,
+
+        // inputs
+        int k,
+        int l,
+        double lo,
+        double hi
+    ) const {
+        const Vector3& e = m_edges[l];
+        const auto measure = [&](double t, Vector3& aOut, Vector3& bOut, Supports& supOut) {
+            if (!edgePairFrame(k, l, t, aOut, bOut)) {
+                return false;
+            }
+            frameSupports(k, l, aOut, bOut, aOut.crossProduct(bOut), supOut);
+            ++nCandidatesInOut;
+            if (supOut.volume() < bestVolumeInOut) {
+                bestVolumeInOut = supOut.volume();
+                bestWInOut = aOut.crossProduct(bOut);
+                bestUInOut = aOut;
+            }
+            return true;
+        };
+
+        // The whole interval first holds the edge pair's own vertices, and is mostly pruned on
+        // those alone.  Otherwise it is measured at its centre and holds the extremes found, as
+        // do the pieces it splits into.
+        std::array<double, 2*maxPending> pending;
+        int nPending = 0;
+        pending[nPending++] = lo;
+        pending[nPending++] = hi;
+        bool whole = true;
+        while (nPending > 0) {
+            hi = pending[--nPending];
+            lo = pending[--nPending];
+            const double tm = 0.5*(lo + hi);
+            const double h = 0.5*(hi - lo);
+            const bool canSplit = h > 1e-12 && nPending + 4 <= 2*maxPending;
+            Vector3 a;
+            Vector3 b;
+            Supports sup;
+            const bool guessed = whole;
+            bool framed = false;
+            if (whole) {
+                whole = false;
+                framed = edgePairFrame(k, l, tm, a, b);
+                if (framed) {
+                    edgePairSupports(k, l, a, b, a.crossProduct(b), sup);
+                }
+            } else {
+                framed = measure(tm, a, b, sup);
+            }
+            if (!framed) {
+                if (canSplit) {
+                    pending[nPending++] = lo;
+                    pending[nPending++] = tm;
+                    pending[nPending++] = tm;
+                    pending[nPending++] = hi;
+                }
+                continue;
+            }
+
+            // Cheap bound: over the interval a turns by at most h, b by at most h/|a x e| and
+            // c = a x b by their sum.  A held width is D cos(angle between the axis and the held
+            // difference D), so turning by phi leaves at least w cos phi - sqrt(D^2 - w^2) sin phi.
+            const Vector3 d1(vertex(sup.m_hi[0]) - vertex(sup.m_lo[0]));
+            const Vector3 d2(vertex(sup.m_hi[1]) - vertex(sup.m_lo[1]));
+            const Vector3 d3(vertex(sup.m_hi[2]) - vertex(sup.m_lo[2]));
+            const double sinAE = a.crossProduct(e).mag();
+            if (sinAE > h) {
+                const double turnB = h/(sinAE - h);
+                const double turns[3] = {h, turnB, h + turnB};
+                const double squares[3] = {d1.magSqr(), d2.magSqr(), d3.magSqr()};
+                double bound = 1.0;
+                for (int d = 0; d < 3; ++d) {
+                    const double w = sup.m_widths[d];
+                    const double phi = turns[d];
+                    const double across = std::sqrt(std::max(0.0, squares[d] - w*w));
+                    bound *= std::max(0.0, w*(1.0 - 0.5*phi*phi) - across*phi);
+                }
+                if (bound >= bestVolumeInOut) {
+                    continue;
+                }
+            }
+
+            // Volume with the extreme vertices of the centre frame held, in x = tan(t - tm):
+            // a ~ r + x s, and with E, L1, L2, D3 linear in x, widths
+            //  along a:     L1/|a~|                     L1 = (r + x s).d1
+            //  along b:     L2/|a~ x e|                 L2 = (r + x s).(e x d2)
+            //  along c:     (E D3 - g (1 + x^2))/(|a~| |a~ x e|), E = (r + x s).e, g = e.d3
+            // so volume = L1 L2 (E D3 - g (1 + x^2))/((1 + x^2)(1 + x^2 - E^2)) = N/M
+            const Vector3 r(a);
+            const Vector3 s(
+                m_edgeTangents[k]*std::cos(tm) - m_edgeNormalsA[k]*std::sin(tm)
+            );
+            const Vector3 g2(e.crossProduct(d2));
+            const double g3 = e.dotProduct(d3);
+            const double l1[2] = {d1.dotProduct(r), d1.dotProduct(s)};
+            const double l2[2] = {g2.dotProduct(r), g2.dotProduct(s)};
+            const double ee[2] = {e.dotProduct(r), e.dotProduct(s)};
+            const double q[3] = {
+                ee[0]*d3.dotProduct(r) - g3,
+                ee[0]*d3.dotProduct(s) + ee[1]*d3.dotProduct(r),
+                ee[1]*d3.dotProduct(s) - g3
+            };
+            const double xr = std::tan(h);
+
+            // Held widths stay positive across the interval, or they bound nothing
+            const auto positive = [&](const double* p, int degree) {
+                if (polyValue(p, degree, -xr) <= 0.0 || polyValue(p, degree, xr) <= 0.0) {
+                    return false;
+                }
+                if (degree == 2 && p[2] > 0.0) {
+                    const double vertexX = -0.5*p[1]/p[2];
+                    return vertexX <= -xr || vertexX >= xr || polyValue(p, 2, vertexX) > 0.0;
+                }
+                return true;
+            };
+            if (!positive(l1, 1) || !positive(l2, 1) || !positive(q, 2)) {
+                if (guessed) {
+                    pending[nPending++] = lo;
+                    pending[nPending++] = hi;
+                } else if (canSplit) {
+                    pending[nPending++] = lo;
+                    pending[nPending++] = tm;
+                    pending[nPending++] = tm;
+                    pending[nPending++] = hi;
+                }
+                continue;
+            }
+            const double side[3] = {1.0 - ee[0]*ee[0], -2.0*ee[0]*ee[1], 1.0 - ee[1]*ee[1]};
+
+            // Cheaper bound, the least of each held width on its own.  Along a the width is a
+            // positive sinusoid in t, least at an end.  Along b the slope's numerator is linear.
+            // Along c, the least of the numerator over the largest of the denominator.
+            const auto least = [&](double lead, double x) {
+                return x > -xr && x < xr ? std::min(lead, polyValue(q, 2, x)) : lead;
+            };
+            const auto widthB = [&](double x) {
+                return polyValue(l2, 1, x)/std::sqrt(polyValue(side, 2, x));
+            };
+            const double slopeB[2] = {
+                l2[1]*side[0] - 0.5*l2[0]*side[1], 0.5*l2[1]*side[1] - l2[0]*side[2]
+            };
+            double minB = std::min(widthB(-xr), widthB(xr));
+            if (slopeB[1] != 0.0 && std::fabs(slopeB[0]) < xr*std::fabs(slopeB[1])) {
+                minB = std::min(minB, widthB(-slopeB[0]/slopeB[1]));
+            }
+            double maxSide = std::max(polyValue(side, 2, -xr), polyValue(side, 2, xr));
+            if (side[2] < 0.0 && std::fabs(side[1]) < 2.0*xr*std::fabs(side[2])) {
+                maxSide = std::max(maxSide, polyValue(side, 2, -0.5*side[1]/side[2]));
+            }
+            const double minQ = least(
+                std::min(polyValue(q, 2, -xr), polyValue(q, 2, xr)),
+                q[2] > 0.0 ? -0.5*q[1]/q[2] : xr
+            );
+            const double split =
+                std::min(polyValue(l1, 1, -xr), polyValue(l1, 1, xr))/std::sqrt(1.0 + xr*xr)
+               *minB*minQ/std::sqrt((1.0 + xr*xr)*maxSide);
+            if (split >= bestVolumeInOut) {
+                continue;
+            }
+
+            std::array<double, 3> l12;
+            std::array<double, 5> n;
+            polyMultiply(l1, 1, l2, 1, l12.data());
+            polyMultiply(l12.data(), 2, q, 2, n.data());
+            const double one[3] = {1.0, 0.0, 1.0};
+            std::array<double, 5> m;
+            polyMultiply(one, 2, side, 2, m.data());
+
+            // With the denominator's Bernstein coefficients positive, N/M is at least the least
+            // ratio of their coefficients, which prunes most intervals without the roots below
+            std::array<double, 5> bernN;
+            std::array<double, 5> bernM;
+            bernstein(n.data(), 4, -xr, xr, bernN.data());
+            bernstein(m.data(), 4, -xr, xr, bernM.data());
+            double ratio = std::numeric_limits<double>::infinity();
+            for (int i = 0; i <= 4 && ratio >= bestVolumeInOut; ++i) {
+                ratio = bernM[i] > 0.0 ? std::min(ratio, bernN[i]/bernM[i]) : 0.0;
+            }
+            if (ratio >= bestVolumeInOut) {
+                continue;
+            }
+
+            // Stationary points: roots of N'M - NM', whose x^7 terms cancel
+            std::array<double, 4> dn;
+            std::array<double, 4> dm;
+            for (int i = 1; i <= 4; ++i) {
+                dn[i - 1] = i*n[i];
+                dm[i - 1] = i*m[i];
+            }
+            std::array<double, 8> slope;
+            std::array<double, 8> other;
+            polyMultiply(dn.data(), 3, m.data(), 4, slope.data());
+            polyMultiply(n.data(), 4, dm.data(), 3, other.data());
+            for (int i = 0; i < 7; ++i) {
+                slope[i] -= other[i];
+            }
+            std::array<double, 8> xs;
+            int nXs = polyRoots(slope.data(), 6, -xr, xr, xs.data());
+            xs[nXs++] = -xr;
+            xs[nXs++] = xr;
+            double bound = std::numeric_limits<double>::infinity();
+            double xBest = 0.0;
+            for (int i = 0; i < nXs; ++i) {
+                const double value = polyValue(n.data(), 4, xs[i])/polyValue(m.data(), 4, xs[i]);
+                if (value < bound) {
+                    bound = value;
+                    xBest = xs[i];
+                }
+            }
+            if (bound >= bestVolumeInOut) {
+                continue;
+            }
+            if (guessed) {
+                pending[nPending++] = lo;
+                pending[nPending++] = hi;
+                continue;
+            }
+
+            // Measure the box at the bound's minimum, solved if it meets the bound
+            const double tBest = tm + std::atan(xBest);
+            Vector3 aBest;
+            Vector3 bBest;
+            Supports supBest;
+            if (
+                !measure(tBest, aBest, bBest, supBest)
+             || supBest.volume() <= bound*(1.0 + solvedGap)
+             || !canSplit
+            ) {
+                continue;
+            }
+
+            // Split where a held vertex gives way, between the centre and the minimum: where the
+            // held and the new extreme project equally on the axis
+            double xSplit = 0.5*xBest;
+            for (int d = 0; d < 3; ++d) {
+                for (const bool hiSide : {true, false}) {
+                    const int held = hiSide ? sup.m_hi[d] : sup.m_lo[d];
+                    const int found = hiSide ? supBest.m_hi[d] : supBest.m_lo[d];
+                    if (held == found) {
+                        continue;
+                    }
+                    const Vector3 dv(vertex(found) - vertex(held));
+                    double root[2];
+                    int nRoot = 0;
+                    if (d == 0) {
+                        const double p[2] = {dv.dotProduct(r), dv.dotProduct(s)};
+                        nRoot = polyRoots(p, 1, -xr, xr, root);
+                    } else if (d == 1) {
+                        const Vector3 ev(e.crossProduct(dv));
+                        const double p[2] = {ev.dotProduct(r), ev.dotProduct(s)};
+                        nRoot = polyRoots(p, 1, -xr, xr, root);
+                    } else {
+                        const double ge = e.dotProduct(dv);
+                        const double pr = dv.dotProduct(r);
+                        const double ps = dv.dotProduct(s);
+                        const double p[3] = {
+                            ee[0]*pr - ge, ee[0]*ps + ee[1]*pr, ee[1]*ps - ge
+                        };
+                        nRoot = polyRoots(p, 2, -xr, xr, root);
+                    }
+                    for (int i = 0; i < nRoot; ++i) {
+                        if (std::min(0.0, xBest) < root[i] && root[i] < std::max(0.0, xBest)) {
+                            xSplit = root[i];
+                        }
+                    }
+                }
+            }
+            const double tSplit = std::max(lo, std::min(hi, tm + std::atan(xSplit)));
+            if (tSplit <= lo || tSplit >= hi) {
+                continue;
+            }
+            pending[nPending++] = lo;
+            pending[nPending++] = tSplit;
+            pending[nPending++] = tSplit;
+            pending[nPending++] = hi;
+        }
+    }
+
+public:
+
+    // Largest hull handled
+    static const int maxVerts = MaxVerts;
+
+    // Construct null
+    SmallHullSolver():
+        m_field(nullptr),
+        m_nVerts(0),
+        m_radius(0.0),
+        m_nEdges(0),
+        m_minWidth(0.0),
+        m_nFaces(0)
+    {}
+
+    // Construct from a hull graph, empty (and unusable) if it has more than MaxVerts vertices.
+    // The graph must outlive the solver.
+    explicit SmallHullSolver(const ConvexHullGraph& graph):
+        m_field(&graph.points()),
+        m_nVerts(0),
+        m_radius(0.0),
+        m_nEdges(0),
+        m_minWidth(0.0),
+        m_nFaces(0)
+    {
+        if (graph.empty() || graph.size() > MaxVerts) {
+            return;
+        }
+        m_nVerts = static_cast<int>(graph.size());
+        Vector3 centre(0.0, 0.0, 0.0);
+        for (int i = 0; i < m_nVerts; ++i) {
+            m_points[i] = graph.points()[i];
+            centre += m_points[i];
+        }
+        centre /= m_nVerts;
+        for (int i = 0; i < MaxVerts; ++i) {
+            const Vector3 pt(m_points[i < m_nVerts ? i : 0] - centre);
+            m_xs[i] = pt.x();
+            m_ys[i] = pt.y();
+            m_zs[i] = pt.z();
+            m_radius = std::max(m_radius, pt.mag());
+        }
+
+        // Faces are triangles of mutually adjacent vertices with the hull on one side, each edge
+        // has two.  A face is recorded once, from its edge of the two lowest vertex indices.
+        std::array<char, MaxVerts> adjacent;
+        for (int i = 0; i < m_nVerts; ++i) {
+            adjacent.fill(0);
+            const index_t* nbEnd = graph.neighboursEnd(i);
+            for (const index_t* nb = graph.neighboursBegin(i); nb != nbEnd; ++nb) {
+                adjacent[*nb] = 1;
+            }
+            for (const index_t* nb = graph.neighboursBegin(i); nb != nbEnd; ++nb) {
+                const int j = static_cast<int>(*nb);
+                if (j <= i || m_nEdges >= 3*MaxVerts) {
+                    continue;
+                }
+                Vector3 e(m_points[j] - m_points[i]);
+                if (!e.normalise()) {
+                    continue;
+                }
+                int nSides = 0;
+                Vector3 sides[2];
+                const index_t* nbjEnd = graph.neighboursEnd(j);
+                for (const index_t* nbj = graph.neighboursBegin(j); nbj != nbjEnd; ++nbj) {
+                    const int k = static_cast<int>(*nbj);
+                    Vector3 normal;
+                    if (!adjacent[k] || !faceNormal(i, j, k, normal)) {
+                        continue;
+                    }
+                    if (k > j && m_nFaces < 2*MaxVerts) {
+                        m_faceNormals[m_nFaces++] = normal;
+                    }
+                    if (nSides < 2) {
+                        sides[nSides++] = normal;
+                    }
+                }
+                if (nSides < 2 || sides[0].dotProduct(sides[1]) > 1.0 - 1e-12) {
+                    // Not a crease, the edge splits a coplanar face
+                    continue;
+                }
+                Vector3 tangent(e.crossProduct(sides[0]));
+                if (tangent.dotProduct(sides[1]) < 0.0) {
+                    tangent *= -1.0;
+                }
+                const double cosArc = std::max(-1.0, std::min(1.0, sides[0].dotProduct(sides[1])));
+                const double sinArc = tangent.dotProduct(sides[1]);
+
+                // Width along a(t) = nA cos t + tangent sin t, with the edge extreme, is the
+                // largest of a(t).(p_i - p_m) over the vertices m.  Each term is a sinusoid, least
+                // at an end of the arc unless its trough, along -(p_i - p_m), is on the arc.
+                const Vector3 pi(vertex(i));
+                double minWidth = 0.0;
+                for (int m = 0; m < m_nVerts; ++m) {
+                    const Vector3 q(pi - vertex(m));
+                    const double qa = q.dotProduct(sides[0]);
+                    const double qt = q.dotProduct(tangent);
+                    double least = std::min(qa, qa*cosArc + qt*sinArc);
+                    if (-qt >= 0.0 && qt*cosArc - qa*sinArc >= 0.0) {
+                        least = -std::sqrt(qa*qa + qt*qt);
+                    }
+                    minWidth = std::max(minWidth, least);
+                }
+
+                m_edges[m_nEdges] = e;
+                m_edgeNormalsA[m_nEdges] = sides[0];
+                m_edgeNormalsB[m_nEdges] = sides[1];
+                m_edgeTangents[m_nEdges] = tangent;
+                m_edgeArcs[m_nEdges] = std::acos(cosArc);
+                m_edgeMinWidths[m_nEdges] = minWidth;
+                m_edgeMids[m_nEdges] = sides[0] + sides[1];
+                m_edgeMids[m_nEdges].normalise();
+                m_edgeHalfArcCosines[m_nEdges] = std::sqrt(0.5*(1.0 + cosArc));
+                m_edgeHalfArcSines[m_nEdges] = std::sqrt(0.5*(1.0 - cosArc));
+                m_edgeVertices[m_nEdges] = i;
+                m_edgeEnds[m_nEdges] = j;
+                const Vector3 mid(m_edgeMids[m_nEdges]);
+                int antipode = 0;
+                double least = mid.dotProduct(vertex(0));
+                for (int m = 1; m < MaxVerts; ++m) {
+                    const double p = m_xs[m]*mid.x() + m_ys[m]*mid.y() + m_zs[m]*mid.z();
+                    antipode = p < least ? m : antipode;
+                    least = p < least ? p : least;
+                }
+                m_edgeAntipodes[m_nEdges] = antipode;
+                ++m_nEdges;
+            }
+        }
+        m_minWidth = std::numeric_limits<double>::infinity();
+        for (int k = 0; k < m_nEdges; ++k) {
+            m_minWidth = std::min(m_minWidth, m_edgeMinWidths[k]);
+        }
+
+    }
+
+
+    // Accessors
+
+    bool empty() const { return m_nVerts == 0; }
+    int size() const { return m_nVerts; }
+    int nEdges() const { return m_nEdges; }
+    int nFaces() const { return m_nFaces; }
+
+
+    // Solve
+
+    // Minimum-volume box, measured with BoundBoxTools::evaluateFrame.  nCandidatesOut, if given,
+    // receives the number of box volumes evaluated.
+    OrientedBoundBox solve(int* nCandidatesOut=nullptr) const {
+        double bestVolume = std::numeric_limits<double>::infinity();
+        Vector3 bestW;
+        Vector3 bestU;
+        int nCandidates = 0;
+
+        // Face-flush, the incumbent for pruning the edge pairs
+        for (int f = 0; f < m_nFaces; ++f) {
+            Vector3 u;
+            const double volume = evaluate(m_faceNormals[f], bestVolume, u);
+            ++nCandidates;
+            if (volume < bestVolume) {
+                bestVolume = volume;
+                bestW = m_faceNormals[f];
+                bestU = u;
+            }
+        }
+
+        // Edge-pair
+        for (int k = 0; k < m_nEdges; ++k) {
+            // The pair (k, l) spans the same frames as (l, k), only l > k is searched
+            const double cosK = m_edgeHalfArcCosines[k];
+            const double sinK = m_edgeHalfArcSines[k];
+            for (int l = k + 1; l < m_nEdges; ++l) {
+                // The widths along a and b are at least those of their arcs, and along c at
+                // least the hull's least width.  b is on the arc of edge l, or its opposite.
+                if (m_edgeMinWidths[k]*m_edgeMinWidths[l]*m_minWidth >= bestVolume) {
+                    continue;
+                }
+
+                // Normals on the two arcs can only be at right angles if the arc midpoints are
+                // within the sum of the half arcs of it, by the sum-of-angles formulae
+                const double cosL = m_edgeHalfArcCosines[l];
+                const double sinL = m_edgeHalfArcSines[l];
+                if (
+                    cosK*cosL - sinK*sinL > 0.0
+                 && std::fabs(m_edgeMids[k].dotProduct(m_edgeMids[l])) > sinK*cosL + cosK*sinL
+                ) {
+                    continue;
+                }
+
+                std::array<double, 3> los;
+                std::array<double, 3> his;
+                const int nIntervals = feasibleIntervals(k, l, los, his);
+                for (int iv = 0; iv < nIntervals; ++iv) {
+                    searchEdgePair(bestVolume, bestW, bestU, nCandidates, k, l, los[iv], his[iv]);
+                }
+            }
+        }
+        if (nCandidatesOut) {
+            *nCandidatesOut = nCandidates;
+        }
+        if (bestVolume == std::numeric_limits<double>::infinity()) {
+            return OrientedBoundBox();
+        }
+        return BoundBoxTools::evaluateFrame(*m_field, bestW, bestU);
+    }
+
+};
+
+} // end namespace gaden
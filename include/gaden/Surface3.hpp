@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "gaden/Field.hpp"
+#include "gaden/Lattice.hpp"
 #include "gaden/PointCloudTools.hpp"
 #include "gaden/Tools.hpp"
 #include "gaden/VectorNField.hpp"
@@ -13,19 +14,40 @@ namespace gaden {
 // for a supplied CSV file format, with header:
 //  Face #,Point X,Point Y,Point Z,Normal X,Normal Y,Normal Z
 // Read will optionally, on-the-fly merge points based on user-supplied epsilon value.
+// A file may hold many parts, with a leading integer part id column:
+//  Part,Face #,Point X,Point Y,Point Z,Normal X,Normal Y,Normal Z
+// Rows are then grouped by part in one pass, in order of first appearance, merging only within
+// a part, and each part is a range of the point arrays (see partOffsets, extractPart).
+// Points may then be quantized onto an integer Lattice (see quantize), after which they are held
+// as lattice coordinates only.  Or they may be read in single precision (see singlePrecision),
+// halving the cloud's memory; merging and the 3d hull still measure in double.
 class Surface3: public ObjectBase {
 
     // Private data
-    IntField m_faceNumber;
+    IndexField m_faceNumber;
     Vector3Field m_points;
     Vector3Field m_normals;
 
+    // Part ids, and the range [m_partOffsets[i], m_partOffsets[i + 1]) of part i's points.  Empty
+    // when the file has no part column.
+    IndexField m_partIds;
+    IndexField m_partOffsets;
+
+    // Quantized points, replacing m_points once quantize() is called
+    Vector3iField m_latticePoints;
+    Lattice m_lattice;
+
+    // Points read in single precision, replacing m_points
+    Vector3fField m_singlePoints;
+    bool m_singlePrecision = false;
+
     // Private functions
 
     // Read new values, i.e. faceNumbers, points, normals
     //  If epsilon > 0, will skip any entries that are within that distance to a previously read
     //  point.
-    bool read(std::istream& is, double epsilon=0.0);
+    //  If singlePrecision, points are held in singlePoints() instead of points().
+    bool read(std::istream& is, double epsilon=0.0, bool singlePrecision=false);
 
 
 public:
@@ -35,26 +57,37 @@ public:
         ObjectBase(name == "" ? "Surface3" : name),
         m_faceNumber("Face"),
         m_points("Point"),
-        m_normals("Normal")
+        m_normals("Normal"),
+        m_partIds("Part"),
+        m_partOffsets("PartOffset"),
+        m_latticePoints("Point"),
+        m_singlePoints("Point")
     {}
 
     // Construct from stream
     //  epsilon enables point merging
     //  name is for ObjectBase
-    Surface3(std::istream& is, double epsilon=0.0, std::string name=""):
+    //  singlePrecision reads the points into singlePoints()
+    Surface3(
+        std::istream& is, double epsilon=0.0, std::string name="", bool singlePrecision=false
+    ):
         ObjectBase(name == "" ? "Surface3" : name),
         m_faceNumber("Face"),
         m_points("Point"),
-        m_normals("Normal")
+        m_normals("Normal"),
+        m_partIds("Part"),
+        m_partOffsets("PartOffset"),
+        m_latticePoints("Point"),
+        m_singlePoints("Point")
     {
-        read(is, epsilon);
+        read(is, epsilon, singlePrecision);
     }
 
 
     // Accessors
 
-    IntField& faceNumber() { return m_faceNumber; }
-    const IntField& faceNumber() const { return m_faceNumber; }
+    IndexField& faceNumber() { return m_faceNumber; }
+    const IndexField& faceNumber() const { return m_faceNumber; }
 
     Vector3Field& points() { return m_points; }
     const Vector3Field& points() const { return m_points; }
@@ -62,6 +95,28 @@ public:
     Vector3Field& normals() { return m_normals; }
     const Vector3Field& normals() const { return m_normals; }
 
+    Vector3iField& latticePoints() { return m_latticePoints; }
+    const Vector3iField& latticePoints() const { return m_latticePoints; }
+
+    const Lattice& lattice() const { return m_lattice; }
+
+    // True once points are held as lattice coordinates
+    bool quantized() const { return !m_latticePoints.empty(); }
+
+    Vector3fField& singlePoints() { return m_singlePoints; }
+    const Vector3fField& singlePoints() const { return m_singlePoints; }
+
+    // True if points were read in single precision, and are held in singlePoints()
+    bool singlePrecision() const { return m_singlePrecision; }
+
+    const IndexField& partIds() const { return m_partIds; }
+    const IndexField& partOffsets() const { return m_partOffsets; }
+
+    // Number of parts, 1 when the file has no part column
+    index_t nParts() const {
+        return m_partIds.empty() ? 1 : static_cast<index_t>(m_partIds.size());
+    }
+
 
     // Functionality
 
@@ -69,8 +124,23 @@ public:
         m_faceNumber.clear();
         m_points.clear();
         m_normals.clear();
+        m_partIds.clear();
+        m_partOffsets.clear();
+        m_latticePoints.clear();
+        m_singlePoints.clear();
+        m_singlePrecision = false;
     }
 
+    // Copy of part i (faces, points and normals) as a surface of its own
+    Surface3 extractPart(index_t i) const;
+
+    // Snap points onto a lattice fitted to their bound box, with spacing at least spacing (see
+    // Lattice::fit), and merge points that share a lattice point, keeping the first.  Face numbers
+    // and normals are kept for the remaining points.  Points are then held in latticePoints(),
+    // points() is emptied.  Returns the number of merged points.  For a single part, see
+    // extractPart.  Not for points read in single precision.
+    index_t quantize(double spacing);
+
 
     // I/O
 
@@ -86,8 +156,9 @@ public:
     // Streams
 
     friend std::ostream& operator<<(std::ostream& os, const Surface3& s) {
-        const IntField& f = s.faceNumber();
+        const IndexField& f = s.faceNumber();
         const Vector3Field& p = s.points();
+        const Vector3fField& sp = s.singlePoints();
         const Vector3Field& n = s.normals();
         int nElems = static_cast<int>(f.size());
         s.writeHeader(os);
@@ -95,7 +166,8 @@ public:
         os << e;
         char c = ',';
         for (int i = 0; i < nElems; ++i) {
-            os << f[i] << c << p[i].toCsv() << c << n[i].toCsv() << e;
+            const Vector3 pt(s.singlePrecision() ? Vector3(sp[i]) : p[i]);
+            os << f[i] << c << pt.toCsv() << c << n[i].toCsv() << e;
         }
         os << std::flush;
         return os;
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gaden {
+
+// Work-stealing thread pool.  Each worker has its own task deque: tasks submitted from a worker
+// go on its own deque and it runs its newest task first, idle workers steal the oldest task of
+// another.  Threads that wait (waitIdle, parallelFor) run queued tasks meanwhile, so tasks may
+// submit and wait on tasks of their own without deadlock.
+//
+// Tasks must not throw.
+class ThreadPool {
+
+    // A worker's task deque
+    struct Queue {
+        std::mutex m_mutex;
+        std::deque<std::function<void()>> m_tasks;
+    };
+
+
+    // Private data
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    // Tasks queued and not yet started, and submitted and not yet finished
+    std::atomic<int> m_nQueued;
+    std::atomic<int> m_nPending;
+
+    // Round-robin queue for tasks submitted from outside the pool
+    std::atomic<unsigned> m_nextQueue;
+
+    // Idle workers sleep on m_wake, and threads waiting for tasks to finish on m_done, counted by
+    // m_nWaiting.  Both are guarded by m_sleepMutex.
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    int m_nWaiting;
+    bool m_stop;
+
+
+    // Private member functions
+
+    // Body of worker thread i
+    void work(int i);
+
+    // Take a task, from the calling worker's own deque (newest first) or stolen from another
+    // (oldest first).  False if every deque is empty.
+    bool take(std::function<void()>& taskOut);
+
+    // Wake the threads waiting in waitUntil to test their condition again
+    void notifyDone();
+
+    // Return once done() holds, running queued tasks meanwhile and sleeping on m_done while there
+    // are none.  Whatever makes done() hold must call notifyDone after it.
+    template <class Done>
+    void waitUntil(Done&& done) {
+        while (!done()) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            ++m_nWaiting;
+            m_done.wait(lock, [this, &done]() { return done() || m_nQueued.load() > 0; });
+            --m_nWaiting;
+        }
+    }
+
+
+public:
+
+    // Construct with nThreads workers, <= 0 takes one per hardware thread
+    explicit ThreadPool(int nThreads=0);
+
+    // Finishes queued tasks, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+    // Accessors
+
+    // Number of worker threads
+    int size() const { return static_cast<int>(m_threads.size()); }
+
+
+    // Scheduling
+
+    // Queue a task
+    void submit(std::function<void()> task);
+
+    // Run one queued task on the calling thread, false if there was none
+    bool runOne();
+
+    // Return once every submitted task has finished, running queued tasks meanwhile
+    void waitIdle();
+
+    // Call fn(i) for i in [begin, end), in chunks of grain indices spread over the pool, and
+    // return once every call has finished.  The calling thread runs tasks while it waits.
+    template <class Fn>
+    void parallelFor(int begin, int end, int grain, Fn&& fn) {
+        grain = grain < 1 ? 1 : grain;
+        if (end - begin <= grain) {
+            for (int i = begin; i < end; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        std::atomic<int> nRemaining((end - begin + grain - 1)/grain);
+        for (int lo = begin; lo < end; lo += grain) {
+            const int hi = lo + grain < end ? lo + grain : end;
+            submit([this, &fn, &nRemaining, lo, hi]() {
+                for (int i = lo; i < hi; ++i) {
+                    fn(i);
+                }
+                if (nRemaining.fetch_sub(1) == 1) {
+                    notifyDone();
+                }
+            });
+        }
+        waitUntil([&nRemaining]() { return nRemaining.load() == 0; });
+    }
+
+};
+
+} // end namespace gaden
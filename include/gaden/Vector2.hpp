@@ -4,68 +4,76 @@
 #include <iostream>
 #include <sstream>
 
+#include "gaden/Constants.hpp"
+
 namespace gaden {
 
-class Vector2 {
+template <class Scalar>
+class Vector2T {
     // X coord
-    double m_x;
+    Scalar m_x;
 
     // Y coord
-    double m_y;
+    Scalar m_y;
 
 public:
 
     // Null constructor
-    Vector2() : m_x(0.0), m_y(0.0) {}
+    Vector2T() : m_x(0.0), m_y(0.0) {}
 
     // Construct from components
-    Vector2(double x, double y) : m_x(x), m_y(y) {}
+    Vector2T(Scalar x, Scalar y) : m_x(x), m_y(y) {}
+
+    // Convert from another precision, implicit only when widening
+    template <class Other>
+    explicit(sizeof(Other) > sizeof(Scalar)) Vector2T(const Vector2T<Other>& v) :
+        m_x(static_cast<Scalar>(v.x())), m_y(static_cast<Scalar>(v.y())) {}
 
-    Vector2(std::istream& is) {
+    Vector2T(std::istream& is) {
         fromCsv(is);
     }
 
     // Accessors
-    double x() const { return m_x; }
-    double& x() { return m_x; }
-    double y() const { return m_y; }
-    double& y() { return m_y; }
+    Scalar x() const { return m_x; }
+    Scalar& x() { return m_x; }
+    Scalar y() const { return m_y; }
+    Scalar& y() { return m_y; }
 
     // Cross product (2D vector math)
-    double crossProduct(const Vector2& rhs) const { return m_x*rhs.m_y - m_y*rhs.m_x; }
+    Scalar crossProduct(const Vector2T& rhs) const { return m_x*rhs.m_y - m_y*rhs.m_x; }
 
     // Dot product (inner product)
-    double dotProduct(const Vector2& rhs) const { return m_x*rhs.m_x + m_y*rhs.m_y; }
+    Scalar dotProduct(const Vector2T& rhs) const { return m_x*rhs.m_x + m_y*rhs.m_y; }
 
     // Magnitude, squared
-    double magSqr() const { return m_x*m_x + m_y*m_y; }
+    Scalar magSqr() const { return m_x*m_x + m_y*m_y; }
 
     // Magnitude (length)
-    double mag() const { return std::sqrt(magSqr()); }
+    Scalar mag() const { return std::sqrt(magSqr()); }
 
     // Turn into a unit vector, returns false if magnitude is near-zero
     bool normalise() {
-        double m = mag();
-        if (abs(1.0 - m) < constants::doubleSmall) {
+        Scalar m = mag();
+        if (std::abs(1.0 - m) < constants::doubleSmall) {
             return true;
         }
         if (m < constants::doubleSmall) {
             return false;
         }
-        double invMag = 1.0/m;
+        Scalar invMag = 1.0/m;
         operator*=(invMag);
         return true;
     }
 
     // Binary operations
 
-    Vector2& operator*=(double val) {
+    Vector2T& operator*=(Scalar val) {
         m_x *= val;
         m_y *= val;
         return *this;
     }
 
-    Vector2& operator/=(double val) {
+    Vector2T& operator/=(Scalar val) {
         m_x /= val;
         m_y /= val;
         return *this;
@@ -73,37 +81,37 @@ public:
 
     // * Vectors
 
-    Vector2& operator+=(const Vector2& vec) {
+    Vector2T& operator+=(const Vector2T& vec) {
         m_x += vec.m_x;
         m_y += vec.m_y;
         return *this;
     }
 
-    Vector2& operator-=(const Vector2& vec) {
+    Vector2T& operator-=(const Vector2T& vec) {
         m_x -= vec.m_x;
         m_y -= vec.m_y;
         return *this;
     }
 
-    Vector2 operator+(const Vector2& vec) const {
-        return Vector2(*this) += vec;
+    Vector2T operator+(const Vector2T& vec) const {
+        return Vector2T(*this) += vec;
     }
 
-    Vector2 operator-(const Vector2& vec) const {
-        return Vector2(*this) -= vec;
+    Vector2T operator-(const Vector2T& vec) const {
+        return Vector2T(*this) -= vec;
     }
 
-    Vector2 operator*(double scalar) const {
-        return Vector2(m_x*scalar, m_y*scalar);
+    Vector2T operator*(Scalar scalar) const {
+        return Vector2T(m_x*scalar, m_y*scalar);
     }
 
-    Vector2 operator/(double scalar) const {
-        return Vector2(m_x/scalar, m_y/scalar);
+    Vector2T operator/(Scalar scalar) const {
+        return Vector2T(m_x/scalar, m_y/scalar);
     }
 
     // Precedence for convex hull algorithms
     // TODO - Remove if this becomes part of a larger library, easy to confuse
-    bool operator<(const Vector2& rhs) const {
+    bool operator<(const Vector2T& rhs) const {
         return (m_x < rhs.m_x) || (m_x == rhs.m_x && m_y < rhs.m_y);
     }
 
@@ -122,15 +130,19 @@ public:
         is >> m_x >> comma >> m_y;
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Vector2& c) {
+    friend std::ostream& operator<<(std::ostream& os, const Vector2T& c) {
         return os << "(" << c.m_x << "," << c.m_y << ")";
     }
 
-    friend std::istream& operator>>(std::istream& is, Vector2& c) {
+    friend std::istream& operator>>(std::istream& is, Vector2T& c) {
         // char comma;
         char lparen, comma, rparen;
         return (is >> lparen >> c.m_x >> comma >> c.m_y >> rparen);
     }
 };
 
+// Double precision is the default, single precision halves the storage of large point clouds
+typedef Vector2T<double> Vector2;
+typedef Vector2T<float> Vector2f;
+
 } // end namespace gaden
\ No newline at end of file
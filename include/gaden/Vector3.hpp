@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 
@@ -7,53 +9,61 @@
 
 namespace gaden {
 
-class Vector3 {
-    double m_x, m_y, m_z;
+template <class Scalar>
+class Vector3T {
+    Scalar m_x, m_y, m_z;
 public:
 
-    Vector3(double x_in, double y_in, double z_in):
+    Vector3T(Scalar x_in, Scalar y_in, Scalar z_in):
         m_x(x_in),
         m_y(y_in),
         m_z(z_in)
     {}
-    Vector3():
+    // Convert from another precision, implicit only when widening
+    template <class Other>
+    explicit(sizeof(Other) > sizeof(Scalar)) Vector3T(const Vector3T<Other>& v):
+        m_x(static_cast<Scalar>(v.x())),
+        m_y(static_cast<Scalar>(v.y())),
+        m_z(static_cast<Scalar>(v.z()))
+    {}
+    Vector3T():
         m_x(0.0),
         m_y(0.0),
         m_z(0.0)
     {}
-    Vector3(std::istream& is) {
+    Vector3T(std::istream& is) {
         fromCsv(is);
     }
 
-    double x() const { return m_x; }
-    double& x() { return m_x; }
-    double y() const { return m_y; }
-    double& y() { return m_y; }
-    double z() const { return m_z; }
-    double& z() { return m_z; }
+    Scalar x() const { return m_x; }
+    Scalar& x() { return m_x; }
+    Scalar y() const { return m_y; }
+    Scalar& y() { return m_y; }
+    Scalar z() const { return m_z; }
+    Scalar& z() { return m_z; }
 
     // Unary operations
 
     // Magnitude, squared x^2,y^2,z^2
-    double magSqr() const {
+    Scalar magSqr() const {
         return m_x*m_x + m_y*m_y + m_z*m_z;
     }
 
     // Magnitude (i.e. length)
-    double mag() const {
+    Scalar mag() const {
         return std::sqrt(magSqr());
     }
 
     // Turn into a unit vector, returns false if magnitude is near-zero
     bool normalise() {
-        double m = mag();
-        if (abs(1.0 - m) < constants::doubleSmall) {
+        Scalar m = mag();
+        if (std::abs(1.0 - m) < constants::doubleSmall) {
             return true;
         }
         if (m < constants::doubleSmall) {
             return false;
         }
-        double invMag = 1.0/m;
+        Scalar invMag = 1.0/m;
         operator*=(invMag);
         return true;
     }
@@ -62,14 +72,14 @@ public:
 
     // * Scalars
 
-    Vector3& operator*=(double val) {
+    Vector3T& operator*=(Scalar val) {
         m_x *= val;
         m_y *= val;
         m_z *= val;
         return *this;
     }
 
-    Vector3& operator/=(double val) {
+    Vector3T& operator/=(Scalar val) {
         m_x /= val;
         m_y /= val;
         m_z /= val;
@@ -78,39 +88,39 @@ public:
 
     // * Vectors
 
-    Vector3& operator+=(const Vector3& vec) {
+    Vector3T& operator+=(const Vector3T& vec) {
         m_x += vec.m_x;
         m_y += vec.m_y;
         m_z += vec.m_z;
         return *this;
     }
 
-    Vector3& operator-=(const Vector3& vec) {
+    Vector3T& operator-=(const Vector3T& vec) {
         m_x -= vec.m_x;
         m_y -= vec.m_y;
         m_z -= vec.m_z;
         return *this;
     }
 
-    Vector3 operator+(const Vector3& vec) const {
-        return Vector3(*this) += vec;
+    Vector3T operator+(const Vector3T& vec) const {
+        return Vector3T(*this) += vec;
     }
 
-    Vector3 operator-(const Vector3& vec) const {
-        return Vector3(*this) -= vec;
+    Vector3T operator-(const Vector3T& vec) const {
+        return Vector3T(*this) -= vec;
     }
 
-    Vector3 operator*(double scalar) const {
-        return Vector3(m_x*scalar, m_y*scalar, m_z*scalar);
+    Vector3T operator*(Scalar scalar) const {
+        return Vector3T(m_x*scalar, m_y*scalar, m_z*scalar);
     }
 
-    Vector3 operator/(double scalar) const {
-        return Vector3(m_x/scalar, m_y/scalar, m_z/scalar);
+    Vector3T operator/(Scalar scalar) const {
+        return Vector3T(m_x/scalar, m_y/scalar, m_z/scalar);
     }
 
     // Returns result=(*this) crossProduct rhs
-    Vector3 crossProduct(const Vector3& rhs) const {
-        return Vector3(
+    Vector3T crossProduct(const Vector3T& rhs) const {
+        return Vector3T(
             m_y*rhs.m_z - m_z*rhs.m_y,
             m_z*rhs.m_x - m_x*rhs.m_z,
             m_x*rhs.m_y - m_y*rhs.m_x
@@ -118,7 +128,7 @@ public:
     }
 
     // Returns result=(*this) dotProduct rhs
-    double dotProduct(const Vector3& rhs) const {
+    Scalar dotProduct(const Vector3T& rhs) const {
         return m_x*rhs.m_x + m_y*rhs.m_y + m_z*rhs.m_z;
     }
 
@@ -138,15 +148,22 @@ public:
         is >> m_x >> comma >> m_y >> comma >> m_z;
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Vector3& c) {
+    friend std::ostream& operator<<(std::ostream& os, const Vector3T& c) {
         return os << "(" << c.m_x << "," << c.m_y<< "," << c.m_z << ")";
     }
 
-    friend std::istream& operator>>(std::istream& is, Vector3& c) {
+    friend std::istream& operator>>(std::istream& is, Vector3T& c) {
         // char comma;
         char lparen, comma, rparen;
         return (is >> lparen >> c.m_x >> comma >> c.m_y >> comma >> c.m_z >> rparen);
     }
 };
 
-} // end namespace gaden
+// Double precision is the default, single precision halves the storage of large point clouds
+typedef Vector3T<double> Vector3;
+typedef Vector3T<float> Vector3f;
+
+// Integer lattice coordinates, see Lattice.  Only the storage, I/O and +/- members apply.
+typedef Vector3T<std::int32_t> Vector3i;
+
+} // end namespace gaden
\ No newline at end of file
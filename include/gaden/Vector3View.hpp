@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include "gaden/Index.hpp"
+#include "gaden/Vector3.hpp"
+
+namespace gaden {
+
+// Read-only view of points held elsewhere as packed x, y, z doubles, such as a shared memory job
+// (see SharedJob.h).  Indexes like a Vector3Field, so templated point code reads the points in
+// place and nothing is copied.  The memory must outlive the view.
+class Vector3View {
+
+    // Private data
+
+    const double* m_xyz;
+    index_t m_size;
+
+
+public:
+
+    // Construct empty
+    Vector3View() : m_xyz(nullptr), m_size(0) {}
+
+    // Construct over n points, xyz holds 3*n doubles
+    Vector3View(const double* xyz, index_t n) : m_xyz(xyz), m_size(n) {}
+
+
+    // Accessors
+
+    index_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    Vector3 operator[](index_t i) const {
+        const double* p = m_xyz + 3*static_cast<std::size_t>(i);
+        return Vector3(p[0], p[1], p[2]);
+    }
+
+};
+
+} // end namespace gaden
@@ -21,6 +21,15 @@ typedef VectorNField<IndexedVector3> IndexedVector3Field;
 typedef VectorNField<Vector2> Vector2Field;
 typedef VectorNField<Vector3> Vector3Field;
 
+// Single precision, for large point clouds
+typedef VectorNField<IndexedVector2f> IndexedVector2fField;
+typedef VectorNField<IndexedVector3f> IndexedVector3fField;
+typedef VectorNField<Vector2f> Vector2fField;
+typedef VectorNField<Vector3f> Vector3fField;
+
+// Integer lattice coordinates, see Lattice
+typedef VectorNField<Vector3i> Vector3iField;
+
 
 template<class Type>
 class VectorNField: public ObjectBase {
@@ -34,13 +43,13 @@ public:
     {}
 
     // Construct given size
-    VectorNField(int size, std::string name=""):
+    VectorNField(index_t size, std::string name=""):
         ObjectBase(name == "" ? "VectorNField" : name),
         m_vec(size)
     {}
 
     // Construct given size and initial element
-    VectorNField(int size, Type elem, std::string name=""):
+    VectorNField(index_t size, Type elem, std::string name=""):
         ObjectBase(name == "" ? "VectorNField" : name),
         m_vec(size, elem)
     {}
@@ -447,7 +456,7 @@ public:
     }
 
     // Write out ith element
-    void writeElem(std::ostream& os, int i) const {
+    void writeElem(std::ostream& os, index_t i) const {
         os << m_vec.at(i).toCsv();
     }
 
@@ -474,11 +483,14 @@ public:
 
 // Convert supplied Vector2Field into an IndexedVector2Field with idx start at start, incrementing
 //  by step.
-IndexedVector2Field convertToIndexed(const Vector2Field& fldIn, int start=-1, int step=0);
+IndexedVector2Field convertToIndexed(const Vector2Field& fldIn, index_t start=-1, index_t step=0);
 
 // Convert supplied Vector3Field into an IndexedVector3Field with idx start at start, incrementing
 //  by step.
-IndexedVector3Field convertToIndexed(const Vector3Field& fldIn, int start=-1, int step=0);
+IndexedVector3Field convertToIndexed(const Vector3Field& fldIn, index_t start=-1, index_t step=0);
+
+// Single precision counterpart of the above
+IndexedVector3fField convertToIndexed(const Vector3fField& fldIn, index_t start=-1, index_t step=0);
 
 // Remove indexing from Vecto2Field
 Vector2Field stripIndexing(const IndexedVector2Field& fldIn);
@@ -486,5 +498,8 @@ Vector2Field stripIndexing(const IndexedVector2Field& fldIn);
 // Remove indexing from Vector3Field
 Vector3Field stripIndexing(const IndexedVector3Field& fldIn);
 
+// Single precision counterpart of the above
+Vector3fField stripIndexing(const IndexedVector3fField& fldIn);
+
 
 } // end namespace gaden
\ No newline at end of file
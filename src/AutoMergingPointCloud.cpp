@@ -1,24 +1,17 @@
 #include "gaden/AutoMergingPointCloud.hpp"
 
-// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * * //
-
-namespace gaden
-{
-    const IntField AutoMergingPointCloud::m_empty;
-}
-
-
 // * * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * //
 
-void gaden::AutoMergingPointCloud::addToBucketIndices(double msd, int pointIndex)
+template <class Scalar>
+void gaden::AutoMergingPointCloudT<Scalar>::addToBucketIndices(double msd, index_t pointIndex)
 {
-    const int bucketIndex = getBucketIndex(msd);
+    const std::int64_t bucketIndex = getBucketIndex(msd);
     auto iter = m_msdBucketIndices.find(bucketIndex);
     if (iter == m_msdBucketIndices.end())
     {
         // Create a new list and add it
         // DynamicList<int> candidates(1);
-        IntField candidates;
+        IndexField candidates;
         candidates.push_back(pointIndex);
         m_msdBucketIndices.insert({bucketIndex, candidates});
     }
@@ -32,8 +25,9 @@ void gaden::AutoMergingPointCloud::addToBucketIndices(double msd, int pointIndex
 
 // * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
 
-gaden::AutoMergingPointCloud::AutoMergingPointCloud(
-    int estimatedSize, double mergeTol, std::string name
+template <class Scalar>
+gaden::AutoMergingPointCloudT<Scalar>::AutoMergingPointCloudT(
+    index_t estimatedSize, double mergeTol, std::string name
 ) :
     m_mergeTol(mergeTol),
     m_mergeTolSqr(mergeTol*mergeTol),
@@ -50,40 +44,54 @@ gaden::AutoMergingPointCloud::AutoMergingPointCloud(
 
 // * * * * * * * * * * * * * * * Member Functions  * * * * * * * * * * * * * //
 
-std::pair<bool, int> gaden::AutoMergingPointCloud::append(const Vector3& pt)
+template <class Scalar>
+std::pair<bool, gaden::index_t>
+gaden::AutoMergingPointCloudT<Scalar>::append(const Vector3T<Scalar>& ptIn)
 {
+    const Vector3 pt(ptIn);
     double msd = pt.magSqr();
-    double scaledTol = 2*m_mergeTol*(abs(pt.x()) + abs(pt.y()) + abs(pt.z()));
+    double scaledTol = 2*m_mergeTol*(std::abs(pt.x()) + std::abs(pt.y()) + std::abs(pt.z()));
 
-    int from = getBucketIndex(msd - scaledTol);
-    int to = getBucketIndex(msd + scaledTol);
-    for (int bucketI = from; bucketI <= to; ++bucketI)
+    const std::int64_t from = getBucketIndex(msd - scaledTol);
+    const std::int64_t to = getBucketIndex(msd + scaledTol);
+    for
+    (
+        auto bucketIter = m_msdBucketIndices.lower_bound(from);
+        bucketIter != m_msdBucketIndices.end() && bucketIter->first <= to;
+        ++bucketIter
+    )
     {
-        const IntField& candidates = getCandidateIndicies(bucketI);
-        int nCandidates = candidates.size();
-        for (int ci = 0; ci < nCandidates; ++ci)
+        const IndexField& candidates = bucketIter->second;
+        index_t nCandidates = candidates.size();
+        for (index_t ci = 0; ci < nCandidates; ++ci)
         {
-            const int candidateI = candidates[ci];
+            const index_t candidateI = candidates[ci];
             // Quick reject
-            if (abs(m_magSqrDist[candidateI] - msd) <= scaledTol)
+            if (std::abs(m_magSqrDist[candidateI] - msd) <= scaledTol)
             {
                 // Actual test
-                if ( (pt - m_points[candidateI]).magSqr() <= m_mergeTolSqr )
+                if ( (pt - Vector3(m_points[candidateI])).magSqr() <= m_mergeTolSqr )
                 {
                     // Found match
-                    return std::pair<bool, int>(false, candidateI);
+                    return std::pair<bool, index_t>(false, candidateI);
                 }
             }
         }
     }
     // No merged point, append to lists
-    const int newPtIndex = m_points.size();
-    m_points.push_back(pt);
+    const index_t newPtIndex = m_points.size();
+    m_points.push_back(ptIn);
     m_magSqrDist.push_back(msd);
     m_scaledTolSqr.push_back(scaledTol);
     addToBucketIndices(msd, newPtIndex);
-    return std::pair<bool, int>(true, newPtIndex);
+    return std::pair<bool, index_t>(true, newPtIndex);
 }
 
 
+// * * * * * * * * * * * * * Explicit Instantiation  * * * * * * * * * * * * //
+
+template class gaden::AutoMergingPointCloudT<double>;
+template class gaden::AutoMergingPointCloudT<float>;
+
+
 // ************************************************************************* //
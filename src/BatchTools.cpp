@@ -0,0 +1,399 @@
+#include "gaden/BatchTools.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "gaden/BoundedQueue.hpp"
+#include "gaden/Logger.hpp"
+#include "gaden/PartTools.hpp"
+
+
+namespace { // anonymous namespace for local-only functionality
+
+using namespace gaden;
+
+// Counters of one pipeline stage, updated by its workers
+struct StageStats {
+    const char* m_name;
+    int m_nWorkers = 0;
+    std::atomic<int> m_nItems{0};
+    std::atomic<std::uintmax_t> m_nBytes{0};
+
+    // Worker time working, waiting for input and waiting for room downstream
+    std::atomic<long long> m_busyNs{0};
+    std::atomic<long long> m_starvedNs{0};
+    std::atomic<long long> m_blockedNs{0};
+
+    // First start and last finish of the stage's workers, ns since the batch started
+    std::atomic<long long> m_firstNs{std::numeric_limits<long long>::max()};
+    std::atomic<long long> m_lastNs{0};
+
+    explicit StageStats(const char* name) : m_name(name) {}
+};
+
+// A file read into memory, handed from the ingest stage to the merge / hull stage
+struct IngestedFile {
+    std::string m_filePath;
+    std::string m_bytes;
+    std::string m_error;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+// A part's prepared hull, or its result if it needs no search or failed, handed from the
+// merge / hull stage to the solve stage
+struct HulledPart {
+    std::string m_filePath;
+    PreparedHull m_hull;
+    PartResult m_result;
+    bool m_needsSolve = false;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+} // end anonymous namespace
+
+
+bool gaden::BatchTools::listParts(
+    std::vector<std::string>& partsOut,
+    const std::string& batchPath
+) {
+    namespace fs = std::filesystem;
+    partsOut.clear();
+    std::error_code ec;
+    if (fs::is_directory(batchPath, ec)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(batchPath, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+                partsOut.push_back(entry.path().string());
+            }
+        }
+    } else {
+        std::ifstream manifest(batchPath);
+        if (!manifest.is_open()) {
+            return false;
+        }
+        const fs::path baseDir(fs::path(batchPath).parent_path());
+        std::string line;
+        while (std::getline(manifest, line)) {
+            const size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') {
+                continue;
+            }
+            const size_t last = line.find_last_not_of(" \t\r");
+            fs::path part(line.substr(first, last - first + 1));
+            if (part.is_relative()) {
+                part = baseDir/part;
+            }
+            partsOut.push_back(part.string());
+        }
+    }
+    if (ec) {
+        return false;
+    }
+    std::vector<std::pair<std::uintmax_t, std::string>> sized;
+    sized.reserve(partsOut.size());
+    for (const std::string& part : partsOut) {
+        std::error_code sizeEc;
+        const std::uintmax_t size = fs::file_size(part, sizeEc);
+        sized.emplace_back(sizeEc ? 0 : size, part);
+    }
+    std::sort(sized.begin(), sized.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (size_t i = 0; i < sized.size(); ++i) {
+        partsOut[i] = sized[i].second;
+    }
+    return true;
+}
+
+
+int gaden::BatchTools::solveFile(
+    BatchWriter& writer,
+    const AppOptions& opt,
+    const std::string& filePath,
+    ThreadPool& pool
+) {
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    PartResult result;
+    try {
+        Surface3 surface;
+        if (PartTools::readSurface(surface, result.m_error, opt, filePath)) {
+            if (!surface.partIds().empty()) {
+                return PartTools::solveParts(
+                    [&](const PartResult& partResult) { writer.write(filePath, partResult); },
+                    opt, surface, pool
+                );
+            }
+            PartTools::solveSurface(result, opt, surface, &pool, startTime);
+        }
+    } catch (const std::exception& e) {
+        result = PartResult();
+        result.m_error = e.what();
+    }
+    writer.write(filePath, result);
+    return result.m_ok ? 0 : 1;
+}
+
+
+int gaden::BatchTools::solvePipelined(
+    BatchWriter& writer,
+    const AppOptions& opt,
+    const std::vector<std::string>& files
+) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point batchStart = Clock::now();
+    const auto sinceStart = [&batchStart](const Clock::time_point& t) {
+        return static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t - batchStart).count()
+        );
+    };
+    const auto elapsedNs = [](const Clock::time_point& t0) {
+        return static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()
+        );
+    };
+
+    // One reader, the cpu split about 1 : 3 between merge / hull and solve
+    const int nThreads = opt.threads > 0
+        ? opt.threads
+        : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    StageStats ingest("ingest");
+    StageStats hull("merge/hull");
+    StageStats solve("solve");
+    ingest.m_nWorkers = 1;
+    hull.m_nWorkers = std::max(1, nThreads/4);
+    solve.m_nWorkers = std::max(1, nThreads - hull.m_nWorkers);
+
+    BoundedQueue<std::unique_ptr<IngestedFile>> ingested(opt.pipelineDepth);
+    BoundedQueue<std::unique_ptr<HulledPart>> hulled(opt.pipelineDepth);
+    std::atomic<int> nHullRunning(hull.m_nWorkers);
+    std::atomic<int> nFailed(0);
+    std::atomic<int> nParts(0);
+
+    // Run one stage worker: take items from pop until it fails, timing the waits and the work
+    const auto runStage = [&](StageStats& stats, auto&& pop, auto&& work) {
+        const long long startNs = sinceStart(Clock::now());
+        long long first = stats.m_firstNs.load();
+        while (startNs < first && !stats.m_firstNs.compare_exchange_weak(first, startNs)) {
+        }
+        for (;;) {
+            Clock::time_point t0 = Clock::now();
+            auto item = pop();
+            stats.m_starvedNs.fetch_add(elapsedNs(t0));
+            if (!item) {
+                break;
+            }
+            t0 = Clock::now();
+            const long long blockedNs = work(std::move(item));
+            stats.m_busyNs.fetch_add(elapsedNs(t0) - blockedNs);
+            stats.m_blockedNs.fetch_add(blockedNs);
+            stats.m_nItems.fetch_add(1);
+        }
+        const long long endNs = sinceStart(Clock::now());
+        long long last = stats.m_lastNs.load();
+        while (last < endNs && !stats.m_lastNs.compare_exchange_weak(last, endNs)) {
+        }
+    };
+
+    // Push downstream, returning the ns spent waiting for room
+    const auto pushTimed = [&elapsedNs](auto& queue, auto item) {
+        const Clock::time_point t0 = Clock::now();
+        queue.push(std::move(item));
+        return elapsedNs(t0);
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        size_t next = 0;
+        runStage(
+            ingest,
+            [&]() { return next < files.size() ? &files[next++] : nullptr; },
+            [&](const std::string* filePath) {
+                auto item = std::make_unique<IngestedFile>();
+                item->m_filePath = *filePath;
+                item->m_startTime = Clock::now();
+                std::ifstream is(*filePath, std::ios::binary);
+                if (is.is_open()) {
+                    std::ostringstream bytes;
+                    bytes << is.rdbuf();
+                    item->m_bytes = bytes.str();
+                    ingest.m_nBytes.fetch_add(item->m_bytes.size());
+                } else {
+                    item->m_error = "Failed to open file '" + *filePath + "'";
+                }
+                return pushTimed(ingested, std::move(item));
+            }
+        );
+        ingested.close();
+    });
+    for (int w = 0; w < hull.m_nWorkers; ++w) {
+        threads.emplace_back([&]() {
+            runStage(
+                hull,
+                [&]() {
+                    std::unique_ptr<IngestedFile> item;
+                    ingested.pop(item);
+                    return item;
+                },
+                [&](std::unique_ptr<IngestedFile> file) {
+                    long long blockedNs = 0;
+                    const auto emit = [&](std::unique_ptr<HulledPart> part) {
+                        nParts.fetch_add(1);
+                        blockedNs += pushTimed(hulled, std::move(part));
+                    };
+                    const auto makePart = [&file]() {
+                        auto part = std::make_unique<HulledPart>();
+                        part->m_filePath = file->m_filePath;
+                        part->m_startTime = file->m_startTime;
+                        return part;
+                    };
+                    if (!file->m_error.empty()) {
+                        auto part = makePart();
+                        part->m_result.m_error = file->m_error;
+                        emit(std::move(part));
+                        return blockedNs;
+                    }
+                    try {
+                        std::istringstream is(file->m_bytes);
+                        Surface3 surface(is, PartTools::readEpsilon(opt));
+                        std::string().swap(file->m_bytes);
+                        if (surface.partIds().empty()) {
+                            auto part = makePart();
+                            part->m_needsSolve = PartTools::prepareHull(
+                                part->m_hull, part->m_result, opt, surface, part->m_startTime
+                            );
+                            emit(std::move(part));
+                        } else {
+                            for (index_t i = 0; i < surface.nParts(); ++i) {
+                                auto part = makePart();
+                                Surface3 partSurface(surface.extractPart(i));
+                                part->m_needsSolve = PartTools::prepareHull(
+                                    part->m_hull, part->m_result, opt, partSurface,
+                                    part->m_startTime
+                                );
+                                part->m_result.m_hasPartId = true;
+                                part->m_result.m_partId = surface.partIds()[i];
+                                emit(std::move(part));
+                            }
+                        }
+                    } catch (const std::exception& e) {
+                        auto part = makePart();
+                        part->m_result.m_error = e.what();
+                        emit(std::move(part));
+                    }
+                    return blockedNs;
+                }
+            );
+            if (nHullRunning.fetch_sub(1) == 1) {
+                hulled.close();
+            }
+        });
+    }
+    for (int w = 0; w < solve.m_nWorkers; ++w) {
+        threads.emplace_back([&]() {
+            runStage(
+                solve,
+                [&]() {
+                    std::unique_ptr<HulledPart> item;
+                    hulled.pop(item);
+                    return item;
+                },
+                [&](std::unique_ptr<HulledPart> part) {
+                    PartResult& result = part->m_result;
+                    if (part->m_needsSolve) {
+                        const bool hasPartId = result.m_hasPartId;
+                        const index_t partId = result.m_partId;
+                        try {
+                            PartTools::solveHull(
+                                result, opt, part->m_hull, nullptr, part->m_startTime
+                            );
+                        } catch (const std::exception& e) {
+                            result = PartResult();
+                            result.m_error = e.what();
+                        }
+                        result.m_hasPartId = hasPartId;
+                        result.m_partId = partId;
+                    }
+                    if (!result.m_ok) {
+                        nFailed.fetch_add(1);
+                    }
+                    writer.write(part->m_filePath, result);
+                    return 0LL;
+                }
+            );
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Items per second over each stage's active span, and where its workers spent the time
+    const double wallS = sinceStart(Clock::now())*1e-9;
+    std::ostringstream report;
+    report
+        << std::fixed << std::setprecision(1)
+        << "Pipeline, " << files.size() << " files, " << nParts.load() << " parts, "
+        << std::setprecision(3) << wallS << " s, queue depth " << opt.pipelineDepth << "\n"
+        << std::setprecision(1)
+        << "  stage       workers   items    items/s     busy%  starved%  blocked%\n";
+    for (const StageStats* stats : {&ingest, &hull, &solve}) {
+        const double spanS = std::max(1e-9, (stats->m_lastNs - stats->m_firstNs)*1e-9);
+        const double workerNs = std::max(1.0, spanS*1e9*stats->m_nWorkers);
+        report
+            << "  " << std::left << std::setw(12) << stats->m_name << std::right
+            << std::setw(7) << stats->m_nWorkers << std::setw(8) << stats->m_nItems.load()
+            << std::setw(11) << stats->m_nItems/spanS
+            << std::setw(10) << 100.0*stats->m_busyNs/workerNs
+            << std::setw(10) << 100.0*stats->m_starvedNs/workerNs
+            << std::setw(10) << 100.0*stats->m_blockedNs/workerNs;
+        if (stats->m_nBytes > 0) {
+            // While reading, not waiting for room
+            report
+                << "  (" << stats->m_nBytes*1e-6/std::max(1e-9, stats->m_busyNs*1e-9)
+                << " MB/s read)";
+        }
+        report << "\n";
+    }
+    std::cerr << report.str();
+    return nFailed.load();
+}
+
+
+int gaden::BatchTools::solveBatch(const AppOptions& opt) {
+    std::vector<std::string> files;
+    if (!listParts(files, opt.batchPath)) {
+        Log_Error("Failed to read batch '" << opt.batchPath << "'");
+        return -1;
+    }
+    std::ofstream file;
+    std::ostream* os = BatchWriter::openOutput(file, opt);
+    if (!os) {
+        return -1;
+    }
+    BatchWriter writer(*os, BatchWriter::outputIsJson(opt));
+    if (opt.pipelineDepth > 0) {
+        return solvePipelined(writer, opt, files);
+    }
+
+    ThreadPool pool(opt.threads);
+    Log_Info("Batch of " << files.size() << " files on " << pool.size() << " threads");
+    std::atomic<int> nFailed(0);
+    for (const std::string& filePath : files) {
+        // Each file is a task, a large hull's grid or a multi-part file's parts spread over
+        // the idle workers
+        pool.submit([&opt, &pool, &writer, &nFailed, filePath]() {
+            nFailed.fetch_add(solveFile(writer, opt, filePath, pool));
+        });
+    }
+    pool.waitIdle();
+    Log_Info("Batch done, " << nFailed.load() << " parts failed");
+    return nFailed.load();
+}
@@ -0,0 +1,127 @@
+#include "gaden/BatchWriter.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "gaden/JsonTools.hpp"
+#include "gaden/Logger.hpp"
+
+
+gaden::BatchWriter::BatchWriter(std::ostream& os, bool json) :
+    m_os(os),
+    m_json(json)
+{
+    m_os << std::setprecision(std::numeric_limits<double>::max_digits10);
+    if (!m_json) {
+        m_os
+            << "file,part,status,points,hullPoints,volume,"
+            << "minX,minY,minZ,maxX,maxY,maxZ,"
+            << "axisXx,axisXy,axisXz,axisYx,axisYy,axisYz,axisZx,axisZy,axisZz,"
+            << "rotX,rotY,rotZ,ms,error\n";
+    }
+}
+
+
+void gaden::BatchWriter::write(const std::string& filePath, const PartResult& result) {
+    const Vector3 minPt(result.m_bb.minPt());
+    const Vector3 maxPt(result.m_bb.maxPt());
+    const Vector3 span(maxPt - minPt);
+    const double volume = result.m_ok ? span.x()*span.y()*span.z() : 0.0;
+    const Vector3* axes[3] = {&result.m_axes.x(), &result.m_axes.y(), &result.m_axes.z()};
+    std::ostringstream line;
+    line << std::setprecision(std::numeric_limits<double>::max_digits10);
+    if (m_json) {
+        line << resultJson(filePath, result) << "\n";
+    } else {
+        line << csvField(filePath) << ",";
+        if (result.m_hasPartId) {
+            line << result.m_partId;
+        }
+        line << "," << (result.m_ok ? "ok" : "error");
+        if (result.m_ok) {
+            line
+                << "," << result.m_nPoints << "," << result.m_nHullPoints << "," << volume
+                << "," << minPt.x() << "," << minPt.y() << "," << minPt.z()
+                << "," << maxPt.x() << "," << maxPt.y() << "," << maxPt.z();
+            for (int i = 0; i < 3; ++i) {
+                line << "," << axes[i]->x() << "," << axes[i]->y() << "," << axes[i]->z();
+            }
+            line
+                << "," << result.m_rotations.x() << "," << result.m_rotations.y() << ","
+                << result.m_rotations.z();
+        } else {
+            line << std::string(21, ',');
+        }
+        line << "," << result.m_ms << "," << csvField(result.m_error) << "\n";
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_os << line.str() << std::flush;
+}
+
+
+std::string gaden::BatchWriter::csvField(const std::string& s) {
+    std::string out("\"");
+    for (const char c : s) {
+        out += c == '"' ? std::string("\"\"") : std::string(1, c);
+    }
+    return out + "\"";
+}
+
+
+std::string gaden::BatchWriter::resultJson(const std::string& filePath, const PartResult& result) {
+    const Vector3 minPt(result.m_bb.minPt());
+    const Vector3 maxPt(result.m_bb.maxPt());
+    const Vector3 span(maxPt - minPt);
+    const Vector3* axes[3] = {&result.m_axes.x(), &result.m_axes.y(), &result.m_axes.z()};
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<double>::max_digits10) << "{";
+    if (!filePath.empty()) {
+        os << "\"file\":" << JsonTools::quote(filePath) << ",";
+    }
+    if (result.m_hasPartId) {
+        os << "\"part\":" << result.m_partId << ",";
+    }
+    os << "\"status\":\"" << (result.m_ok ? "ok" : "error") << "\"";
+    if (result.m_ok) {
+        os
+            << ",\"points\":" << result.m_nPoints
+            << ",\"hullPoints\":" << result.m_nHullPoints
+            << ",\"volume\":" << span.x()*span.y()*span.z()
+            << ",\"min\":[" << minPt.x() << "," << minPt.y() << "," << minPt.z()
+            << "],\"max\":[" << maxPt.x() << "," << maxPt.y() << "," << maxPt.z()
+            << "],\"axes\":[";
+        for (int i = 0; i < 3; ++i) {
+            os
+                << (i ? ",[" : "[") << axes[i]->x() << "," << axes[i]->y() << ","
+                << axes[i]->z() << "]";
+        }
+        os
+            << "],\"rotations\":[" << result.m_rotations.x() << ","
+            << result.m_rotations.y() << "," << result.m_rotations.z() << "]";
+    } else {
+        os << ",\"error\":" << JsonTools::quote(result.m_error);
+    }
+    os << ",\"ms\":" << result.m_ms << "}";
+    return os.str();
+}
+
+
+std::ostream* gaden::BatchWriter::openOutput(std::ofstream& file, const AppOptions& opt) {
+    if (opt.batchOutput.empty()) {
+        return &std::cout;
+    }
+    file.open(opt.batchOutput);
+    if (!file.is_open()) {
+        Log_Error("Failed to open batch output '" << opt.batchOutput << "'");
+        return nullptr;
+    }
+    return &file;
+}
+
+
+bool gaden::BatchWriter::outputIsJson(const AppOptions& opt) {
+    const std::string& out = opt.batchOutput;
+    return out.size() >= 6 && out.compare(out.size() - 6, 6, ".jsonl") == 0;
+}
@@ -1,6 +1,13 @@
 #include "gaden/BoundBox.hpp"
-#include "gaden/PointCloudTools.hpp"
-#include "gaden/ConvexHullTools.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "gaden/BoundBoxTools.hpp"
+#include "gaden/ConvexHullGraph.hpp"
+#include "gaden/ConvexHullHierarchy.hpp"
+#include "gaden/OrientedBoundBox.hpp"
+#include "gaden/ThreadPool.hpp"
 
 gaden::BoundBox gaden::BoundBox::calculateAxisAlignedBoundBox(
     const Vector3Field& ptsIn
@@ -18,182 +25,205 @@ gaden::BoundBox gaden::BoundBox::solveMinimumRotatedBoundBox(
     Axes& resultAxes, Vector3& resultRotations,
 
     // inputs
-    const Vector3Field& pts, int steps, int passes, double epsilon
+    const Vector3Field& pts, int steps, int passes, double epsilon, int beamWidth
 ) {
+    return solveMinimumRotatedBoundBox(
+        resultAxes, resultRotations, pts, steps, passes, epsilon, beamWidth, OrientedBoundBox()
+    );
+}
+
+
+gaden::BoundBox gaden::BoundBox::solveMinimumRotatedBoundBox(
+    // outputs
+    Axes& resultAxes, Vector3& resultRotations,
+
+    // inputs
+    const Vector3Field& pts, int steps, int passes, double epsilon, int beamWidth,
+    const OrientedBoundBox& seed, bool coherent, const ConvexHullGraph* hullGraph,
+    const ConvexHullHierarchy* hullHierarchy, int float32Verify, ThreadPool* pool
+) {
+    // A (theta, phi) search window, divided into steps x steps cells
+    struct Window {
+        double thetaMin;
+        double thetaMax;
+        double phiMin;
+        double phiMax;
+
+        double thetaDelta(int steps) const { return (thetaMax - thetaMin)/steps; }
+        double phiDelta(int steps) const { return (phiMax - phiMin)/steps; }
+    };
+
+    // An evaluated cell, remembers the cell size of the window it came from
+    struct Cell {
+        OrientedBoundBox obb;
+        double thetaDelta;
+        double phiDelta;
+    };
+
+    beamWidth = std::max(beamWidth, 1);
+
     // Only need to rotate pi/2 on each axis
     // No need to resolve psi axis, we use projection and solve min rectangle
-    double thetaMin = 0.0;
-    double thetaMax = constants::piByTwo;
-    double thetaDelta = (thetaMax - thetaMin)/steps;
-    double phiMin = 0.0;
-    double phiMax = constants::piByTwo;
-    double phiDelta = (phiMax - phiMin)/steps;
+    std::vector<Window> windows = {{0.0, constants::piByTwo, 0.0, constants::piByTwo}};
 
     // Best-so-far
-    double bestTheta = 0.0;
-    double bestPhi = 0.0;
-    double bestPsi = 0.0;
-    double bestVol = std::numeric_limits<double>::infinity();
-
-    // min/max in rotated (u',v',w) frame
-    BoundBox bestLocalBb;
-
-    // world-space orthonormal basis (u', v', w)
-    Axes bestAxes;
+    OrientedBoundBox best(seed);
+
+    // Mixed precision, cells are screened in single precision and only the best are evaluated in
+    // double, best only ever holds double precision boxes
+    const bool mixedPrecision = float32Verify > 0;
+    BoundBoxTools::Float32Points fpts;
+    if (mixedPrecision) {
+        fpts = BoundBoxTools::makeFloat32Points(pts);
+    }
 
     for (int passI = 0; passI < passes; ++passI) {
-        Log_Debug(""
-            << "pass " << passI << ", theta=(" << thetaMin << "," << thetaMax
-            << ", phi=(" << phiMin << "," << phiMax << ")"
-        );
         bool finalPass = passI == (passes - 1);
 
-        // Grid search over (theta, phi)
-        for (int thetaI = 0; thetaI < steps; ++thetaI) {
-            const double theta = thetaMin + thetaI*thetaDelta;
-
-            for (int phiI = 0; phiI < steps; ++phiI) {
-                const double phi = phiMin + phiI*phiDelta;
-                // *** Build (u, v, w) from (theta, phi)
-                // w is the look direction: yaw around +Z by theta, then pitch (declination) by phi
-                const double cth = std::cos(theta);
-                const double sth = std::sin(theta);
-                const double cph = std::cos(phi);
-                const double sph = std::sin(phi);
-
-                Vector3 w(cth*cph, sth*cph, sph);
-                if (!w.normalise()) {
-                    continue;
+        // Grid search over (theta, phi) in each window of the beam
+        std::vector<Cell> cells;
+        cells.reserve(windows.size()*steps*steps + 1);
+
+        // The best so far stays a candidate, windows[0] is centred on it after the first pass
+        if (best.valid()) {
+            cells.push_back({best, windows[0].thetaDelta(steps), windows[0].phiDelta(steps)});
+        }
+        for (const Window& win : windows) {
+            Log_Debug(""
+                << "pass " << passI << ", theta=(" << win.thetaMin << "," << win.thetaMax
+                << ", phi=(" << win.phiMin << "," << win.phiMax << ")"
+            );
+            const double thetaDelta = win.thetaDelta(steps);
+            const double phiDelta = win.phiDelta(steps);
+
+            // One theta row, in its own cells so that rows can run in parallel
+            const auto evaluateRow = [&](int thetaI, BoundBoxTools::SweepState& sweep,
+                std::vector<Cell>& rowCells)
+            {
+                const double theta = win.thetaMin + thetaI*thetaDelta;
+                for (int k = 0; k < steps; ++k) {
+                    // Serpentine when coherent, so each cell neighbours the last
+                    const int phiI = (coherent && thetaI % 2 == 1) ? steps - 1 - k : k;
+                    const double phi = win.phiMin + phiI*phiDelta;
+                    Cell cell{
+                        mixedPrecision
+                            ? BoundBoxTools::evaluateOrientationFloat32(fpts, theta, phi)
+                            : BoundBoxTools::evaluateOrientation(pts, theta, phi, epsilon, sweep),
+                        thetaDelta,
+                        phiDelta
+                    };
+                    if (cell.obb.valid()) {
+                        rowCells.push_back(cell);
+                    }
                 }
+            };
+            const auto makeSweep = [&]() {
+                BoundBoxTools::SweepState sweep;
+                sweep.m_coherent = coherent;
+                sweep.m_hullGraph = (hullGraph && !hullGraph->empty()) ? hullGraph : nullptr;
+                sweep.m_hullHierarchy =
+                    (hullHierarchy && !hullHierarchy->empty()) ? hullHierarchy : nullptr;
+                return sweep;
+            };
+            std::vector<std::vector<Cell>> rows(steps);
+            if (pool && pool->size() > 1) {
+                // Each row starts its own sweep, coherent warm starts only change the cost
+                pool->parallelFor(0, steps, 1, [&](int thetaI) {
+                    BoundBoxTools::SweepState sweep(makeSweep());
+                    evaluateRow(thetaI, sweep, rows[thetaI]);
+                });
+            } else {
+                BoundBoxTools::SweepState sweep(makeSweep());
+                for (int thetaI = 0; thetaI < steps; ++thetaI) {
+                    evaluateRow(thetaI, sweep, rows[thetaI]);
+                }
+            }
 
-                // Choose helper t not parallel to w, form u perpendicular to w
-                Vector3 t = (std::fabs(w.z()) < 0.9) ? Vector3(0.0, 0.0, 1.0) : Vector3(1.0, 0.0, 0.0);
-                Vector3 u = t - w*w.dotProduct(t);
-                if (!u.normalise()) {
-                    continue;
+            // Merge in row order, as a serial sweep would have found them
+            for (const std::vector<Cell>& rowCells : rows) {
+                for (const Cell& cell : rowCells) {
+                    if (!mixedPrecision && cell.obb.betterThan(best)) {
+                        best = cell.obb;
+                    }
+                    cells.push_back(cell);
                 }
+            }
+        }
 
-                Vector3 v = w.crossProduct(u);
-                if (!v.normalise()) {
+        if (mixedPrecision) {
+            // Verify the float32Verify best screened cells in double precision
+            const int nVerify = std::min(float32Verify, static_cast<int>(cells.size()));
+            std::partial_sort(
+                cells.begin(),
+                cells.begin() + nVerify,
+                cells.end(),
+                [](const Cell& a, const Cell& b) { return a.obb.volume() < b.obb.volume(); }
+            );
+            for (int i = 0; i < nVerify; ++i) {
+                Cell& cell = cells[i];
+                if (cell.obb.localBb().valid()) {
+                    // Already a double precision box, the carried best
                     continue;
                 }
-
-                // *** Project to 2D and compute convex hull in that (u,v) plane
-                IndexedVector2Field projPts;
-                PointCloudTools::projectPointsToPlane(
-                    pts,
-                    theta,
-                    phi,
-                    epsilon,
-                    projPts
+                cell.obb = BoundBoxTools::evaluateOrientation(
+                    pts, cell.obb.theta(), cell.obb.phi(), epsilon
                 );
+                if (cell.obb.betterThan(best)) {
+                    best = cell.obb;
+                }
+            }
+            Log_Debug("pass " << passI << ", verified " << nVerify << " screened cells");
+        }
 
-                IndexedVector2Field ch2Pts;
-                IntField ch2Verts;
-                int nCh2Dims = ConvexHullTools::calculateConvexHull2d(
-                    // Inputs
-                    projPts,
-
-                    // Outputs
-                    ch2Pts,
-                    ch2Verts
-                );
-                if (nCh2Dims < 2) {
-                    // Degenerate projection; skip
+        // TODO - add convergence criteria to stop early when sufficiently close to answer
+        if (!finalPass) {
+            // Carry the beamWidth best cells into the next pass, skipping any that fall inside a
+            // window already selected (overlapping windows search the same basin)
+            std::stable_sort(
+                cells.begin(),
+                cells.end(),
+                [](const Cell& a, const Cell& b) { return a.obb.volume() < b.obb.volume(); }
+            );
+            windows.clear();
+            for (const Cell& cell : cells) {
+                if (static_cast<int>(windows.size()) >= beamWidth) {
+                    break;
+                }
+                const double theta = cell.obb.theta();
+                const double phi = cell.obb.phi();
+                if (!BoundBoxTools::inGridDomain(theta, phi)) {
+                    // A seed from outside the grid domain cannot focus it
                     continue;
                 }
-
-                // *** Solve optimal in-plane roll psi using rotating calipers over projected hull
-                // Gives us psi and the minimum rectangle (2d)
-                MinRect optimalRect(ConvexHullTools::rotatingCalipers(projPts));
-                // if (!mr.valid()) {
-                //  // optimalRect still carries results for degenerate small hulls; proceed
-                // }
-
-                const double psi = optimalRect.psi();
-
-                // Rotate (u, v) by psi around w to align with rectangle sides: (u', v')
-                const double cps = std::cos(psi);
-                const double sps = std::sin(psi);
-
-                // u' =  cos(psi) u + sin(psi) v
-                const Vector3 uprime = u*cps + v*sps;
-
-                // v' = -sin(psi) u + cos(psi) v
-                const Vector3 vprime = u*-sps + v*cps;
-
-                // unchanged
-                const Vector3 wprime = w;
-
-                // *** Compute min/max along (u', v', w') for current orientation
-                double minU =  1e300, maxU = -1e300;
-                double minV =  1e300, maxV = -1e300;
-                double minW =  1e300, maxW = -1e300;
-
-                const int n = static_cast<int>(pts.size());
-                for (int i = 0; i < n; ++i) {
-                    const Vector3& p = pts[i];
-                    const double pu = p.dotProduct(uprime);
-                    const double pv = p.dotProduct(vprime);
-                    const double pw = p.dotProduct(wprime);
-
-                    if (pu < minU) {
-                        minU = pu;
-                    }
-                    if (pu > maxU) {
-                        maxU = pu;
-                    }
-                    if (pv < minV) {
-                        minV = pv;
-                    }
-                    if (pv > maxV) {
-                        maxV = pv;
-                    }
-                    if (pw < minW) {
-                        minW = pw;
-                    }
-                    if (pw > maxW) {
-                        maxW = pw;
+                bool overlaps = false;
+                for (const Window& win : windows) {
+                    if (
+                        theta >= win.thetaMin && theta <= win.thetaMax &&
+                        phi >= win.phiMin && phi <= win.phiMax
+                    ) {
+                        overlaps = true;
+                        break;
                     }
                 }
-
-                // matches optimalRect.width() numerically
-                const double width  = (maxU - minU);
-
-                // matches optimalRect.height() numerically
-                const double height = (maxV - minV);
-                const double depth  = (maxW - minW);
-                const double volume = width * height * depth;
-
-                if (volume < bestVol) {
-                    bestVol   = volume;
-                    bestTheta = theta;
-                    bestPhi   = phi;
-                    bestPsi   = psi;
-
-                    // Store min/max in the rotated frame as a BoundBox
-                    bestLocalBb = BoundBox(Vector3(minU, minV, minW), Vector3(maxU, maxV, maxW));
-
-                    // Store axes that define that rotated frame in world coordinates
-                    bestAxes = Axes(uprime, vprime, wprime);
+                if (overlaps) {
+                    continue;
                 }
+                // TODO - add epsilon to these values as well
+                windows.push_back({
+                    std::max(0.0, theta - cell.thetaDelta),
+                    std::min(constants::piByTwo, theta + cell.thetaDelta),
+                    std::max(0.0, phi - cell.phiDelta),
+                    std::min(constants::piByTwo, phi + cell.phiDelta)
+                });
+            }
+            if (windows.empty()) {
+                // Nothing valid was found, nothing to refine
+                break;
             }
-        }
-
-        // TODO - add convergence criteria to stop early when sufficiently close to answer
-        if (!finalPass) {
-            // TODO - add epsilon to these values as well
-            thetaMin = std::max(0.0, bestTheta - thetaDelta);
-            thetaMax = std::min(constants::piByTwo, bestTheta + thetaDelta);
-            thetaDelta = (thetaMax - thetaMin) / steps;
-
-            phiMin = std::max(0.0, bestPhi - phiDelta);
-            phiMax = std::min(constants::piByTwo, bestPhi + phiDelta);
-            phiDelta = (phiMax - phiMin) / steps;
         }
     }
 
-    resultAxes = bestAxes;
-    resultRotations = Vector3(bestTheta, bestPhi, bestPsi);
-    return bestLocalBb;
+    resultAxes = best.axes();
+    resultRotations = best.rotations();
+    return best.localBb();
 }
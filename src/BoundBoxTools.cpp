@@ -0,0 +1,1500 @@
+#include "gaden/BoundBoxTools.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+#include "gaden/ConvexHullTools.hpp"
+#include "gaden/Logger.hpp"
+#include "gaden/PointCloudTools.hpp"
+#include "gaden/SmallHullSolver.hpp"
+
+namespace { // anonymous
+
+// A rectangular patch of (theta, phi) space, with its centre evaluation and volume lower bound
+struct Patch {
+    double thetaMin;
+    double thetaMax;
+    double phiMin;
+    double phiMax;
+    double lowerBound;
+    gaden::OrientedBoundBox centre;
+
+    // Upper bound on the angle between the centre direction and any direction in the patch:
+    //  travel along the meridian to the target phi, then along the parallel to the target theta,
+    //  whose arc length is at most dTheta*cos(phiMin) for phi in [0, pi/2]
+    double angularRadius() const {
+        const double r =
+            0.5*(phiMax - phiMin) + 0.5*(thetaMax - thetaMin)*std::cos(phiMin);
+        return std::min(r, gaden::constants::pi);
+    }
+
+    // Order for a min-heap on lowerBound
+    bool operator>(const Patch& rhs) const { return lowerBound > rhs.lowerBound; }
+};
+
+
+// Eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations, returned as the columns of
+// vecs, sorted by decreasing eigenvalue
+void symmetricEigen3(double a[3][3], double vals[3], gaden::Vector3 vecs[3]) {
+    double v[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        const double off = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+        if (off < 1e-30) {
+            break;
+        }
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (std::fabs(a[p][q]) < 1e-300) {
+                    continue;
+                }
+                const double tau = (a[q][q] - a[p][p])/(2.0*a[p][q]);
+                const double t = (tau >= 0.0 ? 1.0 : -1.0)/(std::fabs(tau) + std::sqrt(1.0 + tau*tau));
+                const double c = 1.0/std::sqrt(1.0 + t*t);
+                const double s = t*c;
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = a[k][p];
+                    const double akq = a[k][q];
+                    a[k][p] = c*akp - s*akq;
+                    a[k][q] = s*akp + c*akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = a[p][k];
+                    const double aqk = a[q][k];
+                    a[p][k] = c*apk - s*aqk;
+                    a[q][k] = s*apk + c*aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = v[k][p];
+                    const double vkq = v[k][q];
+                    v[k][p] = c*vkp - s*vkq;
+                    v[k][q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+    int order[3] = {0, 1, 2};
+    std::sort(order, order + 3, [&](int i, int j) { return a[i][i] > a[j][j]; });
+    for (int i = 0; i < 3; ++i) {
+        const int k = order[i];
+        vals[i] = a[k][k];
+        vecs[i] = gaden::Vector3(v[0][k], v[1][k], v[2][k]);
+    }
+}
+
+
+// evaluateOrientation, with an optional coherent sweep state
+gaden::OrientedBoundBox evaluateOrientationImpl(
+    const gaden::Vector3Field& pts,
+    double theta,
+    double phi,
+    double epsilon,
+    gaden::BoundBoxTools::SweepState* state
+) {
+    using namespace gaden;
+    OrientedBoundBox result;
+
+    // *** Build (u, v, w) from (theta, phi)
+    Vector3 u;
+    Vector3 v;
+    Vector3 w;
+    if (!PointCloudTools::calculateProjectionFrame(theta, phi, u, v, w)) {
+        return result;
+    }
+
+    // *** Project to 2D and compute convex hull in that (u,v) plane
+    IndexedVector2Field projPts;
+    const bool coherent = state && state->m_coherent;
+    if (coherent) {
+        PointCloudTools::projectPointsToPlaneCoherent(
+            pts, theta, phi, epsilon, state->m_order, projPts
+        );
+    } else {
+        PointCloudTools::projectPointsToPlane(pts, theta, phi, epsilon, projPts);
+    }
+
+    IndexedVector2Field ch2Pts;
+    IndexField ch2Verts;
+    int nCh2Dims = ConvexHullTools::calculateConvexHull2d(
+        // Inputs
+        projPts,
+
+        // Outputs
+        ch2Pts,
+        ch2Verts
+    );
+    if (nCh2Dims < 2) {
+        // Degenerate projection; skip
+        return result;
+    }
+
+    // *** Solve optimal in-plane roll psi using rotating calipers over projected hull
+    MinRect optimalRect;
+    if (coherent) {
+        optimalRect = ConvexHullTools::rotatingCalipersFast(ch2Pts, state->m_supports);
+    } else {
+        optimalRect = ConvexHullTools::rotatingCalipersFast(ch2Pts);
+    }
+    const double psi = optimalRect.psi();
+
+    // Rotate (u, v) by psi around w to align with rectangle sides: (u', v')
+    const double cps = std::cos(psi);
+    const double sps = std::sin(psi);
+
+    // u' =  cos(psi) u + sin(psi) v
+    const Vector3 uprime = u*cps + v*sps;
+
+    // v' = -sin(psi) u + cos(psi) v
+    const Vector3 vprime = u*-sps + v*cps;
+
+    // unchanged
+    const Vector3 wprime = w;
+
+    // *** Compute min/max along (u', v', w') for current orientation
+    result.axes() = Axes(uprime, vprime, wprime);
+    if (state && state->m_hullHierarchy) {
+        result.localBb() = state->m_hullHierarchy->extents(result.axes());
+    } else if (state && state->m_hullGraph) {
+        result.localBb() = state->m_hullGraph->extents(result.axes(), state->m_extremes);
+    } else {
+        double minU =  1e300, maxU = -1e300;
+        double minV =  1e300, maxV = -1e300;
+        double minW =  1e300, maxW = -1e300;
+
+        const gaden::index_t n = static_cast<gaden::index_t>(pts.size());
+        for (gaden::index_t i = 0; i < n; ++i) {
+            const Vector3& p = pts[i];
+            const double pu = p.dotProduct(uprime);
+            const double pv = p.dotProduct(vprime);
+            const double pw = p.dotProduct(wprime);
+
+            minU = std::min(minU, pu);
+            maxU = std::max(maxU, pu);
+            minV = std::min(minV, pv);
+            maxV = std::max(maxV, pv);
+            minW = std::min(minW, pw);
+            maxW = std::max(maxW, pw);
+        }
+        result.localBb() = BoundBox(Vector3(minU, minV, minW), Vector3(maxU, maxV, maxW));
+    }
+    const Vector3 span = result.localBb().maxPt() - result.localBb().minPt();
+
+    result.valid() = true;
+    result.volume() = span.x()*span.y()*span.z();
+    result.theta() = theta;
+    result.phi() = phi;
+    result.psi() = psi;
+    return result;
+}
+
+
+// A projected point for the single precision screening kernel, half the size of IndexedVector2
+struct Point2f {
+    float x;
+    float y;
+
+    bool operator<(const Point2f& rhs) const {
+        return x < rhs.x || (x == rhs.x && y < rhs.y);
+    }
+};
+
+
+// Order-preserving map from a float to an unsigned key, as PointCloudTools::radixSortLexicographic
+inline std::uint32_t orderedKeyFloat32(float val) {
+    val += 0.0f;
+    std::uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+
+// Sort by (x, y).  std::sort for small inputs, otherwise an LSD radix sort on the x key, four
+// 8-bit passes moving the 8-byte points directly, then runs of equal x are sorted by y.
+void sortFloat32(std::vector<Point2f>& pts) {
+    const gaden::index_t n = static_cast<gaden::index_t>(pts.size());
+    if (n < 512) {
+        std::sort(pts.begin(), pts.end());
+        return;
+    }
+    gaden::index_t counts[4][256] = {};
+    for (const Point2f& p : pts) {
+        const std::uint32_t key = orderedKeyFloat32(p.x);
+        for (int pass = 0; pass < 4; ++pass) {
+            ++counts[pass][(key >> (8*pass)) & 0xff];
+        }
+    }
+    std::vector<Point2f> scratch(n);
+    for (int pass = 0; pass < 4; ++pass) {
+        gaden::index_t* count = counts[pass];
+        const int shift = 8*pass;
+        if (count[(orderedKeyFloat32(pts[0].x) >> shift) & 0xff] == n) {
+            continue;
+        }
+        gaden::index_t offset = 0;
+        for (int d = 0; d < 256; ++d) {
+            const gaden::index_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (const Point2f& p : pts) {
+            scratch[count[(orderedKeyFloat32(p.x) >> shift) & 0xff]++] = p;
+        }
+        pts.swap(scratch);
+    }
+    for (gaden::index_t k = 0; k < n - 1; ++k) {
+        if (!(pts[k].x == pts[k + 1].x)) {
+            continue;
+        }
+        gaden::index_t end = k + 1;
+        while (end < n && pts[end].x == pts[k].x) {
+            ++end;
+        }
+        std::sort(pts.begin() + k, pts.begin() + end);
+        k = end - 1;
+    }
+}
+
+
+// (b - a) x (c - a)
+inline float cross2f(const Point2f& a, const Point2f& b, const Point2f& c) {
+    return (b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x);
+}
+
+
+// Minimum area of a rectangle enclosing the counter-clockwise convex polygon hull, by rotating
+// calipers with one side flush to each edge in turn.  Areas only, in single precision.
+float minRectAreaFloat32(const std::vector<Point2f>& hull) {
+    const gaden::index_t n = static_cast<gaden::index_t>(hull.size());
+    float best = std::numeric_limits<float>::infinity();
+    gaden::index_t right = 1;
+    gaden::index_t top = 1;
+    gaden::index_t left = 1;
+    for (gaden::index_t i = 0; i < n; ++i) {
+        const Point2f& a = hull[i];
+        const Point2f& b = hull[(i + 1) % n];
+        const float ex = b.x - a.x;
+        const float ey = b.y - a.y;
+        auto along = [&](gaden::index_t k) { return ex*hull[k].x + ey*hull[k].y; };
+
+        // Supports advance monotonically: furthest along e, furthest from e, then least along e
+        if (i == 0) {
+            right = 1 % n;
+        }
+        while (along((right + 1) % n) > along(right)) {
+            right = (right + 1) % n;
+        }
+        if (i == 0) {
+            top = right;
+        }
+        while (cross2f(a, b, hull[(top + 1) % n]) > cross2f(a, b, hull[top])) {
+            top = (top + 1) % n;
+        }
+        if (i == 0) {
+            left = top;
+        }
+        while (along((left + 1) % n) < along(left)) {
+            left = (left + 1) % n;
+        }
+        const float area =
+            cross2f(a, b, hull[top])*(along(right) - along(left))/(ex*ex + ey*ey);
+        best = std::min(best, area);
+    }
+    return best;
+}
+
+} // end anonymous namespace
+
+
+void gaden::BoundBoxTools::directionToAngles(
+    const Vector3& w,
+    double& thetaOut,
+    double& phiOut
+) {
+    Vector3 d(w);
+    if (d.z() < 0.0) {
+        d *= -1.0;
+    }
+    d.normalise();
+    thetaOut = std::atan2(d.y(), d.x());
+    if (thetaOut < 0.0) {
+        thetaOut += 2.0*constants::pi;
+    }
+    phiOut = std::asin(std::min(1.0, d.z()));
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::evaluateOrientation(
+    const Vector3Field& pts,
+    double theta,
+    double phi,
+    double epsilon
+) {
+    return evaluateOrientationImpl(pts, theta, phi, epsilon, nullptr);
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::evaluateOrientation(
+    const Vector3Field& pts,
+    double theta,
+    double phi,
+    double epsilon,
+    SweepState& state
+) {
+    return evaluateOrientationImpl(pts, theta, phi, epsilon, &state);
+}
+
+
+double gaden::BoundBoxTools::VolumeBoundData::projectedArea(const Vector3& w) const {
+    double sum = 0.0;
+    for (const Vector3& an : m_faceAreaNormals) {
+        sum += std::fabs(an.dotProduct(w));
+    }
+    return 0.5*sum;
+}
+
+
+gaden::BoundBoxTools::VolumeBoundData gaden::BoundBoxTools::calculateVolumeBoundData(
+    const Vector3Field& pts,
+    double epsilon,
+    bool withHull
+) {
+    VolumeBoundData bounds;
+    const index_t nPts = static_cast<index_t>(pts.size());
+    if (nPts == 0) {
+        return bounds;
+    }
+
+    for (const Vector3& p : pts) {
+        bounds.m_centre += p;
+    }
+    bounds.m_centre /= nPts;
+    for (const Vector3& p : pts) {
+        bounds.m_radius = std::max(bounds.m_radius, (p - bounds.m_centre).mag());
+    }
+    if (!withHull) {
+        return bounds;
+    }
+
+    Vector3Field chPts;
+    IndexField chVerts;
+    std::vector<Face> chFaces;
+    int nDims = ConvexHullTools::calculateConvexHull3d(pts, epsilon, chPts, chVerts, chFaces);
+    if (nDims < 3) {
+        // Flat or degenerate, only the support function bound applies
+        return bounds;
+    }
+
+    for (const Face& f : chFaces) {
+        if (!f.alive()) {
+            continue;
+        }
+        const Vector3& pA = pts[f.a()];
+        const Vector3& pB = pts[f.b()];
+        const Vector3& pC = pts[f.c()];
+        const double area = 0.5*(pB - pA).crossProduct(pC - pA).mag();
+        bounds.m_faceAreaNormals.push_back(f.normal()*area);
+        bounds.m_surfaceArea += area;
+
+        // Tetrahedron volume from the centre, which lies inside the hull
+        bounds.m_hullVolume += area*std::fabs(f.signedDistance(bounds.m_centre))/3.0;
+    }
+    return bounds;
+}
+
+
+double gaden::BoundBoxTools::volumeLowerBound(
+    const VolumeBoundData& bounds,
+    const OrientedBoundBox& centre,
+    double angularRadius
+) {
+    if (!centre.valid()) {
+        return bounds.m_hullVolume;
+    }
+    const double r = std::min(angularRadius, constants::pi);
+
+    // A support pair spans at most the diameter, so any width changes by at most delta when its
+    // direction turns through r: |w - c| <= chord
+    const double chord = 2.0*std::sin(0.5*r);
+    const double delta = 2.0*bounds.m_radius*chord;
+
+    const BoundBox& bb = centre.localBb();
+    const Vector3 widths = bb.maxPt() - bb.minPt();
+    const double depthLower = std::max(0.0, widths.z() - delta);
+
+    // Turning the optimal frame of a patch direction onto the centre direction gives a frame there,
+    // no better than the centre box (optimal over psi): (a + delta)(b + delta) >= A, for the
+    // frame's face widths a, b.  Both are at most M, the centre face diagonal (or diameter) plus
+    // delta, and ab over that constraint is least at a = M.
+    const double area = widths.x()*widths.y();
+    const double maxWidth =
+        std::min(2.0*bounds.m_radius, std::hypot(widths.x(), widths.y())) + delta;
+    const double rotatedArea = std::max(0.0, maxWidth*(area/(maxWidth + delta) - delta));
+
+    // The box face also covers the hull shadow.  Least |a_f . w| over the patch per face: the
+    // normal's angle to w grows by at most r, down to zero once it can reach 90 degrees.
+    double shadowArea = 0.0;
+    if (r < constants::piByTwo) {
+        const Vector3& w = centre.axes().z();
+        const double cosR = std::cos(r);
+        const double sinR = std::sin(r);
+        for (const Vector3& an : bounds.m_faceAreaNormals) {
+            const double along = std::fabs(an.dotProduct(w));
+            const double across = std::sqrt(std::max(0.0, an.magSqr() - along*along));
+            shadowArea += std::max(0.0, along*cosR - across*sinR);
+        }
+        shadowArea *= 0.5;
+    }
+
+    return std::max(bounds.m_hullVolume, depthLower*std::max(rotatedArea, shadowArea));
+}
+
+
+gaden::BoundBox gaden::BoundBoxTools::solveBranchAndBound(
+    // outputs
+    Axes& resultAxes, Vector3& resultRotations,
+    double& optimalityGapOut, int& nEvaluationsOut,
+
+    // inputs
+    const Vector3Field& pts, double relativeGap, int maxEvaluations, double epsilon,
+    const OrientedBoundBox& seed, const ConvexHullGraph* hullGraph,
+    const ConvexHullHierarchy* hullHierarchy, const StopCondition* stop
+) {
+    // Under a deadline the hull rebuild would come before the first evaluation, go without it
+    const VolumeBoundData bounds = calculateVolumeBoundData(pts, epsilon, stop == nullptr);
+
+    // Box extents by hill-climbing on the hull graph, children are evaluated next to their parent
+    SweepState sweep;
+    sweep.m_coherent = false;
+    sweep.m_hullGraph = (hullGraph && !hullGraph->empty()) ? hullGraph : nullptr;
+    sweep.m_hullHierarchy = (hullHierarchy && !hullHierarchy->empty()) ? hullHierarchy : nullptr;
+
+    OrientedBoundBox best(seed);
+    int nEvaluations = 0;
+    std::priority_queue<Patch, std::vector<Patch>, std::greater<Patch>> open;
+
+    // Evaluate a patch centre, update incumbent, keep the patch if it can still improve
+    auto evaluatePatch = [&](Patch patch, double parentLowerBound) {
+        const double theta = 0.5*(patch.thetaMin + patch.thetaMax);
+        const double phi = 0.5*(patch.phiMin + patch.phiMax);
+        patch.centre = evaluateOrientation(pts, theta, phi, epsilon, sweep);
+        ++nEvaluations;
+        if (patch.centre.betterThan(best)) {
+            best = patch.centre;
+        }
+        patch.lowerBound = std::max(
+            parentLowerBound,
+            volumeLowerBound(bounds, patch.centre, patch.angularRadius())
+        );
+        if (patch.lowerBound < best.volume()*(1.0 - relativeGap)) {
+            open.push(patch);
+        }
+    };
+
+    // Initial subdivision of the polar cap
+    const double phiLow = std::asin(1.0/std::sqrt(3.0));
+    const int nTheta = 8;
+    const int nPhi = 2;
+    const double dTheta = 2.0*constants::pi/nTheta;
+    const double dPhi = (constants::piByTwo - phiLow)/nPhi;
+    bool covered = true;
+    for (int thetaI = 0; thetaI < nTheta && covered; ++thetaI) {
+        for (int phiI = 0; phiI < nPhi; ++phiI) {
+            if (stop && best.valid() && stop->reached()) {
+                // Part of the domain is unbounded, nothing can be certified
+                covered = false;
+                break;
+            }
+            Patch patch;
+            patch.thetaMin = thetaI*dTheta;
+            patch.thetaMax = (thetaI + 1)*dTheta;
+            patch.phiMin = phiLow + phiI*dPhi;
+            patch.phiMax = phiLow + (phiI + 1)*dPhi;
+            evaluatePatch(patch, 0.0);
+        }
+    }
+
+    // Best-first refinement
+    double globalLowerBound = best.volume();
+    while (covered && !open.empty()) {
+        Patch patch = open.top();
+        globalLowerBound = patch.lowerBound;
+        if (patch.lowerBound >= best.volume()*(1.0 - relativeGap)) {
+            // All remaining patches are within the gap (heap is ordered), done
+            break;
+        }
+        if (nEvaluations + 4 > maxEvaluations) {
+            Log_Debug("Evaluation limit reached, " << open.size() << " patches remain open");
+            break;
+        }
+        if (stop && stop->reached()) {
+            Log_Debug("Stopped, " << open.size() << " patches remain open");
+            break;
+        }
+        open.pop();
+
+        const double thetaMid = 0.5*(patch.thetaMin + patch.thetaMax);
+        const double phiMid = 0.5*(patch.phiMin + patch.phiMax);
+        const double thetaCuts[3] = {patch.thetaMin, thetaMid, patch.thetaMax};
+        const double phiCuts[3] = {patch.phiMin, phiMid, patch.phiMax};
+        for (int i = 0; i < 2; ++i) {
+            for (int j = 0; j < 2; ++j) {
+                Patch child;
+                child.thetaMin = thetaCuts[i];
+                child.thetaMax = thetaCuts[i + 1];
+                child.phiMin = phiCuts[j];
+                child.phiMax = phiCuts[j + 1];
+                evaluatePatch(child, patch.lowerBound);
+            }
+        }
+        Log_Debug4(""
+            << "evaluations=" << nEvaluations << ", open=" << open.size()
+            << ", incumbent=" << best.volume() << ", lowerBound=" << patch.lowerBound
+        );
+    }
+    if (!covered) {
+        globalLowerBound = 0.0;
+    } else if (open.empty()) {
+        // Everything pruned, the incumbent is within relativeGap of the optimum
+        globalLowerBound = best.volume()*(1.0 - relativeGap);
+    }
+
+    optimalityGapOut = 0.0;
+    if (best.valid() && best.volume() > 0.0) {
+        optimalityGapOut = std::max(0.0, (best.volume() - globalLowerBound)/best.volume());
+    }
+    nEvaluationsOut = nEvaluations;
+    Log_Debug(""
+        << "Branch-and-bound: evaluations=" << nEvaluations << ", volume=" << best.volume()
+        << ", gap=" << optimalityGapOut
+    );
+
+    resultAxes = best.axes();
+    resultRotations = best.rotations();
+    return best.localBb();
+}
+
+
+
+gaden::BoundBox gaden::BoundBoxTools::solveAnytime(
+    // outputs
+    Axes& resultAxes, Vector3& resultRotations,
+    double& optimalityGapOut, int& nEvaluationsOut,
+
+    // inputs
+    const Vector3Field& pts, const StopCondition& stop, double epsilon,
+    const OrientedBoundBox& seed, const ConvexHullGraph* hullGraph,
+    const ConvexHullHierarchy* hullHierarchy
+) {
+    OrientedBoundBox incumbent(seed);
+    if (!incumbent.valid() && !pts.empty()) {
+        // Principal axes of the points, solveSeeded would rebuild the hull first
+        Vector3 mean;
+        for (const Vector3& p : pts) {
+            mean += p;
+        }
+        mean /= static_cast<double>(pts.size());
+        double covariance[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+        for (const Vector3& p : pts) {
+            const Vector3 d(p - mean);
+            const double x[3] = {d.x(), d.y(), d.z()};
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    covariance[i][j] += x[i]*x[j];
+                }
+            }
+        }
+        double eigenValues[3];
+        Vector3 eigenVectors[3];
+        symmetricEigen3(covariance, eigenValues, eigenVectors);
+        incumbent = evaluateDirections(
+            pts,
+            std::vector<Vector3>(eigenVectors, eigenVectors + 3),
+            epsilon
+        );
+    }
+    if (incumbent.valid() && stop.reached()) {
+        // Out of time already, nothing certified
+        optimalityGapOut = 1.0;
+        nEvaluationsOut = 0;
+        resultAxes = incumbent.axes();
+        resultRotations = incumbent.rotations();
+        return incumbent.localBb();
+    }
+    return solveBranchAndBound(
+        resultAxes, resultRotations, optimalityGapOut, nEvaluationsOut,
+        pts, 1e-9, std::numeric_limits<int>::max(), epsilon, incumbent, hullGraph, hullHierarchy,
+        &stop
+    );
+}
+
+gaden::BoundBox gaden::BoundBoxTools::solveAutoTuned(
+    // outputs
+    Axes& resultAxes, Vector3& resultRotations, AutoTuneReport& reportOut,
+
+    // inputs
+    const Vector3Field& pts, double targetAccuracy, double timeBudgetMs, double epsilon,
+    const OrientedBoundBox& seed, const ConvexHullGraph* hullGraph,
+    const ConvexHullHierarchy* hullHierarchy
+) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const auto elapsedMs = [&]() {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+    };
+    const int minSteps = 3;
+    const int coarseSteps = 12;
+    const int refineSteps = 9;
+    const int maxSteps = 64;
+    const int maxPasses = 12;
+    const int maxBasins = 3;
+    const int maxCertifyEvaluations = 20000;
+    reportOut = AutoTuneReport();
+    targetAccuracy = std::max(targetAccuracy, 1e-12);
+
+    SweepState sweep;
+    sweep.m_coherent = true;
+    sweep.m_hullGraph = (hullGraph && !hullGraph->empty()) ? hullGraph : nullptr;
+    sweep.m_hullHierarchy = (hullHierarchy && !hullHierarchy->empty()) ? hullHierarchy : nullptr;
+    OrientedBoundBox best(seed);
+    const auto evaluate = [&](double theta, double phi) {
+        const OrientedBoundBox candidate(evaluateOrientation(pts, theta, phi, epsilon, sweep));
+        ++reportOut.m_nEvaluations;
+        if (candidate.betterThan(best)) {
+            best = candidate;
+        }
+        return candidate;
+    };
+
+    // Cost per evaluation, from a diagonal of the domain
+    const int nProbes = 8;
+    for (int k = 0; k < nProbes; ++k) {
+        const double t = (k + 0.5)*constants::piByTwo/nProbes;
+        evaluate(t, t);
+    }
+    reportOut.m_evaluationMs = elapsedMs()/nProbes;
+
+    // Largest square pass that fits in the given fraction of the budget, less the time spent
+    const auto stepsInBudget = [&](double fraction) {
+        if (timeBudgetMs <= 0.0) {
+            return maxSteps;
+        }
+        const double evaluationsLeft =
+            (fraction*timeBudgetMs - elapsedMs())/std::max(reportOut.m_evaluationMs, 1e-9);
+        return static_cast<int>(std::sqrt(std::max(evaluationsLeft, 0.0)));
+    };
+
+    // *** Coarse pass over the whole domain, at most a third of the budget.  A model fitted in
+    // one basin says nothing of the others, so this pass is never skipped for the model's sake.
+    const int nCoarse = std::max(minSteps, std::min(coarseSteps, stepsInBudget(1.0/3.0)));
+    const double coarseCell = constants::piByTwo/nCoarse;
+    std::vector<double> coarseVolumes(nCoarse*nCoarse, std::numeric_limits<double>::max());
+    for (int thetaI = 0; thetaI < nCoarse; ++thetaI) {
+        for (int k = 0; k < nCoarse; ++k) {
+            const int phiI = thetaI % 2 == 1 ? nCoarse - 1 - k : k;
+            const OrientedBoundBox candidate(evaluate(thetaI*coarseCell, phiI*coarseCell));
+            if (candidate.valid()) {
+                coarseVolumes[thetaI*nCoarse + phiI] = candidate.volume();
+            }
+        }
+    }
+    reportOut.m_steps.push_back(nCoarse);
+    if (!best.valid()) {
+        resultAxes = best.axes();
+        resultRotations = best.rotations();
+        return best.localBb();
+    }
+
+    // Basins: the coarse cells no larger than any of their neighbours, best first
+    std::vector<std::pair<double, int>> basins;
+    for (int thetaI = 0; thetaI < nCoarse; ++thetaI) {
+        for (int phiI = 0; phiI < nCoarse; ++phiI) {
+            const double volume = coarseVolumes[thetaI*nCoarse + phiI];
+            bool minimum = volume < std::numeric_limits<double>::max();
+            for (int i = thetaI - 1; i <= thetaI + 1 && minimum; ++i) {
+                for (int j = phiI - 1; j <= phiI + 1; ++j) {
+                    if (i >= 0 && i < nCoarse && j >= 0 && j < nCoarse
+                     && coarseVolumes[i*nCoarse + j] < volume) {
+                        minimum = false;
+                        break;
+                    }
+                }
+            }
+            if (minimum) {
+                basins.emplace_back(volume, thetaI*nCoarse + phiI);
+            }
+        }
+    }
+    std::sort(basins.begin(), basins.end());
+    if (static_cast<int>(basins.size()) > maxBasins) {
+        basins.resize(maxBasins);
+    }
+
+    // *** Refine each basin on its own.  The relative volume error after a pass is modelled as
+    // C*h^2; C is fitted to the improvement each pass makes and sizes the next.  The model only
+    // says when to stop refining, the result is certified below.  Refinement takes at most two
+    // thirds of the budget.
+    for (const std::pair<double, int>& basin : basins) {
+        OrientedBoundBox basinBest;
+        double centreTheta = (basin.second/nCoarse)*coarseCell;
+        double centrePhi = (basin.second % nCoarse)*coarseCell;
+        double previousVolume = basin.first;
+        double previousCell = coarseCell;
+        double prediction = -1.0;
+        double estimate = -1.0;
+        double coefficient = -1.0;
+        int nFits = 0;
+        int steps = std::min(refineSteps, stepsInBudget(2.0/3.0));
+        for (int passI = 0; passI < maxPasses && steps >= minSteps; ++passI) {
+            const double thetaMin = std::max(0.0, centreTheta - previousCell);
+            const double thetaMax = std::min(constants::piByTwo, centreTheta + previousCell);
+            const double phiMin = std::max(0.0, centrePhi - previousCell);
+            const double phiMax = std::min(constants::piByTwo, centrePhi + previousCell);
+            const double thetaDelta = (thetaMax - thetaMin)/steps;
+            const double phiDelta = (phiMax - phiMin)/steps;
+            for (int thetaI = 0; thetaI < steps; ++thetaI) {
+                for (int k = 0; k < steps; ++k) {
+                    const int phiI = thetaI % 2 == 1 ? steps - 1 - k : k;
+                    const OrientedBoundBox candidate(
+                        evaluate(thetaMin + thetaI*thetaDelta, phiMin + phiI*phiDelta)
+                    );
+                    if (candidate.betterThan(basinBest)) {
+                        basinBest = candidate;
+                    }
+                }
+            }
+            reportOut.m_steps.push_back(steps);
+            if (!basinBest.valid()) {
+                break;
+            }
+
+            // One pass can improve by chance less than the model says, so keep the largest C
+            // seen and only trust it once two passes have been fitted
+            const double cell = std::max(thetaDelta, phiDelta);
+            if (previousCell > cell) {
+                const double improvement =
+                    std::max(0.0, previousVolume - basinBest.volume())/basinBest.volume();
+                coefficient = std::max(
+                    coefficient, improvement/(previousCell*previousCell - cell*cell)
+                );
+                ++nFits;
+                estimate = coefficient*cell*cell;
+            }
+            Log_Debug(""
+                << "Auto-tuned basin " << basin.second << " pass " << passI << ", steps "
+                << steps << ", volume " << basinBest.volume() << ", estimated error " << estimate
+            );
+            if (nFits >= 2 && estimate <= targetAccuracy) {
+                break;
+            }
+
+            // Next window, centred on the basin's best box, with the fewest steps predicted to
+            // reach the target within the budget
+            centreTheta = basinBest.theta();
+            centrePhi = basinBest.phi();
+            const double nextWindow = 2.0*cell;
+            if (coefficient >= 0.0) {
+                steps = static_cast<int>(
+                    std::ceil(nextWindow*std::sqrt(coefficient/targetAccuracy))
+                );
+                steps = std::max(minSteps, std::min(maxSteps, steps));
+            }
+            steps = std::min(steps, stepsInBudget(2.0/3.0));
+            if (coefficient >= 0.0) {
+                const double nextCell = nextWindow/std::max(steps, 1);
+                prediction = coefficient*nextCell*nextCell;
+            }
+            previousVolume = basinBest.volume();
+            previousCell = cell;
+        }
+        ++reportOut.m_nBasins;
+        if (basinBest.valid() && !basinBest.betterThan(best)) {
+            // This basin holds the best box (equal volume), its model figures are the ones to show
+            reportOut.m_predictedError = prediction;
+            reportOut.m_estimatedError = estimate;
+        }
+    }
+
+    // *** Certify: branch-and-bound from the best box, to the target gap or the end of the budget
+    StopCondition stop;
+    if (timeBudgetMs > 0.0) {
+        stop.m_deadline = start + std::chrono::microseconds(
+            static_cast<long long>(timeBudgetMs*1e3)
+        );
+    }
+    double gap = 1.0;
+    int nCertifyEvaluations = 0;
+    const BoundBox result(solveBranchAndBound(
+        resultAxes, resultRotations, gap, nCertifyEvaluations,
+        pts, targetAccuracy,
+        timeBudgetMs > 0.0 ? std::numeric_limits<int>::max() : maxCertifyEvaluations,
+        epsilon, best, hullGraph, hullHierarchy, timeBudgetMs > 0.0 ? &stop : nullptr
+    ));
+    reportOut.m_nEvaluations += nCertifyEvaluations;
+    reportOut.m_achievedError = gap;
+    Log_Debug(""
+        << "Auto-tuned grid, " << reportOut.m_steps.size() << " passes in "
+        << reportOut.m_nBasins << " basins, " << reportOut.m_nEvaluations << " evaluations in "
+        << elapsedMs() << " ms, certified gap " << gap
+    );
+    return result;
+}
+
+std::vector<gaden::Vector3> gaden::BoundBoxTools::calculateSeedDirections(
+    const Vector3Field& pts,
+    double epsilon,
+    int maxFaceNormals
+) {
+    std::vector<Vector3> directions;
+
+    Vector3Field chPts;
+    IndexField chVerts;
+    std::vector<Face> chFaces;
+    int nDims = ConvexHullTools::calculateConvexHull3d(pts, epsilon, chPts, chVerts, chFaces);
+    if (nDims < 3) {
+        return directions;
+    }
+
+    // *** Principal axes of the hull surface, area-weighted second moments of the triangles
+    //  integral of x x^T over a triangle = A/12 (a a^T + b b^T + c c^T + s s^T), s = a + b + c
+    double totalArea = 0.0;
+    Vector3 firstMoment;
+    double secondMoment[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+    // Dominant face normals as (direction, total area)
+    std::vector<std::pair<Vector3, double>> normalGroups;
+    const double parallelCos = std::cos(constants::pi/180.0);
+
+    for (const Face& f : chFaces) {
+        if (!f.alive()) {
+            continue;
+        }
+        const Vector3& pA = pts[f.a()];
+        const Vector3& pB = pts[f.b()];
+        const Vector3& pC = pts[f.c()];
+        const double area = 0.5*(pB - pA).crossProduct(pC - pA).mag();
+        if (area <= 0.0) {
+            continue;
+        }
+        totalArea += area;
+        const Vector3 s = pA + pB + pC;
+        firstMoment += s*(area/3.0);
+        const Vector3 corners[4] = {pA, pB, pC, s};
+        for (const Vector3& c : corners) {
+            const double x[3] = {c.x(), c.y(), c.z()};
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    secondMoment[i][j] += area/12.0*x[i]*x[j];
+                }
+            }
+        }
+
+        bool grouped = false;
+        for (std::pair<Vector3, double>& group : normalGroups) {
+            if (std::fabs(group.first.dotProduct(f.normal())) >= parallelCos) {
+                group.second += area;
+                grouped = true;
+                break;
+            }
+        }
+        if (!grouped) {
+            normalGroups.emplace_back(f.normal(), area);
+        }
+    }
+    if (totalArea <= 0.0) {
+        return directions;
+    }
+
+    const Vector3 mean = firstMoment/totalArea;
+    const double m[3] = {mean.x(), mean.y(), mean.z()};
+    double covariance[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            covariance[i][j] = secondMoment[i][j]/totalArea - m[i]*m[j];
+        }
+    }
+    double eigenValues[3];
+    Vector3 eigenVectors[3];
+    symmetricEigen3(covariance, eigenValues, eigenVectors);
+    for (const Vector3& axis : eigenVectors) {
+        directions.push_back(axis);
+    }
+
+    std::sort(
+        normalGroups.begin(),
+        normalGroups.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; }
+    );
+    const int nNormals = std::min(maxFaceNormals, static_cast<int>(normalGroups.size()));
+    for (int i = 0; i < nNormals; ++i) {
+        directions.push_back(normalGroups[i].first);
+    }
+    return directions;
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::evaluateDirections(
+    const Vector3Field& pts,
+    const std::vector<Vector3>& directions,
+    double epsilon
+) {
+    OrientedBoundBox best;
+    for (const Vector3& w : directions) {
+        double theta;
+        double phi;
+        directionToAngles(w, theta, phi);
+        const OrientedBoundBox candidate(evaluateOrientation(pts, theta, phi, epsilon));
+        if (candidate.betterThan(best)) {
+            best = candidate;
+        }
+    }
+    if (!best.valid()) {
+        return best;
+    }
+
+    // Any axis of the box can be the look direction, try the other two
+    const Vector3 otherAxes[2] = {best.axes().x(), best.axes().y()};
+    const double bestVolume = best.volume();
+    for (const Vector3& w : otherAxes) {
+        double theta;
+        double phi;
+        directionToAngles(w, theta, phi);
+        const OrientedBoundBox candidate(evaluateOrientation(pts, theta, phi, epsilon));
+        if (!candidate.valid()) {
+            continue;
+        }
+        // Equal volumes (to round-off) are the same box seen along another axis
+        const bool moveIntoDomain =
+            !inGridDomain(best.theta(), best.phi())
+         && inGridDomain(theta, phi)
+         && candidate.volume() <= bestVolume*(1.0 + 1e-9);
+        if (candidate.betterThan(best) || moveIntoDomain) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::solveSeeded(
+    const Vector3Field& pts,
+    double epsilon,
+    int maxFaceNormals
+) {
+    const std::vector<Vector3> directions(calculateSeedDirections(pts, epsilon, maxFaceNormals));
+    OrientedBoundBox best(evaluateDirections(pts, directions, epsilon));
+    Log_Debug(""
+        << "Seeded from " << directions.size() << " candidate directions, best " << best
+    );
+    return best;
+}
+
+
+gaden::BoundBoxTools::Float32Points gaden::BoundBoxTools::makeFloat32Points(
+    const Vector3Field& pts
+) {
+    Float32Points result;
+    if (pts.empty()) {
+        return result;
+    }
+    BoundBox bb;
+    for (const Vector3& p : pts) {
+        bb.minPt() = Vector3(
+            std::min(bb.minPt().x(), p.x()),
+            std::min(bb.minPt().y(), p.y()),
+            std::min(bb.minPt().z(), p.z())
+        );
+        bb.maxPt() = Vector3(
+            std::max(bb.maxPt().x(), p.x()),
+            std::max(bb.maxPt().y(), p.y()),
+            std::max(bb.maxPt().z(), p.z())
+        );
+    }
+    result.m_centre = (bb.minPt() + bb.maxPt())*0.5;
+    const Vector3 halfSpan = (bb.maxPt() - bb.minPt())*0.5;
+    result.m_scale = std::max(halfSpan.x(), std::max(halfSpan.y(), halfSpan.z()));
+    if (result.m_scale <= 0.0) {
+        result.m_scale = 1.0;
+    }
+
+    const double invScale = 1.0/result.m_scale;
+    const index_t n = static_cast<index_t>(pts.size());
+    result.m_x.resize(n);
+    result.m_y.resize(n);
+    result.m_z.resize(n);
+    for (index_t i = 0; i < n; ++i) {
+        const Vector3 q = (pts[i] - result.m_centre)*invScale;
+        result.m_x[i] = static_cast<float>(q.x());
+        result.m_y[i] = static_cast<float>(q.y());
+        result.m_z[i] = static_cast<float>(q.z());
+    }
+    return result;
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::evaluateOrientationFloat32(
+    const Float32Points& fpts,
+    double theta,
+    double phi
+) {
+    OrientedBoundBox result;
+    Vector3 u;
+    Vector3 v;
+    Vector3 w;
+    const index_t n = static_cast<index_t>(fpts.m_x.size());
+    if (n < 3 || !PointCloudTools::calculateProjectionFrame(theta, phi, u, v, w)) {
+        return result;
+    }
+    const float ux = static_cast<float>(u.x());
+    const float uy = static_cast<float>(u.y());
+    const float uz = static_cast<float>(u.z());
+    const float vx = static_cast<float>(v.x());
+    const float vy = static_cast<float>(v.y());
+    const float vz = static_cast<float>(v.z());
+    const float wx = static_cast<float>(w.x());
+    const float wy = static_cast<float>(w.y());
+    const float wz = static_cast<float>(w.z());
+
+    // Projection and depth, branch-free over contiguous floats so that it vectorises
+    const float* xs = fpts.m_x.data();
+    const float* ys = fpts.m_y.data();
+    const float* zs = fpts.m_z.data();
+    std::vector<float> pu(n);
+    std::vector<float> pv(n);
+    float wMin = std::numeric_limits<float>::max();
+    float wMax = -std::numeric_limits<float>::max();
+    for (index_t i = 0; i < n; ++i) {
+        pu[i] = ux*xs[i] + uy*ys[i] + uz*zs[i];
+        pv[i] = vx*xs[i] + vy*ys[i] + vz*zs[i];
+        const float pw = wx*xs[i] + wy*ys[i] + wz*zs[i];
+        wMin = pw < wMin ? pw : wMin;
+        wMax = pw > wMax ? pw : wMax;
+    }
+
+    // Sorted projection and monotone chain hull, as ConvexHullTools::calculateConvexHull2d
+    std::vector<Point2f> proj(n);
+    for (index_t i = 0; i < n; ++i) {
+        proj[i] = Point2f{pu[i], pv[i]};
+    }
+    sortFloat32(proj);
+    std::vector<Point2f> hull;
+    hull.reserve(2*n);
+    for (index_t i = 0; i < n; ++i) {
+        while (hull.size() >= 2 && cross2f(hull[hull.size() - 2], hull.back(), proj[i]) <= 0.0f) {
+            hull.pop_back();
+        }
+        hull.push_back(proj[i]);
+    }
+    const std::size_t lowerSize = hull.size();
+    for (index_t i = n - 2; i >= 0; --i) {
+        while (
+            hull.size() > lowerSize
+         && cross2f(hull[hull.size() - 2], hull.back(), proj[i]) <= 0.0f
+        ) {
+            hull.pop_back();
+        }
+        hull.push_back(proj[i]);
+    }
+    hull.pop_back();
+    if (hull.size() < 3) {
+        // Degenerate projection
+        return result;
+    }
+
+    const double area = minRectAreaFloat32(hull);
+    const double depth = wMax - wMin;
+    result.valid() = true;
+    result.volume() = area*depth*fpts.m_scale*fpts.m_scale*fpts.m_scale;
+    result.theta() = theta;
+    result.phi() = phi;
+    return result;
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::evaluateFrame(
+    const Vector3Field& pts,
+    const Vector3& w,
+    const Vector3& u
+) {
+    OrientedBoundBox result;
+
+    // Express the frame as (theta, phi, psi), this may flip w (and therefore v)
+    double theta;
+    double phi;
+    directionToAngles(w, theta, phi);
+    Vector3 u0;
+    Vector3 v0;
+    Vector3 w0;
+    if (!PointCloudTools::calculateProjectionFrame(theta, phi, u0, v0, w0)) {
+        return result;
+    }
+    Vector3 uprime = u - w0*w0.dotProduct(u);
+    if (!uprime.normalise()) {
+        return result;
+    }
+    const double psi = std::atan2(uprime.dotProduct(v0), uprime.dotProduct(u0));
+    const Vector3 vprime = w0.crossProduct(uprime);
+    const Vector3& wprime = w0;
+
+    double minU =  1e300, maxU = -1e300;
+    double minV =  1e300, maxV = -1e300;
+    double minW =  1e300, maxW = -1e300;
+
+    const index_t n = static_cast<index_t>(pts.size());
+    for (index_t i = 0; i < n; ++i) {
+        const Vector3& p = pts[i];
+        const double pu = p.dotProduct(uprime);
+        const double pv = p.dotProduct(vprime);
+        const double pw = p.dotProduct(wprime);
+
+        minU = std::min(minU, pu);
+        maxU = std::max(maxU, pu);
+        minV = std::min(minV, pv);
+        maxV = std::max(maxV, pv);
+        minW = std::min(minW, pw);
+        maxW = std::max(maxW, pw);
+    }
+    if (n == 0) {
+        return result;
+    }
+
+    result.valid() = true;
+    result.volume() = (maxU - minU)*(maxV - minV)*(maxW - minW);
+    result.theta() = theta;
+    result.phi() = phi;
+    result.psi() = psi;
+    result.localBb() = BoundBox(Vector3(minU, minV, minW), Vector3(maxU, maxV, maxW));
+    result.axes() = Axes(uprime, vprime, wprime);
+    return result;
+}
+
+
+std::vector<std::pair<gaden::Vector3, double>> gaden::BoundBoxTools::clusterNormals(
+    const Vector3Field& normals,
+    int maxClusters,
+    double binDegrees
+) {
+    std::vector<std::pair<Vector3, double>> clusters;
+    if (maxClusters < 1 || binDegrees <= 0.0) {
+        return clusters;
+    }
+    const double binSize = binDegrees*constants::pi/180.0;
+    const int nPhiBins = std::max(1, static_cast<int>(std::ceil(constants::piByTwo/binSize)));
+    const long long maxThetaBins =
+        static_cast<long long>(std::ceil(2.0*constants::pi/binSize)) + 1;
+
+    // *** Bin on the upper hemisphere.  Rings of constant phi, each ring has as many theta bins as
+    //  fit around its circumference, so the cells are roughly equal-area.
+    struct Bin {
+        Vector3 sum;
+        int count = 0;
+    };
+    std::unordered_map<long long, Bin> bins;
+    for (const Vector3& n : normals) {
+        Vector3 d(n);
+        if (!d.normalise()) {
+            continue;
+        }
+        double theta;
+        double phi;
+        directionToAngles(d, theta, phi);
+        if (d.z() < 0.0) {
+            d *= -1.0;
+        }
+        const int iPhi = std::min(nPhiBins - 1, static_cast<int>(phi/binSize));
+        const double ringPhi = (iPhi + 0.5)*binSize;
+        const int nThetaBins = std::max(
+            1,
+            static_cast<int>(std::lround(2.0*constants::pi*std::cos(ringPhi)/binSize))
+        );
+        const int iTheta =
+            std::min(nThetaBins - 1, static_cast<int>(theta/(2.0*constants::pi)*nThetaBins));
+        Bin& bin = bins[iPhi*maxThetaBins + iTheta];
+        if (bin.count > 0 && bin.sum.dotProduct(d) < 0.0) {
+            // Equatorial bins can see both n and -n
+            d *= -1.0;
+        }
+        bin.sum += d;
+        ++bin.count;
+    }
+
+    // *** Merge bins into clusters, most populated first
+    std::vector<const Bin*> sortedBins;
+    sortedBins.reserve(bins.size());
+    for (const auto& keyBin : bins) {
+        sortedBins.push_back(&keyBin.second);
+    }
+    std::sort(
+        sortedBins.begin(),
+        sortedBins.end(),
+        [](const Bin* a, const Bin* b) { return a->count > b->count; }
+    );
+    const double mergeCos = std::cos(2.0*binSize);
+    std::vector<std::pair<Vector3, double>> sums;
+    for (const Bin* bin : sortedBins) {
+        Vector3 d(bin->sum);
+        if (!d.normalise()) {
+            continue;
+        }
+        bool merged = false;
+        for (std::pair<Vector3, double>& cluster : sums) {
+            Vector3 c(cluster.first);
+            c.normalise();
+            const double cosAngle = c.dotProduct(d);
+            if (std::fabs(cosAngle) >= mergeCos) {
+                cluster.first += bin->sum*(cosAngle < 0.0 ? -1.0 : 1.0);
+                cluster.second += bin->count;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            sums.emplace_back(bin->sum, bin->count);
+        }
+    }
+    std::sort(
+        sums.begin(),
+        sums.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; }
+    );
+    const int nClusters = std::min(maxClusters, static_cast<int>(sums.size()));
+    for (int i = 0; i < nClusters; ++i) {
+        Vector3 d(sums[i].first);
+        d.normalise();
+        clusters.emplace_back(d, sums[i].second);
+    }
+    return clusters;
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::solveFromNormals(
+    const Vector3Field& pts,
+    const Vector3Field& normals,
+    double epsilon,
+    int maxClusters,
+    double orthogonalDegrees
+) {
+    const std::vector<std::pair<Vector3, double>> clusters(clusterNormals(normals, maxClusters));
+    const int nClusters = static_cast<int>(clusters.size());
+    const double orthogonalSin = std::sin(orthogonalDegrees*constants::pi/180.0);
+
+    // *** Orthogonal pairs give a complete frame, evaluate directly
+    OrientedBoundBox best;
+    std::vector<bool> paired(nClusters, false);
+    int nFrames = 0;
+    for (int i = 0; i < nClusters; ++i) {
+        for (int j = i + 1; j < nClusters; ++j) {
+            const Vector3& ci = clusters[i].first;
+            const Vector3& cj = clusters[j].first;
+            if (std::fabs(ci.dotProduct(cj)) > orthogonalSin) {
+                continue;
+            }
+            paired[i] = true;
+            paired[j] = true;
+            ++nFrames;
+            const OrientedBoundBox candidate(evaluateFrame(pts, ci, cj));
+            if (candidate.betterThan(best)) {
+                best = candidate;
+            }
+        }
+    }
+
+    // *** Unpaired clusters only fix one axis, and the best frame's axes may still gain from the
+    //  calipers choosing the roll
+    std::vector<Vector3> directions;
+    for (int i = 0; i < nClusters; ++i) {
+        if (!paired[i]) {
+            directions.push_back(clusters[i].first);
+        }
+    }
+    if (best.valid()) {
+        directions.push_back(best.axes().x());
+        directions.push_back(best.axes().y());
+        directions.push_back(best.axes().z());
+    }
+    const OrientedBoundBox polished(evaluateDirections(pts, directions, epsilon));
+    if (polished.valid() && polished.volume() <= best.volume()*(1.0 + 1e-9)) {
+        best = polished;
+    }
+    Log_Debug(""
+        << "Normals gave " << nClusters << " clusters, " << nFrames << " orthogonal frames, best "
+        << best
+    );
+    return best;
+}
+
+
+gaden::BoundBox gaden::BoundBoxTools::solveEpsilonLadder(
+    // outputs
+    Axes& resultAxes, Vector3& resultRotations, int& nRungsOut,
+
+    // inputs
+    const Vector3Field& pts, double coarseTolerance, double fineTolerance,
+    double relativeChange, int steps, int passes, double epsilon, double ratio
+) {
+    nRungsOut = 0;
+    if (pts.empty()) {
+        return BoundBox();
+    }
+    if (coarseTolerance <= 0.0) {
+        const BoundBox aabb(BoundBox::calculateAxisAlignedBoundBox(pts));
+        coarseTolerance = 0.02*(aabb.maxPt() - aabb.minPt()).mag();
+    }
+    ratio = std::max(ratio, 1.5);
+    fineTolerance = std::min(fineTolerance, coarseTolerance);
+
+    const index_t nPts = static_cast<index_t>(pts.size());
+    OrientedBoundBox best;
+    double previousVolume = 0.0;
+    index_t estimatedSize = std::min(nPts, index_t(1024));
+    IndexField map;
+    Vector3Field merged;
+    for (double tol = coarseTolerance; ; tol = std::max(tol/ratio, fineTolerance)) {
+        PointCloudTools::mergePointsSubset(pts, tol, estimatedSize, map, merged);
+        map.clear();
+        const ConvexHullGraph hullGraph(merged, epsilon);
+        const Vector3Field& rungPts = hullGraph.empty() ? merged : hullGraph.points();
+
+        // The previous orientation, measured on this rung's points, is the incumbent
+        OrientedBoundBox seed;
+        if (best.valid()) {
+            seed = evaluateOrientation(rungPts, best.theta(), best.phi(), epsilon);
+        }
+        Axes axes;
+        Vector3 rotations;
+        BoundBox::solveMinimumRotatedBoundBox(
+            axes, rotations, rungPts, steps, passes, epsilon, 1, seed, false,
+            hullGraph.empty() ? nullptr : &hullGraph
+        );
+        best = evaluateOrientation(rungPts, rotations.x(), rotations.y(), epsilon);
+        ++nRungsOut;
+        Log_Info(""
+            << "Ladder rung " << nRungsOut << ", tolerance " << tol << ": " << merged.size()
+            << " merged points, " << rungPts.size() << " hull points, volume " << best.volume()
+        );
+
+        if (!best.valid()) {
+            // Flat or degenerate, the final measurement falls back to the world axes
+            break;
+        }
+        const double change = std::fabs(best.volume() - previousVolume)/best.volume();
+        if ((nRungsOut > 1 && change < relativeChange) || tol <= fineTolerance) {
+            break;
+        }
+        previousVolume = best.volume();
+        estimatedSize = std::min(nPts, static_cast<index_t>(merged.size()*ratio*ratio));
+    }
+
+    // Merged points lie within tolerance of those they replaced, measure the box over all of pts
+    const OrientedBoundBox measured(evaluateFrame(pts, best.axes().z(), best.axes().x()));
+    resultAxes = measured.axes();
+    resultRotations = measured.rotations();
+    return measured.localBb();
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::solveSmallHull(
+    const ConvexHullGraph& hullGraph,
+    int* nCandidatesOut
+) {
+    // Extent loops run to the capacity, so take the smallest that fits
+    const index_t n = hullGraph.size();
+    if (hullGraph.empty() || n > smallHullMaxVerts) {
+        return OrientedBoundBox();
+    }
+    if (n <= 8) {
+        return SmallHullSolver<8>(hullGraph).solve(nCandidatesOut);
+    }
+    if (n <= 16) {
+        return SmallHullSolver<16>(hullGraph).solve(nCandidatesOut);
+    }
+    if (n <= 24) {
+        return SmallHullSolver<24>(hullGraph).solve(nCandidatesOut);
+    }
+    return SmallHullSolver<smallHullMaxVerts>(hullGraph).solve(nCandidatesOut);
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::solveFixedAxis(
+    const Vector3Field& pts,
+    const Vector3& axis,
+    double epsilon
+) {
+    double theta;
+    double phi;
+    directionToAngles(axis, theta, phi);
+    return evaluateOrientation(pts, theta, phi, epsilon);
+}
+
+
+gaden::OrientedBoundBox gaden::BoundBoxTools::solveAxisCone(
+    const Vector3Field& pts,
+    const Vector3& axis,
+    double coneDegrees,
+    int steps,
+    int passes,
+    double epsilon
+) {
+    OrientedBoundBox best(solveFixedAxis(pts, axis, epsilon));
+    const double cone = std::min(std::max(coneDegrees, 0.0), 90.0)*constants::pi/180.0;
+    if (cone <= 0.0) {
+        return best;
+    }
+    steps = std::max(steps, 1);
+
+    // Frame about the axis, tilted directions are a*cos(tilt) + (p*cos(az) + q*sin(az))*sin(tilt)
+    Vector3 a(axis);
+    if (!a.normalise()) {
+        return best;
+    }
+    Vector3 p = (std::fabs(a.z()) < 0.9) ? Vector3(0.0, 0.0, 1.0) : Vector3(1.0, 0.0, 0.0);
+    p = p - a*a.dotProduct(p);
+    p.normalise();
+    const Vector3 q = a.crossProduct(p);
+
+    double tiltMin = 0.0;
+    double tiltMax = cone;
+    double azMin = 0.0;
+    double azMax = 2.0*constants::pi;
+    double bestTilt = 0.0;
+    double bestAz = 0.0;
+    for (int passI = 0; passI < passes; ++passI) {
+        // Tilt 0 is the axis itself, already evaluated, so the first pass starts one cell out
+        const double tiltDelta = (tiltMax - tiltMin)/steps;
+        const double azDelta = (azMax - azMin)/steps;
+        const int tiltStart = passI == 0 ? 1 : 0;
+        for (int tiltI = tiltStart; tiltI <= steps; ++tiltI) {
+            const double tilt = tiltMin + tiltI*tiltDelta;
+            const Vector3 along(a*std::cos(tilt));
+            for (int azI = 0; azI < steps; ++azI) {
+                const double az = azMin + azI*azDelta;
+                const Vector3 w(along + (p*std::cos(az) + q*std::sin(az))*std::sin(tilt));
+                double theta;
+                double phi;
+                directionToAngles(w, theta, phi);
+                const OrientedBoundBox candidate(evaluateOrientation(pts, theta, phi, epsilon));
+                if (candidate.betterThan(best)) {
+                    best = candidate;
+                    bestTilt = tilt;
+                    bestAz = az;
+                }
+            }
+        }
+        Log_Debug(""
+            << "Axis cone pass " << passI << ", tilt " << bestTilt*180.0/constants::pi
+            << " degrees, volume " << best.volume()
+        );
+
+        // Narrow around the best cell, the azimuth wraps so is not clamped
+        tiltMin = std::max(0.0, bestTilt - tiltDelta);
+        tiltMax = std::min(cone, bestTilt + tiltDelta);
+        azMin = bestAz - azDelta;
+        azMax = bestAz + azDelta;
+    }
+    return best;
+}
@@ -0,0 +1,292 @@
+#include "gaden/ConvexHullGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#include "gaden/ConvexHullTools.hpp"
+#include "gaden/Logger.hpp"
+
+
+gaden::ConvexHullGraph::ConvexHullGraph(
+    const Vector3Field& chPts,
+    const IndexField& chVertices,
+    const std::vector<Face>& chFaces
+) :
+    m_points(chPts)
+{
+    const index_t nVerts = static_cast<index_t>(chVertices.size());
+
+    // Faces index the original point cloud, map those to hull vertex indices
+    std::unordered_map<index_t, index_t> toHull;
+    toHull.reserve(nVerts);
+    for (index_t k = 0; k < nVerts; ++k) {
+        toHull[chVertices[k]] = k;
+    }
+
+    // Each face contributes its three edges in both directions, duplicates removed below
+    std::vector<std::pair<index_t, index_t>> edges;
+    for (const Face& f : chFaces) {
+        if (!f.alive()) {
+            continue;
+        }
+        const index_t a = toHull.at(f.a());
+        const index_t b = toHull.at(f.b());
+        const index_t c = toHull.at(f.c());
+        edges.emplace_back(a, b);
+        edges.emplace_back(b, a);
+        edges.emplace_back(b, c);
+        edges.emplace_back(c, b);
+        edges.emplace_back(c, a);
+        edges.emplace_back(a, c);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    m_offsets.resize(nVerts + 1, 0);
+    m_neighbours.reserve(edges.size());
+    for (const std::pair<index_t, index_t>& e : edges) {
+        ++m_offsets[e.first + 1];
+        m_neighbours.push_back(e.second);
+    }
+    for (index_t k = 0; k < nVerts; ++k) {
+        m_offsets[k + 1] += m_offsets[k];
+    }
+    Log_Debug(""
+        << "Hull graph with " << nVerts << " vertices and " << edges.size()/2 << " edges"
+    );
+}
+
+
+gaden::ConvexHullGraph::ConvexHullGraph(const Vector3Field& pts, double epsilon) {
+    Vector3Field chPts;
+    IndexField chVertices;
+    std::vector<Face> chFaces;
+    const int nDims =
+        ConvexHullTools::calculateConvexHull3d(pts, epsilon, chPts, chVertices, chFaces);
+    if (nDims < 3) {
+        // No 3d hull, leave empty
+        return;
+    }
+    *this = ConvexHullGraph(chPts, chVertices, chFaces);
+}
+
+
+gaden::index_t gaden::ConvexHullGraph::support(
+    const Vector3& d, index_t start, int* nStepsOut
+) const {
+    const index_t nVerts = size();
+    index_t current = std::min(std::max(start, index_t(0)), nVerts - 1);
+    double best = m_points[current].dotProduct(d);
+    int nSteps = 0;
+
+    // Steepest ascent, move to the best neighbour while it improves
+    for (;;) {
+        index_t next = current;
+        for (const index_t* nb = neighboursBegin(current); nb != neighboursEnd(current); ++nb) {
+            const double val = m_points[*nb].dotProduct(d);
+            if (val > best) {
+                best = val;
+                next = *nb;
+            }
+        }
+        if (next == current) {
+            break;
+        }
+        current = next;
+        ++nSteps;
+    }
+    if (nStepsOut) {
+        *nStepsOut = nSteps;
+    }
+    return current;
+}
+
+
+gaden::BoundBox gaden::ConvexHullGraph::extents(
+    const Axes& axes,
+    index_t supportsInOut[nExtentSlots]
+) const {
+    const Vector3* dirs[3] = {&axes.x(), &axes.y(), &axes.z()};
+    double mins[3];
+    double maxs[3];
+    for (int i = 0; i < 3; ++i) {
+        const Vector3& d = *dirs[i];
+        index_t& iMax = supportsInOut[2*i];
+        index_t& iMin = supportsInOut[2*i + 1];
+        iMax = support(d, iMax);
+        iMin = support(d*-1.0, iMin);
+        maxs[i] = m_points[iMax].dotProduct(d);
+        mins[i] = m_points[iMin].dotProduct(d);
+    }
+    return BoundBox(Vector3(mins[0], mins[1], mins[2]), Vector3(maxs[0], maxs[1], maxs[2]));
+}
+
+
+gaden::IndexField gaden::ConvexHullGraph::epsilonKernel(
+    double epsilon,
+    double& epsilonOut,
+    int maxDirections
+) const {
+    const index_t nVerts = size();
+    IndexField kernel;
+    epsilonOut = 0.0;
+    if (nVerts == 0) {
+        return kernel;
+    }
+
+    // A fat frame: e1 along an approximate diameter ab, e2 towards the vertex c furthest from
+    // line ab, e3 normal to plane abc.  Scaled to unit extents along each axis, the hull's widths
+    // are within a constant factor in every direction, so evenly spread directions suit it.
+    const auto furthest = [&](auto&& dist) {
+        index_t best = 0;
+        double bestDist = -1.0;
+        for (index_t i = 0; i < nVerts; ++i) {
+            const double di = dist(m_points[i]);
+            if (di > bestDist) {
+                bestDist = di;
+                best = i;
+            }
+        }
+        return best;
+    };
+    const Vector3& p0 = m_points[0];
+    const Vector3 a = m_points[furthest([&](const Vector3& p) { return (p - p0).magSqr(); })];
+    const Vector3 b = m_points[furthest([&](const Vector3& p) { return (p - a).magSqr(); })];
+    Vector3 e1(b - a);
+    e1.normalise();
+    const auto offLine = [&](const Vector3& p) {
+        const Vector3 r(p - a);
+        return r - e1*r.dotProduct(e1);
+    };
+    Vector3 e2(offLine(m_points[furthest([&](const Vector3& p) { return offLine(p).magSqr(); })]));
+    e2.normalise();
+    const Vector3 e3(e1.crossProduct(e2));
+    const Vector3 axes[3] = {e1, e2, e3};
+    double scale[3];
+    for (int k = 0; k < 3; ++k) {
+        double lo = m_points[0].dotProduct(axes[k]);
+        double hi = lo;
+        for (const Vector3& p : m_points) {
+            const double val = p.dotProduct(axes[k]);
+            lo = std::min(lo, val);
+            hi = std::max(hi, val);
+        }
+        scale[k] = hi - lo;
+    }
+    if (!(scale[0] > 0.0 && scale[1] > 0.0 && scale[2] > 0.0)) {
+        // Flat hull, keep every vertex
+        kernel.resize(nVerts);
+        for (index_t i = 0; i < nVerts; ++i) {
+            kernel[i] = i;
+        }
+        return kernel;
+    }
+    Vector3Field unitPts;
+    unitPts.reserve(nVerts);
+    for (const Vector3& p : m_points) {
+        unitPts.push_back(
+            Vector3(p.dotProduct(e1)/scale[0], p.dotProduct(e2)/scale[1], p.dotProduct(e3)/scale[2])
+        );
+    }
+
+    // Directions are the (m + 1) x (m + 1) grid points on each face of the cube [-1, 1]^3, in the
+    // unit frame.  The bound is measured rather than assumed, cell by cell.  Any f in a cell is
+    // sum mu_i g_i over its corners g_i, mu_i >= 0, and the support function h is sublinear, so
+    // h(f) <= sum mu_i g_i.q_i with q_i the support of g_i; the kernel reaches f.q_j for every
+    // corner j, falling short by at most min_j max_i g_i.(q_i - q_j).  The opposite face bounds
+    // the other side, and f.(q_j - q'_j), linear over the cell, bounds the width from below.
+    // Ratios of widths are unchanged by the frame scaling, so the bound holds in world space.
+    const double great = std::numeric_limits<double>::max();
+    const int mMax = std::max(1, static_cast<int>(std::sqrt(maxDirections/6.0)) - 1);
+    int m = std::min(4, mMax);
+    std::vector<index_t> supports;
+    std::vector<char> inKernel;
+    for (;;) {
+        const int side = m + 1;
+        const auto gridDir = [&](int face, int i, int j) {
+            double u[3];
+            u[face/2] = face % 2 == 0 ? 1.0 : -1.0;
+            u[(face/2 + 1) % 3] = -1.0 + 2.0*i/m;
+            u[(face/2 + 2) % 3] = -1.0 + 2.0*j/m;
+            return Vector3(u[0], u[1], u[2]);
+        };
+        const auto slot = [&](int face, int i, int j) { return (face*side + i)*side + j; };
+
+        // Supports in world space, unit frame direction g is sum_k g_k*e_k/scale_k.  Each face is
+        // walked in serpentine order so that the previous answer is a close start.
+        supports.assign(6*side*side, 0);
+        index_t current = 0;
+        for (int face = 0; face < 6; ++face) {
+            for (int i = 0; i < side; ++i) {
+                for (int k = 0; k < side; ++k) {
+                    const int j = i % 2 == 1 ? m - k : k;
+                    const Vector3 g(gridDir(face, i, j));
+                    current = support(
+                        e1*(g.x()/scale[0]) + e2*(g.y()/scale[1]) + e3*(g.z()/scale[2]), current
+                    );
+                    supports[slot(face, i, j)] = current;
+                }
+            }
+        }
+
+        double worst = 0.0;
+        for (int face = 0; face < 6; ++face) {
+            for (int i = 0; i < m; ++i) {
+                for (int j = 0; j < m; ++j) {
+                    Vector3 g[4];
+                    Vector3 q[4];
+                    Vector3 qOpp[4];
+                    for (int c = 0; c < 4; ++c) {
+                        const int ci = i + c % 2;
+                        const int cj = j + c/2;
+                        g[c] = gridDir(face, ci, cj);
+                        q[c] = unitPts[supports[slot(face, ci, cj)]];
+                        qOpp[c] = unitPts[supports[slot(face ^ 1, m - ci, m - cj)]];
+                    }
+                    double shortfall = great;
+                    double shortfallOpp = great;
+                    double widthLow = 0.0;
+                    for (int cj = 0; cj < 4; ++cj) {
+                        double worstI = 0.0;
+                        double worstIOpp = 0.0;
+                        double widthJ = great;
+                        for (int ci = 0; ci < 4; ++ci) {
+                            worstI = std::max(worstI, g[ci].dotProduct(q[ci] - q[cj]));
+                            worstIOpp = std::max(worstIOpp, g[ci].dotProduct(qOpp[cj] - qOpp[ci]));
+                            widthJ = std::min(widthJ, g[ci].dotProduct(q[cj] - qOpp[cj]));
+                        }
+                        shortfall = std::min(shortfall, worstI);
+                        shortfallOpp = std::min(shortfallOpp, worstIOpp);
+                        widthLow = std::max(widthLow, widthJ);
+                    }
+                    worst = std::max(
+                        worst,
+                        widthLow > 0.0 ? (shortfall + shortfallOpp)/widthLow : great
+                    );
+                }
+            }
+        }
+        epsilonOut = worst;
+        if (epsilonOut <= epsilon || m >= mMax) {
+            break;
+        }
+        m = std::min(2*m, mMax);
+    }
+
+    inKernel.assign(nVerts, 0);
+    for (const index_t s : supports) {
+        inKernel[s] = 1;
+    }
+    for (index_t i = 0; i < nVerts; ++i) {
+        if (inKernel[i]) {
+            kernel.push_back(i);
+        }
+    }
+    Log_Debug(""
+        << "Epsilon-kernel of " << kernel.size() << " of " << nVerts << " hull vertices, "
+        << 6*(m + 1)*(m + 1) << " directions, epsilon " << epsilonOut
+    );
+    return kernel;
+}
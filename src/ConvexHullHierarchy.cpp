@@ -0,0 +1,255 @@
+#include "gaden/ConvexHullHierarchy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "gaden/Logger.hpp"
+
+
+namespace { // anonymous namespace for local-only functionality
+
+    using namespace gaden;
+
+    // Steepest ascent on one level's adjacency, as ConvexHullGraph::support
+    index_t climbLevel(
+        const Vector3Field& points,
+        const IndexField& vertices,
+        const IndexField& offsets,
+        const IndexField& neighbours,
+        const Vector3& d,
+        index_t current,
+        int& nVisitedInOut
+    ) {
+        double best = points[vertices[current]].dotProduct(d);
+        for (;;) {
+            index_t next = current;
+            for (index_t k = offsets[current]; k < offsets[current + 1]; ++k) {
+                const index_t nb = neighbours[k];
+                const double val = points[vertices[nb]].dotProduct(d);
+                if (val > best) {
+                    best = val;
+                    next = nb;
+                }
+            }
+            nVisitedInOut += static_cast<int>(offsets[current + 1] - offsets[current]);
+            if (next == current) {
+                return current;
+            }
+            current = next;
+        }
+    }
+
+    // Add to edgesOut the edges of the hull facets that fill the hole left by removing vertex v.
+    // Those facets only use the neighbours of v, link, and are the triangles of link that have
+    // every other link vertex on their inner side and v on their outer side.  Checking both
+    // orientations keeps every triangle of a planar link, giving extra edges but none missing.
+    void reconnectHole(
+        // outputs
+        std::vector<std::pair<index_t, index_t>>& edgesOut,
+
+        // inputs
+        const Vector3Field& linkPts,
+        const IndexField& link,
+        const Vector3& v,
+        double tol
+    ) {
+        const index_t nLink = static_cast<index_t>(link.size());
+        for (index_t i = 0; i < nLink; ++i) {
+            for (index_t j = i + 1; j < nLink; ++j) {
+                for (index_t k = j + 1; k < nLink; ++k) {
+                    const Vector3& pi = linkPts[i];
+                    Vector3 normal((linkPts[j] - pi).crossProduct(linkPts[k] - pi));
+                    if (!normal.normalise()) {
+                        continue;
+                    }
+                    bool above = false;
+                    bool below = false;
+                    for (index_t l = 0; l < nLink && !(above && below); ++l) {
+                        const double dist = normal.dotProduct(linkPts[l] - pi);
+                        above |= dist > tol;
+                        below |= dist < -tol;
+                    }
+                    const double distV = normal.dotProduct(v - pi);
+                    const bool facet = (!above && distV >= -tol) || (!below && distV <= tol);
+                    if (!facet) {
+                        continue;
+                    }
+                    const index_t a = link[i];
+                    const index_t b = link[j];
+                    const index_t c = link[k];
+                    edgesOut.emplace_back(a, b);
+                    edgesOut.emplace_back(b, a);
+                    edgesOut.emplace_back(b, c);
+                    edgesOut.emplace_back(c, b);
+                    edgesOut.emplace_back(c, a);
+                    edgesOut.emplace_back(a, c);
+                }
+            }
+        }
+    }
+
+} // end anonymous namespace
+
+
+gaden::ConvexHullHierarchy::ConvexHullHierarchy(
+    const ConvexHullGraph& graph,
+    int maxDegree,
+    int topSize
+) :
+    m_points(graph.points())
+{
+    const index_t nVerts = graph.size();
+    if (nVerts == 0) {
+        return;
+    }
+    topSize = std::max(topSize, 4);
+
+    // Level 0 is the hull graph itself
+    m_levels.emplace_back();
+    {
+        Level& base = m_levels.back();
+        base.m_vertices.resize(nVerts);
+        base.m_offsets.resize(nVerts + 1, 0);
+        for (index_t i = 0; i < nVerts; ++i) {
+            base.m_vertices[i] = i;
+            base.m_offsets[i + 1] = base.m_offsets[i] + graph.degree(i);
+            base.m_neighbours.insert(
+                base.m_neighbours.end(), graph.neighboursBegin(i), graph.neighboursEnd(i)
+            );
+        }
+    }
+
+    // Coplanarity tolerance, relative to the hull size
+    double scale = 0.0;
+    for (const Vector3& p : m_points) {
+        scale = std::max(scale, std::fabs(p.x()));
+        scale = std::max(scale, std::fabs(p.y()));
+        scale = std::max(scale, std::fabs(p.z()));
+    }
+    const double tol = 1e-10*scale;
+
+    IndexField newIndex;
+    IndexField link;
+    Vector3Field linkPts;
+    std::vector<std::pair<index_t, index_t>> edges;
+    while (levelSize(nLevels() - 1) > topSize) {
+        const Level& cur = m_levels.back();
+        const index_t n = static_cast<index_t>(cur.m_vertices.size());
+
+        // Greedy independent set of low-degree vertices, newIndex is -1 for removed vertices
+        std::vector<char> blocked(n, 0);
+        newIndex.assign(n, 0);
+        index_t nRemoved = 0;
+        for (index_t i = 0; i < n && n - nRemoved > topSize; ++i) {
+            const index_t degree = cur.m_offsets[i + 1] - cur.m_offsets[i];
+            if (blocked[i] || degree > maxDegree) {
+                continue;
+            }
+            newIndex[i] = -1;
+            ++nRemoved;
+            for (index_t k = cur.m_offsets[i]; k < cur.m_offsets[i + 1]; ++k) {
+                blocked[cur.m_neighbours[k]] = 1;
+            }
+        }
+        if (nRemoved < std::max(index_t(1), n/32)) {
+            // Too few low-degree vertices left to be worth another level
+            break;
+        }
+
+        Level next;
+        next.m_vertices.reserve(n - nRemoved);
+        next.m_below.reserve(n - nRemoved);
+        for (index_t i = 0; i < n; ++i) {
+            if (newIndex[i] == 0) {
+                newIndex[i] = static_cast<index_t>(next.m_vertices.size());
+                next.m_vertices.push_back(cur.m_vertices[i]);
+                next.m_below.push_back(i);
+            }
+        }
+
+        // Surviving edges, then new edges across each hole
+        edges.clear();
+        for (index_t i = 0; i < n; ++i) {
+            const index_t a = newIndex[i];
+            if (a >= 0) {
+                for (index_t k = cur.m_offsets[i]; k < cur.m_offsets[i + 1]; ++k) {
+                    const index_t b = newIndex[cur.m_neighbours[k]];
+                    if (b >= 0) {
+                        edges.emplace_back(a, b);
+                    }
+                }
+                continue;
+            }
+            link.clear();
+            linkPts.clear();
+            for (index_t k = cur.m_offsets[i]; k < cur.m_offsets[i + 1]; ++k) {
+                const index_t nb = cur.m_neighbours[k];
+                link.push_back(newIndex[nb]);
+                linkPts.push_back(m_points[cur.m_vertices[nb]]);
+            }
+            reconnectHole(edges, linkPts, link, m_points[cur.m_vertices[i]], tol);
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        const index_t nNext = static_cast<index_t>(next.m_vertices.size());
+        next.m_offsets.resize(nNext + 1, 0);
+        next.m_neighbours.reserve(edges.size());
+        for (const std::pair<index_t, index_t>& e : edges) {
+            ++next.m_offsets[e.first + 1];
+            next.m_neighbours.push_back(e.second);
+        }
+        for (index_t k = 0; k < nNext; ++k) {
+            next.m_offsets[k + 1] += next.m_offsets[k];
+        }
+        m_levels.push_back(std::move(next));
+    }
+    Log_Debug(""
+        << "Hull hierarchy with " << nLevels() << " levels, " << nVerts << " down to "
+        << levelSize(nLevels() - 1) << " vertices"
+    );
+}
+
+
+gaden::index_t gaden::ConvexHullHierarchy::support(const Vector3& d, int* nVisitedOut) const {
+    // Scan the top level
+    const Level& top = m_levels.back();
+    const index_t nTop = static_cast<index_t>(top.m_vertices.size());
+    index_t current = 0;
+    double best = m_points[top.m_vertices[0]].dotProduct(d);
+    for (index_t i = 1; i < nTop; ++i) {
+        const double val = m_points[top.m_vertices[i]].dotProduct(d);
+        if (val > best) {
+            best = val;
+            current = i;
+        }
+    }
+    int nVisited = nTop;
+
+    // Descend, the answer one level up is the start vertex on the level below
+    for (int lvl = nLevels() - 1; lvl > 0; --lvl) {
+        const Level& below = m_levels[lvl - 1];
+        current = climbLevel(
+            m_points, below.m_vertices, below.m_offsets, below.m_neighbours, d,
+            m_levels[lvl].m_below[current], nVisited
+        );
+    }
+    if (nVisitedOut) {
+        *nVisitedOut = nVisited;
+    }
+    return m_levels[0].m_vertices[current];
+}
+
+
+gaden::BoundBox gaden::ConvexHullHierarchy::extents(const Axes& axes) const {
+    const Vector3* dirs[3] = {&axes.x(), &axes.y(), &axes.z()};
+    double mins[3];
+    double maxs[3];
+    for (int i = 0; i < 3; ++i) {
+        const Vector3& d = *dirs[i];
+        maxs[i] = m_points[support(d)].dotProduct(d);
+        mins[i] = m_points[support(d*-1.0)].dotProduct(d);
+    }
+    return BoundBox(Vector3(mins[0], mins[1], mins[2]), Vector3(maxs[0], maxs[1], maxs[2]));
+}
@@ -1,22 +1,127 @@
 #include "gaden/ConvexHullTools.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
-int gaden::ConvexHullTools::calculateConvexHull3d(
+#include "gaden/Lattice.hpp"
+
+namespace { // anonymous
+
+using namespace gaden;
+
+// Index of the next vertex around a closed polygon of n vertices, wraps without a modulo or branch
+inline index_t nextIndex(index_t i, index_t n) {
+    const index_t j = i + 1;
+    return j & -static_cast<index_t>(j != n);
+}
+
+// Advance support index i around a closed polygon of n vertices while proj(next vertex) > best,
+// best holds proj(i) and is updated, so each step costs one projection
+template <class Proj>
+inline void advanceSupport(index_t& i, double& best, index_t n, const Proj& proj) {
+    for (;;) {
+        const index_t nxt = nextIndex(i, n);
+        const double val = proj(nxt);
+        if (!(val > best)) {
+            return;
+        }
+        i = nxt;
+        best = val;
+    }
+}
+
+// Hill-climb support index i to the maximum of proj in either direction around the polygon, the
+// support function of a convex polygon is unimodal so any start converges
+template <class Proj>
+inline void climbSupport(index_t& i, index_t n, const Proj& proj) {
+    const index_t start = i;
+    double best = proj(i);
+    advanceSupport(i, best, n, proj);
+    if (i != start) {
+        return;
+    }
+    for (;;) {
+        const index_t prv = i == 0 ? n - 1 : i - 1;
+        const double val = proj(prv);
+        if (!(val > best)) {
+            return;
+        }
+        i = prv;
+        best = val;
+    }
+}
+
+// Point access for the quickhull.  Each takes the point field and indices, so that lattice input
+// (Vector3iField) can use Lattice's exact predicates and need no tolerance.
+
+// Face (a, b, c) on pts, as the Face constructor
+template <class PointField>
+Face makeFace(index_t a, index_t b, index_t c, const PointField& P, double eps) {
+    return Face(a, b, c, P, eps);
+}
+
+// As above, the face is degenerate exactly when its points are collinear
+Face makeFace(index_t a, index_t b, index_t c, const Vector3iField& P, double) {
+    Face f(a, b, c, P, 0.0);
+    f.alive() = !Lattice::collinear(P[a], P[b], P[c]);
+    return f;
+}
+
+// |(P[a] - P[o]) x (P[b] - P[o])|^2
+template <class PointField>
+double crossMagSqr(const PointField& P, index_t o, index_t a, index_t b) {
+    const Vector3 po(P[o]);
+    const Vector3 cx((Vector3(P[a]) - po).crossProduct(Vector3(P[b]) - po));
+    return cx.dotProduct(cx);
+}
+
+// As above, zero exactly when the points are collinear
+double crossMagSqr(const Vector3iField& P, index_t o, index_t a, index_t b) {
+    std::int64_t cross[3];
+    Lattice::crossProduct(cross, P[o], P[a], P[b]);
+    const double cx = static_cast<double>(cross[0]);
+    const double cy = static_cast<double>(cross[1]);
+    const double cz = static_cast<double>(cross[2]);
+    return cx*cx + cy*cy + cz*cz;
+}
+
+// Signed distance of P[i] from face f, positive outside
+template <class PointField>
+double faceDistance(const Face& f, const PointField& P, index_t i) {
+    return f.signedDistance(Vector3(P[i]));
+}
+
+// As above, with an exact sign: zero only on the plane, positive only when strictly outside.
+// Scaled by the face's doubled area, so it orders points by distance from one face exactly, and
+// only approximately across faces, which only steers the order points are added in.
+double faceDistance(const Face& f, const Vector3iField& P, index_t i) {
+    return Lattice::orient3d(P[f.a()], P[f.b()], P[f.c()], P[i]);
+}
+
+
+// Quickhull for calculateConvexHull3d, for either precision of input points.  Geometry is done
+// in double precision, points are widened as they are read.
+template <class PointField>
+int calculateConvexHull3dImpl(
     // Inputs
-    const Vector3Field& ptsIn,
+    const PointField& ptsIn,
     double toleranceIn,
 
     // Outputs
     Vector3Field& ptsOut,
-    IntField& chVerticesOut,
-    std::vector<Face> chFacesOut
+    IndexField& chVerticesOut,
+    std::vector<Face>& chFacesOut
 ) {
     // Renaming for readability
-    const Vector3Field& P = ptsIn;
-    IntField& out = chVerticesOut;
+    const PointField& P = ptsIn;
+    const auto pt = [&P](index_t i) { return Vector3(P[i]); };
+    IndexField& out = chVerticesOut;
 
-    const int n = P.size();
+    const index_t n = P.size();
     out.clear();
     if (n == 0) {
         // No points => no hull
@@ -30,20 +135,20 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
 
     // *** Build initial simplex (tet), choose (p0, p1, p2, p3)
-    int p0 = 0;
+    index_t p0 = 0;
     // Find leftmost vertex, linear search, ignore ties
-    for (int i = 1; i < n; ++i) {
-        if (P[i].x() < P[p0].x()) {
+    for (index_t i = 1; i < n; ++i) {
+        if (pt(i).x() < pt(p0).x()) {
             p0 = i;
         }
     }
 
     // p1: farthest from p0 (by squared distance)
-    int p1 = p0;
+    index_t p1 = p0;
     double best = -1.0;
-    for (int i = 0; i < n; ++i) {
+    for (index_t i = 0; i < n; ++i) {
         // ||P[i] - P[p0]||^2
-        const Vector3 d = P[i] - P[p0];
+        const Vector3 d = pt(i) - pt(p0);
         const double d2 = d.magSqr();
 
         if (d2 > best) {
@@ -58,14 +163,12 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
 
     // p2: maximises triangle area with (p0,p1) via |(p1-p0) x (P[i]-p0)|^2
-    int p2 = p0; best = -1.0;
-    const Vector3 u = P[p1] - P[p0];
-    for (int i = 0; i < n; ++i) {
+    index_t p2 = p0; best = -1.0;
+    const Vector3 u = pt(p1) - pt(p0);
+    for (index_t i = 0; i < n; ++i) {
         if (i != p0 && i != p1) {
             // ||u x w||^2 (proportional to area^2)
-            const Vector3 w = P[i] - P[p0];
-            const Vector3 cx = u.crossProduct(w);
-            const double a2 = cx.dotProduct(cx);
+            const double a2 = crossMagSqr(P, p0, p1, i);
 
             if (a2 > best) {
                 best = a2; p2 = i;
@@ -74,11 +177,11 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
     if (p2 == p0 || best <= toleranceIn) {
         // Points nearly colinear: return extreme endpoints along u (line hull)
-        int lo = 0, hi = 0;
-        double loP = (P[0] - P[p0]).dotProduct(u), hiP = loP;
-        for (int i = 1; i < n; ++i) {
+        index_t lo = 0, hi = 0;
+        double loP = (pt(0) - pt(p0)).dotProduct(u), hiP = loP;
+        for (index_t i = 1; i < n; ++i) {
             // scalar projection on u
-            const double pr = (P[i] - P[p0]).dotProduct(u);
+            const double pr = (pt(i) - pt(p0)).dotProduct(u);
             if (pr < loP) {
                 loP = pr;
                 lo = i;
@@ -100,13 +203,13 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
 
     // Seed face from (p0,p1,p2); computes plane normal/offset, orientation, etc.
-    Face seed(static_cast<int>(p0), static_cast<int>(p1), static_cast<int>(p2), P, toleranceIn);
+    Face seed(makeFace(p0, p1, p2, P, toleranceIn));
 
     // p3: farthest (by |signed distance|) from the seed plane => maximises tet volume
-    int p3 = p0; best = -1.0;
-    for (int i = 0; i < n; ++i) if (i != p0 && i != p1 && i != p2) {
+    index_t p3 = p0; best = -1.0;
+    for (index_t i = 0; i < n; ++i) if (i != p0 && i != p1 && i != p2) {
         // |n·p + d|
-        const double sd = std::fabs(seed.signedDistance(P[i]));
+        const double sd = std::fabs(faceDistance(seed, P, i));
         if (sd > best) {
             best = sd;
             p3 = i;
@@ -124,19 +227,19 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
         const Vector3 n01 = u.crossProduct(nrm);
 
         // tangent direction 2
-        const Vector3 n02 = (P[p2] - P[p0]).crossProduct(nrm);
+        const Vector3 n02 = (pt(p2) - pt(p0)).crossProduct(nrm);
 
-        const Vector3 dirs[4] = { nrm, n01, n02, (P[p2] - P[p1]) };
+        const Vector3 dirs[4] = { nrm, n01, n02, (pt(p2) - pt(p1)) };
         for (const Vector3& d : dirs) {
             if (d.magSqr() <= toleranceIn*toleranceIn) {
                 // skip near-zero directions
                 continue;
             }
             // Find extremes along d across all points; add both indices
-            int lo = 0, hi = 0;
-            double loP = P[0].dotProduct(d), hiP = loP;
-            for (int i = 1; i < n; ++i) {
-                const double pr = P[i].dotProduct(d);
+            index_t lo = 0, hi = 0;
+            double loP = pt(0).dotProduct(d), hiP = loP;
+            for (index_t i = 1; i < n; ++i) {
+                const double pr = pt(i).dotProduct(d);
                 if (pr < loP) {
                     loP = pr;
                     lo = i;
@@ -156,9 +259,10 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
 
     // Ensure seed faces point outward (p3 is inside side)
-    if (seed.visibleFrom(P[p3], 0.0)) {
+    if (faceDistance(seed, P, p3) > 0.0) {
         // If p3 sees the seed as front-facing, flip winding to make it outward
-        seed = Face(static_cast<int>(p0), static_cast<int>(p2), static_cast<int>(p1), P, toleranceIn);
+        std::swap(p1, p2);
+        seed = makeFace(p0, p1, p2, P, toleranceIn);
     }
 
     // Prepare faces output, rename for brevity
@@ -166,24 +270,24 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     faces.clear();
     faces.reserve(32);
     // Initial tet faces, CCW as seen from outside
-    faces.emplace_back(static_cast<int>(p0), static_cast<int>(p1), static_cast<int>(p2), P, toleranceIn);
-    faces.emplace_back(static_cast<int>(p0), static_cast<int>(p2), static_cast<int>(p3), P, toleranceIn);
-    faces.emplace_back(static_cast<int>(p2), static_cast<int>(p1), static_cast<int>(p3), P, toleranceIn);
-    faces.emplace_back(static_cast<int>(p1), static_cast<int>(p0), static_cast<int>(p3), P, toleranceIn);
+    faces.push_back(makeFace(p0, p1, p2, P, toleranceIn));
+    faces.push_back(makeFace(p0, p2, p3, P, toleranceIn));
+    faces.push_back(makeFace(p2, p1, p3, P, toleranceIn));
+    faces.push_back(makeFace(p1, p0, p3, P, toleranceIn));
 
     // Assign outside sets
-    for (int i = 0; i < n; ++i) {
+    for (index_t i = 0; i < n; ++i) {
         if (i == p0 || i == p1 || i == p2 || i == p3) {
             // skip tet vertices
             continue;
         }
         // tolerance to ignore near-boundary points (i.e. <= toleranceIn)
         double bestDist = toleranceIn;
-        int bestFace = -1;
-        int nFaces = static_cast<int>(faces.size());
-        for (int f = 0; f < nFaces; ++f) if (faces[f].alive()) {
+        index_t bestFace = -1;
+        index_t nFaces = static_cast<index_t>(faces.size());
+        for (index_t f = 0; f < nFaces; ++f) if (faces[f].alive()) {
             // positive means in front/outside
-            const double sd = faces[f].signedDistance(P[i]);
+            const double sd = faceDistance(faces[f], P, i);
             if (sd > bestDist) {
                 bestDist = sd;
                 bestFace = f;
@@ -197,13 +301,13 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     // *** Quickhull main loop - incremental: iteratively add points & retriangulate
     while (true) {
         // Pick a face that still has outside points (greedy: largest far distance)
-        int fIdx = -1; double fMax = -1.0;
-        int nFaces = static_cast<int>(faces.size());
-        for (int f = 0; f < nFaces; ++f) {
+        index_t fIdx = -1; double fMax = -1.0;
+        index_t nFaces = static_cast<index_t>(faces.size());
+        for (index_t f = 0; f < nFaces; ++f) {
             if (faces[f].alive() && !faces[f].outside().empty()) {
                 double localMax = -1.0;
-                for (int idx : faces[f].outside()) {
-                    const double sd = faces[f].signedDistance(P[idx]);
+                for (index_t idx : faces[f].outside()) {
+                    const double sd = faceDistance(faces[f], P, idx);
                     if (sd > localMax) {
                         localMax = sd;
                     }
@@ -221,10 +325,10 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
 
         // perspectivePoint is farthest view (point) from that face
         Face& f = faces[fIdx];
-        int perspectivePoint = f.outside().front();
+        index_t perspectivePoint = f.outside().front();
         double farBest = -1.0;
-        for (int idx : f.outside()) {
-            const double sd = f.signedDistance(P[idx]);
+        for (index_t idx : f.outside()) {
+            const double sd = faceDistance(f, P, idx);
             if (sd > farBest) {
                 farBest = sd;
                 perspectivePoint = idx;
@@ -232,11 +336,11 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
         }
 
         // 1) Mark all faces visible from perspectivePoint
-        std::vector<int> visible;
+        std::vector<index_t> visible;
         visible.reserve(16);
-        for (int i = 0; i < faces.size(); ++i) {
+        for (index_t i = 0; i < nFaces; ++i) {
             if (faces[i].alive()) {
-                if (faces[i].visibleFrom(P[perspectivePoint], toleranceIn)) {
+                if (faceDistance(faces[i], P, perspectivePoint) > toleranceIn) {
                     faces[i].alive() = false;
                     visible.push_back(i);
                 }
@@ -246,7 +350,7 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
         // 2) Build the horizon: directed edges that appear exactly once among visible faces
         //    (edges bordering the "hole" after removing visible faces)
         std::unordered_map<Edge, int, EdgeHash> count;
-        for (int vi : visible) {
+        for (index_t vi : visible) {
             const Face& vf = faces[vi];
             ++count[Edge(vf.a(), vf.b())];
             ++count[Edge(vf.b(), vf.c())];
@@ -269,24 +373,24 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
         }
 
         // 3) Stitch new faces from horizon to perspectivePoint (maintain outward orientation)
-        std::vector<int> newFaces;
+        std::vector<index_t> newFaces;
         newFaces.reserve(horizon.size());
         for (const Edge& e : horizon) {
             // triangle (u -> v -> perspectivePoint)
-            Face nf(e.u(), e.v(), perspectivePoint, P, toleranceIn);
+            Face nf(makeFace(e.u(), e.v(), perspectivePoint, P, toleranceIn));
             if (!nf.alive()) {
                 // skip degenerate tris
                 continue;
             }
             faces.push_back(nf);
-            int newIndex = static_cast<int>(faces.size()) - 1;
+            index_t newIndex = static_cast<index_t>(faces.size()) - 1;
             newFaces.push_back(newIndex);
         }
 
         // 4) Reassign outside points that belonged to removed faces (exclude perspectivePoint)
-        std::vector<int> pool;
-        for (int vi : visible) {
-            for (int idx : faces[vi].outside()) {
+        std::vector<index_t> pool;
+        for (index_t vi : visible) {
+            for (index_t idx : faces[vi].outside()) {
                 if (idx != perspectivePoint) {
                     pool.push_back(idx);
                 }
@@ -298,11 +402,11 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
         pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
 
         // Re-bin pooled points to the newly created faces (only if strictly outside)
-        for (int idx : pool) {
+        for (index_t idx : pool) {
             double bestD = toleranceIn;
-            int bf = -1;
-            for (int nf : newFaces) if (faces[nf].alive()) {
-                const double sd = faces[nf].signedDistance(P[idx]);
+            index_t bf = -1;
+            for (index_t nf : newFaces) if (faces[nf].alive()) {
+                const double sd = faceDistance(faces[nf], P, idx);
                 if (sd > bestD) {
                     bestD = sd;
                     bf = nf;
@@ -315,7 +419,7 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     }
 
     // *** Collect unique vertex indices
-    std::unordered_set<int> verts;
+    std::unordered_set<index_t> verts;
     for (const Face& f : faces) if (f.alive()) {
         verts.insert(f.a());
         verts.insert(f.b());
@@ -325,15 +429,72 @@ int gaden::ConvexHullTools::calculateConvexHull3d(
     std::sort(out.begin(), out.end());
 
     // Cache actual hull points (for downstream steps)
-    int nPts = out.size();
+    index_t nPts = out.size();
     ptsOut.clear();
     ptsOut.reserve(nPts);
-    for (int i : out) {
-        ptsOut.push_back(P[i]);
+    for (index_t i : out) {
+        ptsOut.push_back(pt(i));
     }
     return 3;
 }
 
+} // end anonymous namespace
+
+
+int gaden::ConvexHullTools::calculateConvexHull3d(
+    // Inputs
+    const Vector3Field& ptsIn,
+    double toleranceIn,
+
+    // Outputs
+    Vector3Field& ptsOut,
+    IndexField& chVerticesOut,
+    std::vector<Face>& chFacesOut
+) {
+    return calculateConvexHull3dImpl(ptsIn, toleranceIn, ptsOut, chVerticesOut, chFacesOut);
+}
+
+
+int gaden::ConvexHullTools::calculateConvexHull3d(
+    // Inputs
+    const Vector3fField& ptsIn,
+    double toleranceIn,
+
+    // Outputs
+    Vector3Field& ptsOut,
+    IndexField& chVerticesOut,
+    std::vector<Face>& chFacesOut
+) {
+    return calculateConvexHull3dImpl(ptsIn, toleranceIn, ptsOut, chVerticesOut, chFacesOut);
+}
+
+
+int gaden::ConvexHullTools::calculateConvexHull3d(
+    // Inputs
+    const Vector3View& ptsIn,
+    double toleranceIn,
+
+    // Outputs
+    Vector3Field& ptsOut,
+    IndexField& chVerticesOut,
+    std::vector<Face>& chFacesOut
+) {
+    return calculateConvexHull3dImpl(ptsIn, toleranceIn, ptsOut, chVerticesOut, chFacesOut);
+}
+
+
+int gaden::ConvexHullTools::calculateConvexHull3d(
+    // Inputs
+    const Vector3iField& ptsIn,
+
+    // Outputs
+    Vector3Field& ptsOut,
+    IndexField& chVerticesOut,
+    std::vector<Face>& chFacesOut
+) {
+    return calculateConvexHull3dImpl(ptsIn, 0.0, ptsOut, chVerticesOut, chFacesOut);
+}
+
 
 int gaden::ConvexHullTools::calculateConvexHull2d(
     // Inputs
@@ -341,9 +502,9 @@ int gaden::ConvexHullTools::calculateConvexHull2d(
 
     // Outputs
     IndexedVector2Field& ptsOut,
-    IntField& verticesOut
+    IndexField& verticesOut
 ) {
-    int nPts = static_cast<int>(ptsIn.size());
+    index_t nPts = static_cast<index_t>(ptsIn.size());
 
     // Degenerate cases
     verticesOut.clear();
@@ -367,9 +528,9 @@ int gaden::ConvexHullTools::calculateConvexHull2d(
 
     // Lower hull
     ptsOut.clear();
-    int nA = static_cast<int>(ptsIn.size());
+    index_t nA = static_cast<index_t>(ptsIn.size());
     ptsOut.reserve(nA*2);
-    for (int i = 0; i < nA; ++i) {
+    for (index_t i = 0; i < nA; ++i) {
         while (ptsOut.size() >= 2) {
             const IndexedVector2 a = ptsOut[ptsOut.size()-2];
             const IndexedVector2 b = ptsOut[ptsOut.size()-1];
@@ -387,8 +548,8 @@ int gaden::ConvexHullTools::calculateConvexHull2d(
     }
 
     // Upper hull
-    const int lowerSize = static_cast<int>(ptsOut.size());
-    for (int i = ptsIn.size()-2; i >= 0; --i) {
+    const index_t lowerSize = static_cast<index_t>(ptsOut.size());
+    for (index_t i = ptsIn.size()-2; i >= 0; --i) {
         while (ptsOut.size() > lowerSize) {
             const IndexedVector2 a = ptsOut[ptsOut.size()-2];
             const IndexedVector2 b = ptsOut[ptsOut.size()-1];
@@ -411,8 +572,8 @@ int gaden::ConvexHullTools::calculateConvexHull2d(
 
     // Convert back to original indices (CCW polygon)
     verticesOut.reserve(ptsOut.size());
-    int nptsOut = static_cast<int>(ptsOut.size());
-    for (int i = 0; i < nptsOut; ++i) {
+    index_t nptsOut = static_cast<index_t>(ptsOut.size());
+    for (index_t i = 0; i < nptsOut; ++i) {
         verticesOut.push_back(ptsOut[i].idx());
     }
     return 2;
@@ -422,7 +583,7 @@ int gaden::ConvexHullTools::calculateConvexHull2d(
 gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Field& ptsIn) {
     MinRect mr;
     mr.clear();
-    const int nPts = static_cast<int>(ptsIn.size());
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
     if (nPts <= 0) {
         mr.valid() = false;
         return mr;
@@ -457,7 +618,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
     }
 
     // Initial edge (i=0): find extreme indices by a single scan
-    int iUmax = 0, iUmin = 0, iVmax = 0, iVmin = 0;
+    index_t iUmax = 0, iUmin = 0, iVmax = 0, iVmin = 0;
     {
         IndexedVector2 ue0;
         IndexedVector2 ve0;
@@ -468,7 +629,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
         double minV = ptsIn[0].dotProduct(ve0);
         double maxV = minV;
 
-        for (int k = 1; k < nPts; ++k) {
+        for (index_t k = 1; k < nPts; ++k) {
             const double su = ptsIn[k].dotProduct(ue0);
             const double sv = ptsIn[k].dotProduct(ve0);
             if (su < minU) {
@@ -493,7 +654,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
     }
 
     // Sweep all edges; advance support points while their projection improves.
-    for (int i = 1; i < nPts; ++i) {
+    for (index_t i = 1; i < nPts; ++i) {
         IndexedVector2 ue;
         IndexedVector2 ve;
         MinRect::calculateEdgeFrame(i, nPts, ptsIn, ue, ve);
@@ -502,7 +663,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
 
         // Umax (maximize dot with ue)
         for (;;) {
-            const int nxt = (iUmax + 1) % nPts;
+            const index_t nxt = (iUmax + 1) % nPts;
             const double cur = ptsIn[iUmax].dotProduct(ue);
             const double nxtv= ptsIn[nxt].dotProduct(ue);
             if (nxtv > cur) {
@@ -513,7 +674,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
         }
         // Umin (minimize dot with ue)
         for (;;) {
-            const int nxt = (iUmin + 1) % nPts;
+            const index_t nxt = (iUmin + 1) % nPts;
             const double cur = ptsIn[iUmin].dotProduct(ue);
             const double nxtv= ptsIn[nxt].dotProduct(ue);
             if (nxtv < cur) {
@@ -524,7 +685,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
         }
         // Vmax (maximize dot with ve)
         for (;;) {
-            const int nxt = (iVmax + 1) % nPts;
+            const index_t nxt = (iVmax + 1) % nPts;
             const double cur = ptsIn[iVmax].dotProduct(ve);
             const double nxtv= ptsIn[nxt ].dotProduct(ve);
             if (nxtv > cur) {
@@ -535,7 +696,7 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
         }
         // Vmin (minimize dot with ve)
         for (;;) {
-            const int nxt = (iVmin + 1) % nPts;
+            const index_t nxt = (iVmin + 1) % nPts;
             const double cur = ptsIn[iVmin].dotProduct(ve);
             const double nxtv= ptsIn[nxt].dotProduct(ve);
             if (nxtv < cur) {
@@ -566,3 +727,143 @@ gaden::MinRect gaden::ConvexHullTools::rotatingCalipers(const IndexedVector2Fiel
     mr.valid() = true;
     return mr;
 }
+
+
+gaden::MinRect gaden::ConvexHullTools::rotatingCalipersFast(const IndexedVector2Field& ptsIn) {
+    index_t supports[4] = {-1, -1, -1, -1};
+    return rotatingCalipersFast(ptsIn, supports);
+}
+
+
+gaden::MinRect gaden::ConvexHullTools::rotatingCalipersFast(
+    const IndexedVector2Field& ptsIn,
+    index_t supportsInOut[4]
+) {
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
+    if (nPts < 3) {
+        // Trivial cases are handled by the reference implementation
+        return rotatingCalipers(ptsIn);
+    }
+
+    // Projections onto the unnormalised edge frame: u along e = (ex, ey), v along (-ey, ex)
+    auto projU = [&ptsIn](index_t k, double ex, double ey) {
+        return ptsIn[k].x()*ex + ptsIn[k].y()*ey;
+    };
+    auto projV = [&ptsIn](index_t k, double ex, double ey) {
+        return ptsIn[k].y()*ex - ptsIn[k].x()*ey;
+    };
+
+    // Start from the first non-degenerate edge
+    index_t i0 = 0;
+    double ex = 0.0;
+    double ey = 0.0;
+    for (; i0 < nPts; ++i0) {
+        const index_t j = nextIndex(i0, nPts);
+        ex = ptsIn[j].x() - ptsIn[i0].x();
+        ey = ptsIn[j].y() - ptsIn[i0].y();
+        if (ex*ex + ey*ey > 0.0) {
+            break;
+        }
+    }
+    if (i0 == nPts) {
+        return rotatingCalipers(ptsIn);
+    }
+
+    // Initial edge: supports from the caller's hint by hill-climbing, or by a single scan
+    index_t iUmax = 0, iUmin = 0, iVmax = 0, iVmin = 0;
+    bool hinted = true;
+    for (int k = 0; k < 4; ++k) {
+        hinted &= supportsInOut[k] >= 0 && supportsInOut[k] < nPts;
+    }
+    if (hinted) {
+        iUmax = supportsInOut[0];
+        iUmin = supportsInOut[1];
+        iVmax = supportsInOut[2];
+        iVmin = supportsInOut[3];
+        climbSupport(iUmax, nPts, [&](index_t k) { return projU(k, ex, ey); });
+        climbSupport(iUmin, nPts, [&](index_t k) { return -projU(k, ex, ey); });
+        climbSupport(iVmax, nPts, [&](index_t k) { return projV(k, ex, ey); });
+        climbSupport(iVmin, nPts, [&](index_t k) { return -projV(k, ex, ey); });
+    } else {
+        double minU = projU(0, ex, ey);
+        double maxU = minU;
+        double minV = projV(0, ex, ey);
+        double maxV = minV;
+        for (index_t k = 1; k < nPts; ++k) {
+            const double su = projU(k, ex, ey);
+            const double sv = projV(k, ex, ey);
+            if (su < minU) {
+                minU = su; iUmin = k;
+            }
+            if (su > maxU) {
+                maxU = su; iUmax = k;
+            }
+            if (sv < minV) {
+                minV = sv; iVmin = k;
+            }
+            if (sv > maxV) {
+                maxV = sv; iVmax = k;
+            }
+        }
+    }
+    supportsInOut[0] = iUmax;
+    supportsInOut[1] = iUmin;
+    supportsInOut[2] = iVmax;
+    supportsInOut[3] = iVmin;
+
+    // Best edge so far, in unnormalised terms
+    double bestArea = std::numeric_limits<double>::infinity();
+    double bestDu = 0.0;
+    double bestDv = 0.0;
+    double bestLengthSqr = 1.0;
+    double bestEx = 1.0;
+    double bestEy = 0.0;
+    index_t bestEdge = -1;
+
+    // Sweep all edges; advance support points while their projection improves.
+    index_t i = i0;
+    for (index_t step = 0; step < nPts; ++step, i = nextIndex(i, nPts)) {
+        const index_t j = nextIndex(i, nPts);
+        ex = ptsIn[j].x() - ptsIn[i].x();
+        ey = ptsIn[j].y() - ptsIn[i].y();
+        const double lengthSqr = ex*ex + ey*ey;
+        if (lengthSqr <= 0.0) {
+            continue;
+        }
+
+        // Minima are tracked as maxima of the negated projection
+        double maxU = projU(iUmax, ex, ey);
+        double negMinU = -projU(iUmin, ex, ey);
+        double maxV = projV(iVmax, ex, ey);
+        double negMinV = -projV(iVmin, ex, ey);
+        advanceSupport(iUmax, maxU, nPts, [&](index_t k) { return projU(k, ex, ey); });
+        advanceSupport(iUmin, negMinU, nPts, [&](index_t k) { return -projU(k, ex, ey); });
+        advanceSupport(iVmax, maxV, nPts, [&](index_t k) { return projV(k, ex, ey); });
+        advanceSupport(iVmin, negMinV, nPts, [&](index_t k) { return -projV(k, ex, ey); });
+
+        // Both widths carry a factor |e|, true area = du*dv/|e|^2.  Compare without dividing.
+        const double du = maxU + negMinU;
+        const double dv = maxV + negMinV;
+        if (du*dv < bestArea*lengthSqr) {
+            bestArea = du*dv/lengthSqr;
+            bestDu = du;
+            bestDv = dv;
+            bestLengthSqr = lengthSqr;
+            bestEx = ex;
+            bestEy = ey;
+            bestEdge = i;
+        }
+    }
+
+    MinRect mr;
+    mr.clear();
+    const double length = std::sqrt(bestLengthSqr);
+    mr.area() = bestArea;
+    mr.width() = bestDu/length;
+    mr.height() = bestDv/length;
+    mr.parentEdge() = bestEdge;
+    // angle in the (u,v) plane
+    mr.psi() = std::atan2(bestEy, bestEx);
+    mr.valid() = true;
+    return mr;
+}
@@ -0,0 +1,95 @@
+#include "gaden/FrameChannel.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+
+bool gaden::FrameChannel::readBytes(char* data, size_t n) {
+    if (m_fd < 0) {
+        return static_cast<bool>(std::cin.read(data, n));
+    }
+#ifndef _WIN32
+    while (n > 0) {
+        const ssize_t got = ::read(m_fd, data, n);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        data += got;
+        n -= got;
+    }
+#endif
+    return true;
+}
+
+
+bool gaden::FrameChannel::writeBytes(const char* data, size_t n) {
+    if (m_fd < 0) {
+        return static_cast<bool>(std::cout.write(data, n));
+    }
+#ifndef _WIN32
+    while (n > 0) {
+        const ssize_t put = ::write(m_fd, data, n);
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            return false;
+        }
+        data += put;
+        n -= put;
+    }
+#endif
+    return true;
+}
+
+
+bool gaden::FrameChannel::skipBytes(size_t n) {
+    char chunk[65536];
+    while (n > 0) {
+        const size_t step = std::min(n, sizeof(chunk));
+        if (!readBytes(chunk, step)) {
+            return false;
+        }
+        n -= step;
+    }
+    return true;
+}
+
+
+bool gaden::FrameChannel::readFrame(std::string& frameOut, bool& tooLongOut) {
+    frameOut.clear();
+    tooLongOut = false;
+    unsigned char prefix[4];
+    if (!readBytes(reinterpret_cast<char*>(prefix), 4)) {
+        return false;
+    }
+    const std::uint32_t n =
+        prefix[0] | prefix[1] << 8 | prefix[2] << 16 | std::uint32_t(prefix[3]) << 24;
+    if (n > maxFrameBytes) {
+        tooLongOut = true;
+        return skipBytes(n);
+    }
+    frameOut.resize(n);
+    return n == 0 || readBytes(&frameOut[0], n);
+}
+
+
+bool gaden::FrameChannel::writeFrame(const std::string& frame) {
+    const std::uint32_t n = static_cast<std::uint32_t>(frame.size());
+    const char prefix[4] = {
+        char(n & 0xff), char(n >> 8 & 0xff), char(n >> 16 & 0xff), char(n >> 24 & 0xff)
+    };
+    const bool ok = writeBytes(prefix, 4) && writeBytes(frame.data(), frame.size());
+    if (m_fd < 0) {
+        std::cout.flush();
+    }
+    return ok;
+}
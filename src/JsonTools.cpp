@@ -0,0 +1,48 @@
+#include "gaden/JsonTools.hpp"
+
+#include <regex>
+
+
+std::string gaden::JsonTools::quote(const std::string& s) {
+    std::string out("\"");
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+
+bool gaden::JsonTools::field(
+    std::string& valueOut,
+    const std::string& json,
+    const std::string& key
+) {
+    std::smatch m;
+    const std::regex re(
+        "\"" + key + R"("\s*:\s*("(?:[^"\\]|\\.)*"|[-+0-9.eE]+|true|false|null))"
+    );
+    if (!std::regex_search(json, m, re)) {
+        return false;
+    }
+    valueOut = m[1].str();
+    return true;
+}
+
+
+std::string gaden::JsonTools::unquote(const std::string& quoted) {
+    std::string out;
+    for (size_t i = 1; i + 1 < quoted.size(); ++i) {
+        if (quoted[i] == '\\' && i + 2 < quoted.size()) {
+            ++i;
+        }
+        out += quoted[i];
+    }
+    return out;
+}
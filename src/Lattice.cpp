@@ -0,0 +1,137 @@
+#include "gaden/Lattice.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+gaden::Lattice gaden::Lattice::fit(const BoundBox& bb, double minSpacing) {
+    if (bb.empty()) {
+        return Lattice(Vector3(), minSpacing > 0.0 ? minSpacing : 1.0);
+    }
+    const Vector3 span = bb.maxPt() - bb.minPt();
+    const double extent = std::max(span.x(), std::max(span.y(), span.z()));
+    double spacing = minSpacing;
+    if (spacing <= 0.0) {
+        spacing = extent > 0.0 ? extent/maxCoord : 1.0;
+    }
+    // Rounding to nearest can reach extent/spacing + 1/2
+    while (extent/spacing + 0.5 > maxCoord) {
+        spacing *= 2.0;
+    }
+    return Lattice(bb.minPt(), spacing);
+}
+
+
+gaden::Vector3i gaden::Lattice::quantize(const Vector3& pt) const {
+    const double invSpacing = 1.0/m_spacing;
+    const Vector3 rel((pt - m_origin)*invSpacing);
+    const auto snap = [](double val) {
+        const double clamped = std::max(0.0, std::min(static_cast<double>(maxCoord), val));
+        return static_cast<std::int32_t>(std::llround(clamped));
+    };
+    return Vector3i(snap(rel.x()), snap(rel.y()), snap(rel.z()));
+}
+
+
+gaden::Vector3iField gaden::Lattice::quantize(const Vector3Field& ptsIn) const {
+    Vector3iField ptsOut(ptsIn.name());
+    ptsOut.reserve(ptsIn.size());
+    for (const Vector3& pt : ptsIn) {
+        ptsOut.push_back(quantize(pt));
+    }
+    return ptsOut;
+}
+
+
+gaden::Vector3Field gaden::Lattice::toWorld(const Vector3Field& latticePtsIn) const {
+    Vector3Field ptsOut(latticePtsIn.name());
+    ptsOut.reserve(latticePtsIn.size());
+    for (const Vector3& pt : latticePtsIn) {
+        ptsOut.push_back(toWorld(pt));
+    }
+    return ptsOut;
+}
+
+
+void gaden::Lattice::crossProduct(
+    // outputs
+    std::int64_t crossOut[3],
+
+    // inputs
+    const Vector3i& a, const Vector3i& b, const Vector3i& c
+) {
+    // Differences are within +/-2^30, each product within 2^60
+    const std::int64_t ux = std::int64_t(b.x()) - a.x();
+    const std::int64_t uy = std::int64_t(b.y()) - a.y();
+    const std::int64_t uz = std::int64_t(b.z()) - a.z();
+    const std::int64_t vx = std::int64_t(c.x()) - a.x();
+    const std::int64_t vy = std::int64_t(c.y()) - a.y();
+    const std::int64_t vz = std::int64_t(c.z()) - a.z();
+    crossOut[0] = uy*vz - uz*vy;
+    crossOut[1] = uz*vx - ux*vz;
+    crossOut[2] = ux*vy - uy*vx;
+}
+
+
+bool gaden::Lattice::collinear(const Vector3i& a, const Vector3i& b, const Vector3i& c) {
+    std::int64_t cross[3];
+    crossProduct(cross, a, b, c);
+    return cross[0] == 0 && cross[1] == 0 && cross[2] == 0;
+}
+
+
+double gaden::Lattice::orient3d(
+    const Vector3i& a, const Vector3i& b, const Vector3i& c, const Vector3i& d
+) {
+    // Filter, evaluate in double and keep the result when it is larger than the error bound of
+    // that evaluation (Shewchuk's orient3d bound, the differences are exact in double)
+    {
+        const double ux = double(b.x()) - a.x();
+        const double uy = double(b.y()) - a.y();
+        const double uz = double(b.z()) - a.z();
+        const double vx = double(c.x()) - a.x();
+        const double vy = double(c.y()) - a.y();
+        const double vz = double(c.z()) - a.z();
+        const double wx = double(d.x()) - a.x();
+        const double wy = double(d.y()) - a.y();
+        const double wz = double(d.z()) - a.z();
+        const double det =
+            (uy*vz - uz*vy)*wx + (uz*vx - ux*vz)*wy + (ux*vy - uy*vx)*wz;
+        const double permanent =
+            (std::fabs(uy*vz) + std::fabs(uz*vy))*std::fabs(wx)
+          + (std::fabs(uz*vx) + std::fabs(ux*vz))*std::fabs(wy)
+          + (std::fabs(ux*vy) + std::fabs(uy*vx))*std::fabs(wz);
+        const double errBound = 7.7715611723761027e-16*permanent;
+        if (det > errBound || -det > errBound) {
+            return det;
+        }
+    }
+
+    // Exact
+    std::int64_t cross[3];
+    crossProduct(cross, a, b, c);
+    const std::int64_t w[3] = {
+        std::int64_t(d.x()) - a.x(),
+        std::int64_t(d.y()) - a.y(),
+        std::int64_t(d.z()) - a.z()
+    };
+
+    // cross[k]*w[k] needs up to 92 bits.  Split each cross[k] into hi*2^32 + lo, lo in
+    // [0, 2^32), and accumulate hi*w and lo*w separately, moving the carry of each lo*w into the
+    // high sum.  Result is high*2^32 + low, with low in [0, 3*2^32).
+    std::int64_t high = 0;
+    std::int64_t low = 0;
+    for (int k = 0; k < 3; ++k) {
+        const std::int64_t hi = cross[k] >> 32;
+        const std::int64_t lo = cross[k] & 0xffffffffLL;
+        const std::int64_t loW = lo*w[k];
+        high += hi*w[k] + (loW >> 32);
+        low += loW & 0xffffffffLL;
+    }
+    if (high > -4 && high < 4) {
+        // Small enough to combine exactly
+        return static_cast<double>(high*4294967296LL + low);
+    }
+    // |high*2^32| > low, the sign is that of high
+    return static_cast<double>(high)*4294967296.0 + static_cast<double>(low);
+}
@@ -0,0 +1,583 @@
+#include "gaden/PartTools.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "gaden/AutoMergingPointCloud.hpp"
+#include "gaden/BoundBoxTools.hpp"
+#include "gaden/ConvexHullTools.hpp"
+#include "gaden/Lattice.hpp"
+#include "gaden/Logger.hpp"
+
+using namespace gaden;
+
+
+std::atomic<bool> gaden::PartTools::interrupted(false);
+
+
+void gaden::PartTools::buildHull(
+    // outputs
+    PreparedHull& hullOut,
+
+    // inputs
+    const AppOptions& opt,
+    Vector3Field& chPts,
+    IndexField& chVerts,
+    std::vector<Face>& chFaces,
+    Vector3Field& normals,
+    int nDims,
+    index_t nPts
+) {
+    const double chEpsilon = opt.epsilon;
+    const index_t nChPts = static_cast<index_t>(chPts.size());
+    Log_Info(""
+        << "Found a convex hull enclosing a " << ConvexHullTools::nDimsToWord(nDims)
+        << ", formed by " << nChPts << " critical points, a further reduction of "
+        << (nPts - nChPts) << " points"
+    );
+
+    // Keep the hull connectivity, box extents are found by hill-climbing on it
+    ConvexHullGraph hullGraph;
+    if (nDims == 3) {
+        hullGraph = ConvexHullGraph(chPts, chVerts, chFaces);
+    }
+
+    // Search on an epsilon-kernel instead of the full hull, chPts becomes the kernel points and
+    // the full hull is kept for measuring the final box
+    ConvexHullGraph fullGraph;
+    if (opt.kernel > 0.0 && !hullGraph.empty()) {
+        double kernelEpsilon = 0.0;
+        const IndexField kernel(hullGraph.epsilonKernel(opt.kernel, kernelEpsilon));
+        Vector3Field kernelPts;
+        kernelPts.reserve(kernel.size());
+        for (const index_t i : kernel) {
+            kernelPts.push_back(chPts[i]);
+        }
+        Log_Info(""
+            << "Epsilon-kernel of " << kernelPts.size() << " of " << nChPts << " hull points, "
+            << "epsilon " << kernelEpsilon << ", volume within a factor "
+            << 1.0/std::pow(1.0 - std::min(kernelEpsilon, 1.0), 3) << " of the hull's minimum"
+        );
+        chPts.swap(kernelPts);
+        fullGraph = std::move(hullGraph);
+        hullGraph = ConvexHullGraph(chPts, chEpsilon);
+    }
+
+    // Large hulls get a hierarchy too, its queries need no warm start.  A coherent sweep keeps
+    // its warm starts from cell to cell, hill-climbing on the graph is cheaper there.
+    ConvexHullHierarchy hullHierarchy;
+    if (!hullGraph.empty() && hullGraph.size() >= 5000 && !opt.coherent) {
+        hullHierarchy = ConvexHullHierarchy(hullGraph);
+    }
+
+    // Throw away unnecessary data
+    chVerts.clear();
+    chFaces.clear();
+
+    hullOut.m_chPts.swap(chPts);
+    hullOut.m_normals.swap(normals);
+    hullOut.m_hullGraph = std::move(hullGraph);
+    hullOut.m_fullGraph = std::move(fullGraph);
+    hullOut.m_hullHierarchy = std::move(hullHierarchy);
+    hullOut.m_nPoints = nPts;
+    hullOut.m_nHullPoints = nChPts;
+}
+
+
+double gaden::PartTools::readEpsilon(const AppOptions& opt) {
+    return opt.mergePoints && !opt.ladder && !opt.quantize ? opt.epsilon : 0.0;
+}
+
+
+bool gaden::PartTools::readsSinglePrecision(const AppOptions& opt) {
+    return (
+        opt.singlePoints && !opt.quantize && !opt.ladder
+     && !(opt.hasAxis && opt.coneDegrees <= 0.0)
+    );
+}
+
+
+bool gaden::PartTools::readSurface(
+    // outputs
+    Surface3& surfaceOut,
+    std::string& errorOut,
+
+    // inputs
+    const AppOptions& opt,
+    const std::string& filePath
+) {
+    Log_Info("Reading " << filePath);
+    std::ifstream iss(filePath);
+    if (!iss.is_open()) {
+        errorOut = "Failed to open file '" + filePath + "'";
+        return false;
+    }
+    surfaceOut = Surface3(iss, readEpsilon(opt), "", readsSinglePrecision(opt));
+    return true;
+}
+
+
+void gaden::PartTools::surfaceFromXyz(
+    // outputs
+    Surface3& surfaceOut,
+
+    // inputs
+    const AppOptions& opt,
+    const double* xyz,
+    size_t nPoints
+) {
+    surfaceOut.clear();
+    const double mergeEpsilon = readEpsilon(opt);
+    if (mergeEpsilon > 0.0) {
+        AutoMergingPointCloud merged(0, mergeEpsilon);
+        for (size_t i = 0; i < nPoints; ++i) {
+            merged.append(Vector3(xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]));
+        }
+        surfaceOut.points().vec().swap(std::move(merged).transfer().vec());
+    } else {
+        surfaceOut.points().vec().reserve(nPoints);
+        for (size_t i = 0; i < nPoints; ++i) {
+            surfaceOut.points().push_back(Vector3(xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]));
+        }
+    }
+}
+
+
+bool gaden::PartTools::prepareHull(
+    // outputs
+    PreparedHull& hullOut,
+    PartResult& resultOut,
+
+    // inputs
+    const AppOptions& opt,
+    Surface3& surface,
+    const std::chrono::steady_clock::time_point& startTime
+) {
+    resultOut = PartResult();
+    // Throw away all unnecessary data, keep only pruned points and the surface normals, which
+    // give candidate orientations.  Quantized points are kept as lattice coordinates instead,
+    // and points read in single precision stay so up to the hull.
+    Vector3Field pts;
+    Vector3fField singlePts;
+    Vector3iField latticePts;
+    Lattice lattice;
+    Vector3Field normals;
+    const bool single = surface.singlePrecision() && readsSinglePrecision(opt);
+    {
+        if (opt.quantize) {
+            surface.quantize(opt.epsilon);
+            latticePts.swap(surface.latticePoints());
+            lattice = surface.lattice();
+        } else if (single) {
+            singlePts.swap(surface.singlePoints());
+        } else {
+            pts.swap(surface.points());
+            for (const Vector3f& p : surface.singlePoints()) {
+                pts.push_back(Vector3(p));
+            }
+        }
+        normals.swap(surface.normals());
+        surface.clear();
+    }
+    double chEpsilon = opt.epsilon;
+
+    if (opt.ladder) {
+        // Progressive solve, merging and hull building happen per rung
+        Axes resultAxes;
+        Vector3 resultRotations;
+        int nRungs = 0;
+        const BoundBox minBb = BoundBoxTools::solveEpsilonLadder(
+            // outputs
+            resultAxes, resultRotations, nRungs,
+
+            // inputs
+            pts, opt.ladderTolerance, opt.epsilon, opt.ladderChange, opt.steps, opt.passes,
+            opt.epsilon
+        );
+        Log_Info(""
+            << "Done calculations, " << nRungs << " ladder rungs.  Results:\n"
+            << "BoundBox : " << minBb << "\n"
+            << "Axes     : " << resultAxes << "\n"
+            << "Rotations: " << resultRotations
+        );
+        resultOut.m_nPoints = static_cast<index_t>(pts.size());
+        resultOut.m_bb = minBb;
+        resultOut.m_axes = resultAxes;
+        resultOut.m_rotations = resultRotations;
+        resultOut.finish(startTime);
+        return false;
+    }
+
+    if (opt.hasAxis && opt.coneDegrees <= 0.0) {
+        // Fixed axis, one projection, 2d hull and calipers over every point, no 3d hull
+        if (opt.quantize) {
+            pts.reserve(latticePts.size());
+            for (const Vector3i& lp : latticePts) {
+                pts.push_back(lattice.toWorld(Vector3(lp.x(), lp.y(), lp.z())));
+            }
+        }
+        const OrientedBoundBox obb(BoundBoxTools::solveFixedAxis(pts, opt.axis, opt.epsilon));
+        Log_Info(""
+            << "Done calculations, fixed axis " << opt.axis << ".  Results:\n"
+            << "BoundBox : " << obb.localBb() << "\n"
+            << "Axes     : " << obb.axes() << "\n"
+            << "Rotations: " << obb.rotations()
+        );
+        resultOut.m_nPoints = static_cast<index_t>(pts.size());
+        resultOut.m_bb = obb.localBb();
+        resultOut.m_axes = obb.axes();
+        resultOut.m_rotations = obb.rotations();
+        resultOut.finish(startTime);
+        return false;
+    }
+
+    // Create 3d convex hull to prune internal points
+    Vector3Field chPts;
+    IndexField chVerts;
+    std::vector<Face> chFaces;
+
+    index_t nPts = static_cast<index_t>(
+        opt.quantize ? latticePts.size() : (single ? singlePts.size() : pts.size())
+    );
+    Log_Info(""
+        << "Calculating 3D convex hull from " << nPts << " unique points (after merging)...\n"
+        << "This identifies critical points, allowing the application to reduce the size of "
+        << "the \nproblem, improving CPU."
+    );
+
+    int nDims = 0;
+    if (opt.quantize) {
+        // Exact predicates, no tolerance
+        nDims = ConvexHullTools::calculateConvexHull3d(
+            // Inputs
+            latticePts,
+
+            // Outputs
+            chPts,
+            chVerts,
+            chFaces
+        );
+        chPts = lattice.toWorld(chPts);
+    } else if (single) {
+        // Read in single precision, measured in double
+        nDims = ConvexHullTools::calculateConvexHull3d(
+            // Inputs
+            singlePts,
+            chEpsilon,
+
+            // Outputs
+            chPts,
+            chVerts,
+            chFaces
+        );
+    } else {
+        nDims = ConvexHullTools::calculateConvexHull3d(
+            // Inputs
+            pts,
+            chEpsilon,
+
+            // Outputs
+            chPts,
+            chVerts,
+            chFaces
+        );
+    }
+
+    // Peak memory here
+    // Throw away unnecessary data
+    pts.clear();
+    singlePts.clear();
+    latticePts.clear();
+
+    buildHull(hullOut, opt, chPts, chVerts, chFaces, normals, nDims, nPts);
+    return true;
+}
+
+
+bool gaden::PartTools::hullsInPlace(const AppOptions& opt) {
+    return (
+        readEpsilon(opt) == 0.0 && !opt.quantize && !opt.ladder
+     && !(opt.hasAxis && opt.coneDegrees <= 0.0)
+    );
+}
+
+
+void gaden::PartTools::prepareHullInPlace(
+    // outputs
+    PreparedHull& hullOut,
+
+    // inputs
+    const AppOptions& opt,
+    const Vector3View& pts
+) {
+    Vector3Field chPts;
+    IndexField chVerts;
+    std::vector<Face> chFaces;
+    const index_t nPts = static_cast<index_t>(pts.size());
+    Log_Info("Calculating 3D convex hull in place from " << nPts << " points");
+    const int nDims = ConvexHullTools::calculateConvexHull3d(
+        // Inputs
+        pts,
+        opt.epsilon,
+
+        // Outputs
+        chPts,
+        chVerts,
+        chFaces
+    );
+    Vector3Field normals;
+    buildHull(hullOut, opt, chPts, chVerts, chFaces, normals, nDims, nPts);
+}
+
+
+void gaden::PartTools::solveHull(
+    // outputs
+    PartResult& resultOut,
+
+    // inputs
+    const AppOptions& opt,
+    PreparedHull& hull,
+    ThreadPool* pool,
+    const std::chrono::steady_clock::time_point& startTime
+) {
+    resultOut = PartResult();
+    const Vector3Field& chPts = hull.m_chPts;
+    Vector3Field& normals = hull.m_normals;
+    const ConvexHullGraph& hullGraph = hull.m_hullGraph;
+    const ConvexHullGraph& fullGraph = hull.m_fullGraph;
+    const ConvexHullHierarchy& hullHierarchy = hull.m_hullHierarchy;
+    const index_t nChPts = hull.m_nHullPoints;
+
+    Axes resultAxes;
+    Vector3 resultRotations;
+    BoundBox minBb;
+
+    // Warm start from cheap candidate orientations
+    OrientedBoundBox seed;
+    if (opt.seed || opt.solver == "seeded") {
+        seed = BoundBoxTools::solveSeeded(chPts, opt.epsilon);
+        Log_Info("Seeded incumbent volume " << seed.volume());
+    }
+    if (opt.seed || opt.solver == "normals") {
+        OrientedBoundBox fromNormals(
+            BoundBoxTools::solveFromNormals(chPts, normals, opt.epsilon)
+        );
+        Log_Info("Surface normals incumbent volume " << fromNormals.volume());
+        if (fromNormals.betterThan(seed)) {
+            seed = fromNormals;
+        }
+    }
+    normals.clear();
+
+    if (opt.hasAxis) {
+        // Third axis within the cone about opt.axis
+        const OrientedBoundBox obb(BoundBoxTools::solveAxisCone(
+            chPts, opt.axis, opt.coneDegrees, opt.steps, opt.passes, opt.epsilon
+        ));
+        minBb = obb.localBb();
+        resultAxes = obb.axes();
+        resultRotations = obb.rotations();
+        Log_Info(""
+            << "Axis cone of " << opt.coneDegrees << " degrees about " << opt.axis
+            << ", box axis tilted " << std::acos(std::min(1.0, std::fabs(
+                resultAxes.z().dotProduct(opt.axis)))
+            )*180.0/constants::pi << " degrees"
+        );
+    } else if (opt.autoAccuracy > 0.0) {
+        // Grid schedule chosen at runtime, in what is left of the budget if there is one
+        double budgetMs = 0.0;
+        if (opt.timeBudgetMs > 0) {
+            budgetMs = std::max(
+                1.0,
+                opt.timeBudgetMs - std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - startTime
+                ).count()
+            );
+        }
+        BoundBoxTools::AutoTuneReport report;
+        minBb = BoundBoxTools::solveAutoTuned(
+            // outputs
+            resultAxes, resultRotations, report,
+
+            // inputs
+            chPts, opt.autoAccuracy, budgetMs, opt.epsilon, seed, &hullGraph, &hullHierarchy
+        );
+        std::ostringstream schedule;
+        for (const int steps : report.m_steps) {
+            schedule << " " << steps;
+        }
+        Log_Info(""
+            << "Auto-tuned grid: " << report.m_evaluationMs << " ms per evaluation, steps per "
+            << "pass" << schedule.str() << " over " << report.m_nBasins << " basins, "
+            << report.m_nEvaluations << " evaluations\n"
+            << "Relative volume error, target " << opt.autoAccuracy << ", model estimate "
+            << report.m_estimatedError << ", certified " << report.m_achievedError
+        );
+    } else if (opt.timeBudgetMs > 0) {
+        // Anytime search in what is left of the budget, Ctrl+C also stops it early
+        BoundBoxTools::StopCondition stop;
+        stop.m_deadline = startTime + std::chrono::milliseconds(opt.timeBudgetMs);
+        stop.m_cancel = &interrupted;
+        double gap = 0.0;
+        int nEvals = 0;
+        minBb = BoundBoxTools::solveAnytime(
+            // outputs
+            resultAxes, resultRotations, gap, nEvals,
+
+            // inputs
+            chPts, stop, opt.epsilon, seed, &hullGraph, &hullHierarchy
+        );
+        Log_Info(""
+            << "Anytime search evaluated " << nEvals << " orientations"
+            << (interrupted.load() ? ", interrupted" : "") << ", certified optimality gap "
+            << gap
+        );
+    } else if (opt.solver == "seeded" || opt.solver == "normals") {
+        minBb = seed.localBb();
+        resultAxes = seed.axes();
+        resultRotations = seed.rotations();
+    } else if (
+        opt.solver == "grid" && !opt.hasSteps && !opt.hasPasses && !opt.hasBeam && !opt.coherent
+     && !opt.hasFloat32 && !hullGraph.empty()
+     && hullGraph.size() <= BoundBoxTools::smallHullAutoMaxVerts
+    ) {
+        // Small hull and no grid settings asked for, enumerating the candidate boxes is exact and
+        // no dearer than the grid at this size
+        int nCandidates = 0;
+        OrientedBoundBox obb(BoundBoxTools::solveSmallHull(hullGraph, &nCandidates));
+        if (seed.betterThan(obb)) {
+            obb = seed;
+        }
+        minBb = obb.localBb();
+        resultAxes = obb.axes();
+        resultRotations = obb.rotations();
+        Log_Info(""
+            << "Small hull of " << hullGraph.size() << " vertices, solved from "
+            << nCandidates << " candidate boxes"
+        );
+    } else if (opt.solver == "bnb") {
+        double gap = 0.0;
+        int nEvals = 0;
+        minBb = BoundBoxTools::solveBranchAndBound(
+            // outputs
+            resultAxes, resultRotations, gap, nEvals,
+
+            // inputs
+            chPts, opt.gap, opt.maxEvals, opt.epsilon, seed, &hullGraph, &hullHierarchy
+        );
+        Log_Info(""
+            << "Branch-and-bound evaluated " << nEvals << " orientations, certified optimality "
+            << "gap " << gap
+        );
+    } else {
+        minBb = BoundBox::solveMinimumRotatedBoundBox(
+            // outputs
+            resultAxes, resultRotations,
+
+            // inputs
+            chPts, opt.steps, opt.passes, opt.epsilon, opt.beam, seed, opt.coherent, &hullGraph,
+            &hullHierarchy, opt.float32, nChPts >= parallelGridMinVerts ? pool : nullptr
+        );
+    }
+
+    if (!fullGraph.empty()) {
+        // Exact extents of the full hull along the axes found on the kernel
+        index_t supports[ConvexHullGraph::nExtentSlots] = {-1, -1, -1, -1, -1, -1};
+        minBb = fullGraph.extents(resultAxes, supports);
+    }
+
+    Log_Info(""
+        << "Done calculations.  Results:\n"
+        << "BoundBox : " << minBb << "\n"
+        << "Axes     : " << resultAxes << "\n"
+        << "Rotations: " << resultRotations
+    );
+    resultOut.m_nPoints = hull.m_nPoints;
+    resultOut.m_nHullPoints = nChPts;
+    resultOut.m_bb = minBb;
+    resultOut.m_axes = resultAxes;
+    resultOut.m_rotations = resultRotations;
+    resultOut.finish(startTime);
+}
+
+
+void gaden::PartTools::solveSurface(
+    // outputs
+    PartResult& resultOut,
+
+    // inputs
+    const AppOptions& opt,
+    Surface3& surface,
+    ThreadPool* pool,
+    const std::chrono::steady_clock::time_point& startTime
+) {
+    PreparedHull hull;
+    if (prepareHull(hull, resultOut, opt, surface, startTime)) {
+        solveHull(resultOut, opt, hull, pool, startTime);
+    }
+}
+
+
+void gaden::PartTools::solvePoints(
+    // outputs
+    PartResult& resultOut,
+
+    // inputs
+    const AppOptions& opt,
+    const double* xyz,
+    size_t nPoints,
+    ThreadPool* pool,
+    const std::chrono::steady_clock::time_point& startTime
+) {
+    if (!hullsInPlace(opt)) {
+        Surface3 surface;
+        surfaceFromXyz(surface, opt, xyz, nPoints);
+        solveSurface(resultOut, opt, surface, pool, startTime);
+        return;
+    }
+    PreparedHull hull;
+    prepareHullInPlace(hull, opt, Vector3View(xyz, static_cast<index_t>(nPoints)));
+    solveHull(resultOut, opt, hull, pool, startTime);
+}
+
+
+int gaden::PartTools::solveParts(
+    const std::function<void(const PartResult&)>& onResult,
+    const AppOptions& opt,
+    const Surface3& surface,
+    ThreadPool& pool
+) {
+    const IndexField& offsets = surface.partOffsets();
+    const int nParts = static_cast<int>(surface.nParts());
+    std::vector<int> order(nParts);
+    for (int i = 0; i < nParts; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&offsets](int a, int b) {
+        return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+    });
+    Log_Info("Solving " << nParts << " parts on " << pool.size() << " threads");
+    std::atomic<int> nFailed(0);
+    pool.parallelFor(0, nParts, 1, [&](int k) {
+        const std::chrono::steady_clock::time_point startTime =
+            std::chrono::steady_clock::now();
+        const int i = order[k];
+        PartResult result;
+        try {
+            Surface3 part(surface.extractPart(i));
+            solveSurface(result, opt, part, &pool, startTime);
+        } catch (const std::exception& e) {
+            result = PartResult();
+            result.m_error = e.what();
+        }
+        result.m_hasPartId = true;
+        result.m_partId = surface.partIds()[i];
+        if (!result.m_ok) {
+            nFailed.fetch_add(1);
+        }
+        onResult(result);
+    });
+    return nFailed.load();
+}
@@ -1,14 +1,260 @@
 #include "gaden/PointCloudTools.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <unordered_map>
 
 #include "gaden/AutoMergingPointCloud.hpp"
 
+namespace { // anonymous
+
+// mergePointsSubset for either precision
+template <class Scalar>
+void mergePointsSubsetImpl(
+    const gaden::VectorNField<gaden::Vector3T<Scalar>>& ptsIn,
+    double mergeTol,
+    gaden::index_t estimatedSize,
+    gaden::IndexField& mapOut,
+    gaden::VectorNField<gaden::Vector3T<Scalar>>& ptsOut
+) {
+    mapOut.clear();
+    mapOut.reserve(ptsIn.size());
+    std::string mergedName = ptsIn.name() + "_merged";
+    gaden::AutoMergingPointCloudT<Scalar> amp(estimatedSize, mergeTol, mergedName);
+    for (const gaden::Vector3T<Scalar>& pt : ptsIn) {
+        mapOut.push_back(amp.append(pt).second);
+    }
+    ptsOut = std::move(amp).transfer();
+}
+
+
+// Grid cell coordinate of val, clamped so that the conversion is defined for any input.  Clamped
+// points share an edge cell, that only adds merge candidates.
+long long gridCell(double val, double invCellSize) {
+    const double cell = std::floor(val*invCellSize);
+    const double limit = 4.0e18;
+    return static_cast<long long>(std::max(-limit, std::min(limit, cell)));
+}
+
+
+// Core of the 2d merge.  Points are taken in order, each merges with the earliest kept point
+// within mergeTol or is kept.  Kept points are hashed into a grid of 2*mergeTol cells, so the
+// candidates are the chains of the 2 x 2 cells nearest a point.
+//  Outputs
+//      * mapOut - mapOut[ptsIndex] = kept index, kept indices are numbered in order of first use
+//  Returns the number of kept points
+gaden::index_t mergePoints2dCore(
+    const gaden::IndexedVector2Field& pts,
+    double mergeTol,
+    gaden::IndexField& mapOut
+) {
+    using namespace gaden;
+    const gaden::index_t nPts = static_cast<gaden::index_t>(pts.size());
+    mapOut.resize(nPts);
+
+    // Any positive cell size works for a zero tolerance, only exact duplicates merge
+    const double tolSqr = mergeTol*mergeTol;
+    const double invCellSize = mergeTol > 0.0 ? 0.5/mergeTol : 1.0;
+
+    // Open addressing table of occupied cells, each heads a chain of kept points
+    struct Slot {
+        long long m_cx;
+        long long m_cy;
+        gaden::index_t m_head;
+    };
+    gaden::index_t tableSize = 16;
+    while (tableSize < 2*nPts) {
+        tableSize *= 2;
+    }
+    const std::size_t mask = tableSize - 1;
+    std::vector<Slot> table(tableSize, Slot{0, 0, -1});
+    auto findSlot = [&](long long cx, long long cy) -> Slot& {
+        std::uint64_t h =
+            static_cast<std::uint64_t>(cx)*0x9E3779B97F4A7C15ull
+          ^ static_cast<std::uint64_t>(cy)*0xC2B2AE3D27D4EB4Full;
+        std::size_t i = (h ^ (h >> 29)) & mask;
+        while (table[i].m_head >= 0 && (table[i].m_cx != cx || table[i].m_cy != cy)) {
+            i = (i + 1) & mask;
+        }
+        return table[i];
+    };
+
+    std::vector<gaden::index_t> keptPts;
+    std::vector<gaden::index_t> keptNext;
+    keptPts.reserve(nPts);
+    keptNext.reserve(nPts);
+    for (gaden::index_t i = 0; i < nPts; ++i) {
+        const IndexedVector2& pt = pts[i];
+        const long long cx = gridCell(pt.x(), invCellSize);
+        const long long cy = gridCell(pt.y(), invCellSize);
+
+        // Within mergeTol is within half a cell, only the cell and its neighbours on the near side
+        const long long nearX = pt.x()*invCellSize - cx < 0.5 ? -1 : 1;
+        const long long nearY = pt.y()*invCellSize - cy < 0.5 ? -1 : 1;
+        gaden::index_t match = -1;
+        for (long long dx = std::min(nearX, 0ll); dx <= std::max(nearX, 0ll); ++dx) {
+            for (long long dy = std::min(nearY, 0ll); dy <= std::max(nearY, 0ll); ++dy) {
+                const gaden::index_t head = findSlot(cx + dx, cy + dy).m_head;
+                for (gaden::index_t k = head; k >= 0; k = keptNext[k]) {
+                    if ((match < 0 || k < match) && (pt - pts[keptPts[k]]).magSqr() <= tolSqr) {
+                        match = k;
+                    }
+                }
+            }
+        }
+        if (match >= 0) {
+            mapOut[i] = match;
+            continue;
+        }
+        const gaden::index_t newIndex = static_cast<gaden::index_t>(keptPts.size());
+        Slot& slot = findSlot(cx, cy);
+        slot.m_cx = cx;
+        slot.m_cy = cy;
+        keptNext.push_back(slot.m_head);
+        slot.m_head = newIndex;
+        keptPts.push_back(i);
+        mapOut[i] = newIndex;
+    }
+    return static_cast<gaden::index_t>(keptPts.size());
+}
+
+
+// Insertion sort, abandoned once more than maxMoves elements have been shifted.  Returns false if
+// abandoned, pts is then a permutation of the input but not sorted.
+bool insertionSortBounded(gaden::IndexedVector2Field& pts, long long maxMoves) {
+    long long nMoves = 0;
+    const gaden::index_t n = static_cast<gaden::index_t>(pts.size());
+    for (gaden::index_t i = 1; i < n; ++i) {
+        if (!(pts[i] < pts[i - 1])) {
+            continue;
+        }
+        const gaden::IndexedVector2 tmp(pts[i]);
+        gaden::index_t j = i;
+        while (j > 0 && tmp < pts[j - 1]) {
+            pts[j] = pts[j - 1];
+            --j;
+        }
+        pts[j] = tmp;
+        nMoves += i - j;
+        if (nMoves > maxMoves) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Order-preserving map from a double to an unsigned key: flip every bit of negatives, only the
+// sign bit of positives.  -0.0 is folded onto 0.0 first, they compare equal.
+std::uint64_t orderedKey(double val) {
+    val += 0.0;
+    std::uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    const std::uint64_t signMask = std::uint64_t(1) << 63;
+    return (bits & signMask) ? ~bits : (bits | signMask);
+}
+
+
+// A compact radix sort entry, the point is gathered back from slot m_slot at the end
+struct RadixEntry {
+    std::uint64_t m_key;
+    gaden::index_t m_slot;
+};
+
+} // end anonymous namespace
+
+
+void gaden::PointCloudTools::radixSortLexicographic(IndexedVector2Field& pts) {
+    const index_t n = static_cast<index_t>(pts.size());
+    if (n < 2) {
+        return;
+    }
+
+    // Entries are laid out in idx order, so the stable passes leave equal x in idx order.  That
+    // needs the tags to be a permutation of [0, n), otherwise use std::sort.
+    std::vector<RadixEntry> entries(n);
+    std::vector<char> filled(n, 0);
+    for (index_t k = 0; k < n; ++k) {
+        const index_t slot = pts[k].idx();
+        if (slot < 0 || slot >= n || filled[slot]) {
+            std::sort(pts.begin(), pts.end());
+            return;
+        }
+        filled[slot] = 1;
+        entries[slot].m_slot = k;
+    }
+
+    // 8-bit digits of the x key, least significant first, histograms for every pass are taken in
+    // one read.  Wider digits cost more than they save in passes (sandbox_bench radix).
+    const int radixBits = 8;
+    const int nPasses = (64 + radixBits - 1)/radixBits;
+    const int nBuckets = 1 << radixBits;
+    const std::uint64_t digitMask = nBuckets - 1;
+    std::vector<index_t> counts(nPasses*nBuckets, 0);
+    for (RadixEntry& e : entries) {
+        e.m_key = orderedKey(pts[e.m_slot].x());
+        for (int pass = 0; pass < nPasses; ++pass) {
+            ++counts[pass*nBuckets + ((e.m_key >> (radixBits*pass)) & digitMask)];
+        }
+    }
+
+    std::vector<RadixEntry> scratch(n);
+    for (int pass = 0; pass < nPasses; ++pass) {
+        index_t* count = counts.data() + pass*nBuckets;
+        const int shift = radixBits*pass;
+        if (count[(entries[0].m_key >> shift) & digitMask] == n) {
+            // Every key shares this digit, nothing moves
+            continue;
+        }
+        index_t offset = 0;
+        for (int d = 0; d < nBuckets; ++d) {
+            const index_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (const RadixEntry& e : entries) {
+            scratch[count[(e.m_key >> shift) & digitMask]++] = e;
+        }
+        entries.swap(scratch);
+    }
+
+    // Gather, then order each run of equal x by (y, idx), runs are rare and short
+    const std::vector<IndexedVector2> unsorted(pts.begin(), pts.end());
+    for (index_t k = 0; k < n; ++k) {
+        pts[k] = unsorted[entries[k].m_slot];
+    }
+    for (index_t k = 0; k < n - 1; ++k) {
+        if (entries[k].m_key != entries[k + 1].m_key) {
+            continue;
+        }
+        index_t end = k + 1;
+        while (end < n && entries[end].m_key == entries[k].m_key) {
+            ++end;
+        }
+        std::sort(pts.begin() + k, pts.begin() + end);
+        k = end - 1;
+    }
+}
+
+
+void gaden::PointCloudTools::sortLexicographic(IndexedVector2Field& pts) {
+    const index_t n = static_cast<index_t>(pts.size());
+    if (n >= radixSortMinSize && n <= radixSortMaxSize) {
+        radixSortLexicographic(pts);
+    } else {
+        std::sort(pts.begin(), pts.end());
+    }
+}
+
+
 void gaden::PointCloudTools::mergePointsMap(
     const Vector3Field& ptsIn,
     double mergeTol,
-    int estimatedSize,
-    IntField& mapOut
+    gaden::index_t estimatedSize,
+    IndexField& mapOut
 ) {
     Vector3Field unused;
     mergePointsSubset(
@@ -20,27 +266,132 @@ void gaden::PointCloudTools::mergePointsMap(
 void gaden::PointCloudTools::mergePointsSubset(
     const Vector3Field& ptsIn,
     double mergeTol,
-    int estimatedSize,
-    IntField& mapOut,
+    gaden::index_t estimatedSize,
+    IndexField& mapOut,
     Vector3Field& ptsOut
 ) {
+    mergePointsSubsetImpl(ptsIn, mergeTol, estimatedSize, mapOut, ptsOut);
+}
+
+
+void gaden::PointCloudTools::mergePointsMap(
+    const Vector3fField& ptsIn,
+    double mergeTol,
+    gaden::index_t estimatedSize,
+    IndexField& mapOut
+) {
+    Vector3fField unused;
+    mergePointsSubset(
+        ptsIn, mergeTol, estimatedSize, mapOut, unused
+    );
+}
+
+
+void gaden::PointCloudTools::mergePointsSubset(
+    const Vector3fField& ptsIn,
+    double mergeTol,
+    gaden::index_t estimatedSize,
+    IndexField& mapOut,
+    Vector3fField& ptsOut
+) {
+    mergePointsSubsetImpl(ptsIn, mergeTol, estimatedSize, mapOut, ptsOut);
+}
+
+
+void gaden::PointCloudTools::mergeLatticeSubset(
+    const Vector3iField& ptsIn,
+    IndexField& mapOut,
+    Vector3iField& ptsOut
+) {
+    // Key on all 90 bits of the lattice coordinates
+    struct Key {
+        std::int32_t x, y, z;
+        bool operator==(const Key& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const noexcept {
+            std::uint64_t h = static_cast<std::uint32_t>(k.x);
+            h = h*0x9e3779b97f4a7c15ull ^ static_cast<std::uint32_t>(k.y);
+            h = h*0x9e3779b97f4a7c15ull ^ static_cast<std::uint32_t>(k.z);
+            return static_cast<std::size_t>(h ^ (h >> 29));
+        }
+    };
+
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
+    std::unordered_map<Key, index_t, KeyHash> kept;
+    kept.reserve(nPts);
     mapOut.clear();
-    mapOut.reserve(ptsIn.size());
-    std::string mergedName = ptsIn.name() + "_merged";
-    AutoMergingPointCloud amp(estimatedSize, mergeTol, mergedName);
-    for (const Vector3& pt : ptsIn) {
-        mapOut.push_back(amp.append(pt).second);
+    mapOut.reserve(nPts);
+    Vector3iField merged(ptsIn.name() + "_merged");
+    for (const Vector3i& pt : ptsIn) {
+        const auto inserted =
+            kept.emplace(Key{pt.x(), pt.y(), pt.z()}, static_cast<index_t>(merged.size()));
+        if (inserted.second) {
+            merged.push_back(pt);
+        }
+        mapOut.push_back(inserted.first->second);
     }
-    ptsOut = std::move(amp).transfer();
+    ptsOut = std::move(merged);
 }
 
 
-void gaden::PointCloudTools::projectPointsToPlane(
-    const Vector3Field& ptsIn,
+void gaden::PointCloudTools::mergePoints2dMap(
+    const IndexedVector2Field& ptsIn,
+    double mergeTol,
+    IndexField& mapOut
+) {
+    mergePoints2dCore(ptsIn, mergeTol, mapOut);
+}
+
+
+void gaden::PointCloudTools::mergePoints2dSubset(
+    const IndexedVector2Field& ptsIn,
+    double mergeTol,
+    IndexField& mapOut,
+    IndexedVector2Field& ptsOut
+) {
+    const index_t nKept = mergePoints2dCore(ptsIn, mergeTol, mapOut);
+    ptsOut.clear();
+    ptsOut.reserve(nKept);
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
+    for (index_t i = 0; i < nPts; ++i) {
+        if (mapOut[i] == static_cast<index_t>(ptsOut.size())) {
+            // First use of this kept index
+            ptsOut.push_back(ptsIn[i]);
+        }
+    }
+}
+
+
+void gaden::PointCloudTools::mergePoints2d(double mergeTol, IndexedVector2Field& ptsInOut) {
+    // Sorted by x with every gap wider than mergeTol, as for most projections, nothing can merge
+    const index_t nPts = static_cast<index_t>(ptsInOut.size());
+    bool separated = true;
+    for (index_t i = 1; i < nPts && separated; ++i) {
+        separated = ptsInOut[i].x() - ptsInOut[i - 1].x() > mergeTol;
+    }
+    if (separated) {
+        return;
+    }
+
+    IndexField map;
+    mergePoints2dCore(ptsInOut, mergeTol, map);
+    index_t nKept = 0;
+    for (index_t i = 0; i < nPts; ++i) {
+        if (map[i] == nKept) {
+            ptsInOut[nKept++] = ptsInOut[i];
+        }
+    }
+    ptsInOut.erase(ptsInOut.begin() + nKept, ptsInOut.end());
+}
+
+
+bool gaden::PointCloudTools::calculateProjectionFrame(
     double thetaIn,
     double phiIn,
-    double toleranceIn,
-    IndexedVector2Field& ptsOut
+    Vector3& uOut,
+    Vector3& vOut,
+    Vector3& wOut
 ) {
     // Build 3D orthonormal frame (u,v,w) from (thetaIn,phiIn)
     //  * thetaIn = heading (yaw) about +Z;
@@ -52,53 +403,82 @@ void gaden::PointCloudTools::projectPointsToPlane(
     const double sph = std::sin(phiIn);
 
     // w points where we "look": in spherical-like terms with elevation=phiIn from XY
-    Vector3 w(cth*cph, sth*cph, sph);
-    w.normalise();
+    wOut = Vector3(cth*cph, sth*cph, sph);
+    bool success = wOut.normalise();
 
     // Build u perpendicular to w (helper axis t arbitrary, not parallel to w)
-    Vector3 t = (std::fabs(w.z()) < 0.9) ? Vector3(0.0, 0.0, 1.0) : Vector3(1.0, 0.0, 0.0);
+    Vector3 t = (std::fabs(wOut.z()) < 0.9) ? Vector3(0.0, 0.0, 1.0) : Vector3(1.0, 0.0, 0.0);
     // subtract component along w
-    Vector3 u = t - w*w.dotProduct(t);
-    u.normalise();
+    uOut = t - wOut*wOut.dotProduct(t);
+    success &= uOut.normalise();
 
     // v completes right-handed frame
     // v perpendicular to u,w
-    Vector3 v = w.crossProduct(u);
-    v.normalise();
+    vOut = wOut.crossProduct(uOut);
+    success &= vOut.normalise();
+    return success;
+}
+
+
+void gaden::PointCloudTools::projectPointsToPlane(
+    const Vector3Field& ptsIn,
+    double thetaIn,
+    double phiIn,
+    double toleranceIn,
+    IndexedVector2Field& ptsOut
+) {
+    Vector3 u;
+    Vector3 v;
+    Vector3 w;
+    calculateProjectionFrame(thetaIn, phiIn, u, v, w);
 
     // Project all points into (u,v) coordinates
-    const int nPts = static_cast<int>(ptsIn.size());
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
     ptsOut.reserve(nPts);
-    for (int i = 0; i < nPts; ++i) {
+    for (index_t i = 0; i < nPts; ++i) {
         const Vector3& p = ptsIn[i];
         const double x = p.dotProduct(u);
         const double y = p.dotProduct(v);
         ptsOut.emplace_back(x, y, i);
     }
 
-    // TODO - pull this out as a 2d point merge algorithm
-    // 2D point merging - lexicographic(x,y) merge method to remove duplicates (if any)
-    std::sort(ptsOut.begin(), ptsOut.end());
-    IndexedVector2Field::const_iterator readIter = ptsOut.cbegin();
-    IndexedVector2Field::iterator writeIter = ptsOut.begin();
-    if (writeIter == ptsOut.end() || ++writeIter == ptsOut.end()) {
-        // There are zero or one points
-        return;
+    sortLexicographic(ptsOut);
+    mergePoints2d(toleranceIn, ptsOut);
+}
+
+
+void gaden::PointCloudTools::projectPointsToPlaneCoherent(
+    const Vector3Field& ptsIn,
+    double thetaIn,
+    double phiIn,
+    double toleranceIn,
+    IndexField& orderInOut,
+    IndexedVector2Field& ptsOut
+) {
+    Vector3 u;
+    Vector3 v;
+    Vector3 w;
+    calculateProjectionFrame(thetaIn, phiIn, u, v, w);
+
+    // Project in the previous sorted order, if there is one
+    const index_t nPts = static_cast<index_t>(ptsIn.size());
+    const bool hasOrder = static_cast<index_t>(orderInOut.size()) == nPts;
+    ptsOut.reserve(nPts);
+    for (index_t k = 0; k < nPts; ++k) {
+        const index_t i = hasOrder ? orderInOut[k] : k;
+        const Vector3& p = ptsIn[i];
+        ptsOut.emplace_back(p.dotProduct(u), p.dotProduct(v), i);
+    }
+
+    // Nearly sorted after a small rotation, insertion sort is close to linear.  Give up on it if
+    // the order has changed too much.
+    const long long maxMoves = static_cast<long long>(2.0*nPts*std::log2(nPts + 1.0));
+    if (!hasOrder || !insertionSortBounded(ptsOut, maxMoves)) {
+        sortLexicographic(ptsOut);
     }
-    // Confirmed at least two points exist
-    readIter += 2;
-    // writeIter starts at index 1 (second element)
-    // readIter starts at index 2 (third element)
-    double tolSqr = toleranceIn*toleranceIn;
-    while (readIter != ptsOut.cend()) {
-        const IndexedVector2& rd(*readIter);
-        IndexedVector2& wr(*writeIter);
-        IndexedVector2 delta = rd-wr;
-        if (delta.magSqr() > tolSqr) {
-            // Confirmed two points are too far apart to overlap
-            wr = rd;
-            ++writeIter;
-        }
-        ++readIter;
+    orderInOut.resize(nPts);
+    for (index_t k = 0; k < nPts; ++k) {
+        orderInOut[k] = ptsOut[k].idx();
     }
+    mergePoints2d(toleranceIn, ptsOut);
 }
@@ -0,0 +1,43 @@
+#include "gaden/ServiceMetrics.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+
+void gaden::ServiceMetrics::add(double totalMs, bool ok) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_nRequests;
+    m_nFailed += ok ? 0 : 1;
+    if (m_recentMs.size() < nRecent) {
+        m_recentMs.push_back(totalMs);
+    } else {
+        m_recentMs[m_next] = totalMs;
+    }
+    m_next = (m_next + 1) % nRecent;
+}
+
+
+std::string gaden::ServiceMetrics::json() {
+    std::vector<double> ms;
+    std::ostringstream os;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ms = m_recentMs;
+        os << "{\"requests\":" << m_nRequests << ",\"failed\":" << m_nFailed;
+    }
+    std::sort(ms.begin(), ms.end());
+    const auto percentile = [&ms](double p) {
+        return ms.empty() ? 0.0 : ms[std::min(ms.size() - 1, size_t(p*ms.size()))];
+    };
+    double sum = 0.0;
+    for (const double m : ms) {
+        sum += m;
+    }
+    os
+        << ",\"latencyMs\":{\"window\":" << ms.size()
+        << ",\"mean\":" << (ms.empty() ? 0.0 : sum/ms.size())
+        << ",\"p50\":" << percentile(0.5) << ",\"p90\":" << percentile(0.9)
+        << ",\"p99\":" << percentile(0.99) << ",\"max\":" << (ms.empty() ? 0.0 : ms.back())
+        << "}}";
+    return os.str();
+}
@@ -0,0 +1,302 @@
+#include "gaden/ServiceTools.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gaden/BatchWriter.hpp"
+#include "gaden/JsonTools.hpp"
+#include "gaden/Logger.hpp"
+#include "gaden/PartTools.hpp"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace gaden;
+
+
+std::string gaden::ServiceTools::errorResponse(const std::string& id, const std::string& error) {
+    PartResult failed;
+    failed.m_error = error;
+    return "{\"id\":" + id + ",\"results\":[" + BatchWriter::resultJson("", failed) + "]}";
+}
+
+
+std::string gaden::ServiceTools::answerRequest(
+    // outputs
+    bool& shutdownOut,
+
+    // inputs
+    FrameChannel& channel,
+    SharedJobSegment& segment,
+    const std::string& header,
+    const AppOptions& opt,
+    ThreadPool& pool,
+    ServiceMetrics& metrics
+) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+    std::string id("null");
+    JsonTools::field(id, header, "id");
+    std::string op("\"solve\"");
+    JsonTools::field(op, header, "op");
+
+    // A points frame follows whenever the header says so, read it before anything can fail,
+    // or the next request would start inside it
+    std::string nPointsField;
+    std::string buffer;
+    bool bufferTooLong = false;
+    const bool hasPoints = JsonTools::field(nPointsField, header, "points");
+    if (hasPoints && !channel.readFrame(buffer, bufferTooLong)) {
+        throw std::runtime_error("Connection closed before the points frame");
+    }
+    if (op == "\"metrics\"") {
+        return "{\"id\":" + id + ",\"status\":\"ok\",\"metrics\":" + metrics.json() + "}";
+    }
+    if (op == "\"shutdown\"") {
+        shutdownOut = true;
+        return "{\"id\":" + id + ",\"status\":\"ok\"}";
+    }
+
+    // Read the file, or take the points that follow as x, y, z little-endian doubles, or those
+    // of a shared memory job in place
+    std::vector<PartResult> results;
+    std::mutex resultsMutex;
+    PartResult failed;
+    Surface3 surface;
+    bool haveSurface = false;
+    std::string file;
+    std::string shmName;
+    GadenShmHeader* job = nullptr;
+    std::uint64_t sequence = 0;
+    const double* xyz = nullptr;
+    std::uint64_t nPoints = 0;
+    try {
+        if (op != "\"solve\"") {
+            failed.m_error = "Unknown op " + op;
+        } else if (JsonTools::field(file, header, "file")) {
+            file = JsonTools::unquote(file);
+            haveSurface = PartTools::readSurface(surface, failed.m_error, opt, file);
+        } else if (hasPoints) {
+            constexpr size_t pointBytes = 3*sizeof(double);
+            if (
+                nPointsField.empty() || nPointsField.size() > 18
+             || nPointsField.find_first_not_of("0123456789") != std::string::npos
+            ) {
+                failed.m_error = "Bad point count " + nPointsField;
+            } else if (bufferTooLong) {
+                failed.m_error = "Points frame longer than "
+                    + std::to_string(FrameChannel::maxFrameBytes) + " bytes";
+            } else if (
+                (nPoints = std::stoull(nPointsField)) > buffer.size()/pointBytes
+             || nPoints*pointBytes != buffer.size()
+            ) {
+                failed.m_error = "Expected a frame of " + nPointsField + " points";
+            } else {
+                xyz = reinterpret_cast<const double*>(buffer.data());
+            }
+        } else if (JsonTools::field(shmName, header, "shm")) {
+            job = segment.map(failed.m_error, nPoints, JsonTools::unquote(shmName));
+            if (job) {
+                sequence = job->sequence;
+                xyz = gadenShmPoints(job);
+            }
+        } else {
+            failed.m_error = "Request needs a file, points or shm";
+        }
+    } catch (const std::exception& e) {
+        failed.m_error = e.what();
+        haveSurface = false;
+        xyz = nullptr;
+    }
+    const Clock::time_point readTime = Clock::now();
+
+    if (haveSurface || xyz) {
+        try {
+            if (xyz) {
+                results.emplace_back();
+                PartTools::solvePoints(results.back(), opt, xyz, nPoints, &pool, startTime);
+            } else if (!surface.partIds().empty()) {
+                PartTools::solveParts(
+                    [&](const PartResult& partResult) {
+                        std::lock_guard<std::mutex> lock(resultsMutex);
+                        results.push_back(partResult);
+                    },
+                    opt, surface, pool
+                );
+            } else {
+                results.emplace_back();
+                PartTools::solveSurface(results.back(), opt, surface, &pool, startTime);
+            }
+        } catch (const std::exception& e) {
+            results.clear();
+            failed.m_error = e.what();
+        }
+    }
+    if (results.empty()) {
+        results.push_back(failed);
+    }
+    if (job) {
+        SharedJobSegment::writeResult(*job, sequence, results.front());
+    }
+    const Clock::time_point endTime = Clock::now();
+
+    const auto ms = [](const Clock::time_point& t0, const Clock::time_point& t1) {
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+    };
+    bool ok = true;
+    std::ostringstream os;
+    os << "{\"id\":" << id << ",\"results\":[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        os << (i ? "," : "") << BatchWriter::resultJson(file, results[i]);
+        ok = ok && results[i].m_ok;
+    }
+    const double totalMs = ms(startTime, endTime);
+    os
+        << "],\"ms\":{\"read\":" << ms(startTime, readTime) << ",\"solve\":"
+        << ms(readTime, endTime) << ",\"total\":" << totalMs << "}}";
+    metrics.add(totalMs, ok);
+    Log_Info("Request " << id << " answered in " << totalMs << " ms");
+    return os.str();
+}
+
+
+bool gaden::ServiceTools::serveConnection(
+    FrameChannel& channel,
+    const AppOptions& opt,
+    ThreadPool& pool,
+    ServiceMetrics& metrics
+) {
+    SharedJobSegment segment;
+    std::string header;
+    for (;;) {
+        bool shutdown = false;
+        std::string response;
+        try {
+            bool headerTooLong = false;
+            if (!channel.readFrame(header, headerTooLong)) {
+                return false;
+            }
+            if (headerTooLong) {
+                response = errorResponse("null", "Request frame longer than "
+                    + std::to_string(FrameChannel::maxFrameBytes) + " bytes");
+            } else {
+                response = answerRequest(
+                    shutdown, channel, segment, header, opt, pool, metrics
+                );
+            }
+        } catch (const std::exception& e) {
+            // Out of memory, or a stream cut short: the stream may be out of step, answer and
+            // drop this connection, the service carries on
+            Log_Error("Connection dropped: " << e.what());
+            channel.writeFrame(errorResponse("null", e.what()));
+            return false;
+        }
+        if (!channel.writeFrame(response) || shutdown) {
+            return shutdown;
+        }
+    }
+}
+
+
+int gaden::ServiceTools::serve(const AppOptions& opt) {
+    ThreadPool pool(opt.threads);
+    ServiceMetrics metrics;
+    if (opt.servePath == "-") {
+        Log_Info("Serving on stdin / stdout, " << pool.size() << " threads");
+        FrameChannel channel(-1);
+        serveConnection(channel, opt, pool, metrics);
+        return 0;
+    }
+#ifdef _WIN32
+    Log_Error("--serve supports only stdin / stdout (-) on this platform");
+    return -1;
+#else
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (opt.servePath.size() >= sizeof(addr.sun_path)) {
+        Log_Error("Socket path too long '" << opt.servePath << "'");
+        return -1;
+    }
+    std::strcpy(addr.sun_path, opt.servePath.c_str());
+    const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(opt.servePath.c_str());
+    if (
+        listenFd < 0
+     || ::bind(listenFd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+     || ::listen(listenFd, 16) != 0
+    ) {
+        Log_Error("Cannot listen on '" << opt.servePath << "': " << std::strerror(errno));
+        if (listenFd >= 0) {
+            ::close(listenFd);
+        }
+        return -1;
+    }
+    // A client that hangs up early must not end the service
+    std::signal(SIGPIPE, SIG_IGN);
+    Log_Info("Serving on " << opt.servePath << ", " << pool.size() << " threads");
+
+    std::atomic<bool> stopping(false);
+    std::mutex connectionsMutex;
+    std::condition_variable connectionsDone;
+    std::set<int> connections;
+    for (;;) {
+        const int fd = ::accept(listenFd, nullptr, nullptr);
+        if (stopping.load()) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            break;
+        }
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            Log_Error("accept failed: " << std::strerror(errno));
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connections.insert(fd);
+        }
+        std::thread([&, fd]() {
+            FrameChannel channel(fd);
+            if (serveConnection(channel, opt, pool, metrics) && !stopping.exchange(true)) {
+                // Wake the accept, and the other connections waiting for requests
+                ::shutdown(listenFd, SHUT_RDWR);
+                std::lock_guard<std::mutex> lock(connectionsMutex);
+                for (const int other : connections) {
+                    if (other != fd) {
+                        ::shutdown(other, SHUT_RDWR);
+                    }
+                }
+            }
+            ::close(fd);
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connections.erase(fd);
+            connectionsDone.notify_all();
+        }).detach();
+    }
+    {
+        std::unique_lock<std::mutex> lock(connectionsMutex);
+        connectionsDone.wait(lock, [&connections]() { return connections.empty(); });
+    }
+    ::close(listenFd);
+    ::unlink(opt.servePath.c_str());
+    Log_Info("Service stopped, " << metrics.json());
+    return 0;
+#endif
+}
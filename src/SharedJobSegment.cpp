@@ -0,0 +1,139 @@
+#include "gaden/SharedJobSegment.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static_assert(
+    sizeof(GadenShmHeader) <= GADEN_SHM_POINTS_OFFSET, "Job header overlaps its points"
+);
+
+
+void gaden::SharedJobSegment::unmap() {
+#ifndef _WIN32
+    if (m_data) {
+        ::munmap(m_data, m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_name.clear();
+    m_fd = -1;
+    m_data = nullptr;
+    m_size = 0;
+    m_device = 0;
+    m_inode = 0;
+}
+
+
+GadenShmHeader* gaden::SharedJobSegment::map(
+    // outputs
+    std::string& errorOut,
+    std::uint64_t& nPointsOut,
+
+    // inputs
+    const std::string& name
+) {
+#ifdef _WIN32
+    (void)nPointsOut;
+    errorOut = "Shared memory jobs are not supported on this platform, '" + name + "'";
+    return nullptr;
+#else
+    // Opened and checked on every job, so a segment the client has grown, or removed and created
+    // again under the same name, is mapped afresh
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        errorOut = "Cannot open shared memory '" + name + "': " + std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return nullptr;
+    }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (
+        m_data && name == m_name && size == m_size
+     && static_cast<std::uint64_t>(st.st_dev) == m_device
+     && static_cast<std::uint64_t>(st.st_ino) == m_inode
+    ) {
+        // Same segment, keep the mapping
+        ::close(fd);
+    } else {
+        unmap();
+        void* data = MAP_FAILED;
+        if (size >= GADEN_SHM_POINTS_OFFSET) {
+            data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            errorOut = "Cannot map shared memory '" + name + "' of " + std::to_string(size)
+                + " bytes";
+            return nullptr;
+        }
+        m_name = name;
+        m_fd = fd;
+        m_data = data;
+        m_size = size;
+        m_device = static_cast<std::uint64_t>(st.st_dev);
+        m_inode = static_cast<std::uint64_t>(st.st_ino);
+    }
+    GadenShmHeader* job = static_cast<GadenShmHeader*>(m_data);
+    nPointsOut = job->nPoints;
+    if (job->magic != GADEN_SHM_MAGIC || job->version != GADEN_SHM_VERSION) {
+        errorOut = "Shared memory '" + name + "' is not a version "
+            + std::to_string(GADEN_SHM_VERSION) + " job";
+        return nullptr;
+    }
+    if (
+        job->capacity > (std::numeric_limits<std::size_t>::max() - GADEN_SHM_POINTS_OFFSET)
+            /(3*sizeof(double))
+     || gadenShmSize(job->capacity) > m_size || nPointsOut > job->capacity
+    ) {
+        errorOut = "Shared memory job '" + name + "' has more points than it has room for";
+        return nullptr;
+    }
+    if (nPointsOut > static_cast<std::uint64_t>(std::numeric_limits<index_t>::max())) {
+        errorOut = "Shared memory job '" + name + "' needs 64-bit indices (-DIndex64=ON)";
+        return nullptr;
+    }
+    return job;
+#endif
+}
+
+
+void gaden::SharedJobSegment::writeResult(
+    GadenShmHeader& job,
+    std::uint64_t sequence,
+    const PartResult& result
+) {
+    GadenShmResult& slot = job.result;
+    const auto put = [](double* out, const Vector3& v) {
+        out[0] = v.x();
+        out[1] = v.y();
+        out[2] = v.z();
+    };
+    const Vector3 minPt(result.m_bb.minPt());
+    const Vector3 maxPt(result.m_bb.maxPt());
+    const Vector3 span(maxPt - minPt);
+    slot.status = result.m_ok ? GADEN_SHM_SOLVED : GADEN_SHM_FAILED;
+    slot.reserved = 0;
+    slot.nHullPoints = static_cast<std::uint64_t>(result.m_nHullPoints);
+    put(slot.minPt, minPt);
+    put(slot.maxPt, maxPt);
+    slot.volume = result.m_ok ? span.x()*span.y()*span.z() : 0.0;
+    put(slot.axes[0], result.m_axes.x());
+    put(slot.axes[1], result.m_axes.y());
+    put(slot.axes[2], result.m_axes.z());
+    put(slot.rotations, result.m_rotations);
+    slot.ms = result.m_ms;
+    slot.sequence = sequence;
+}
@@ -1,80 +1,262 @@
 #include "gaden/Surface3.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <unordered_map>
+
 #include "gaden/AutoMergingPointCloud.hpp"
 #include "gaden/BoundBox.hpp"
 #include "gaden/Logger.hpp"
 
+namespace {
+
+// Fields in a CSV row, ignoring trailing whitespace and one trailing comma some exporters add
+int csvFieldCount(const std::string& line) {
+    size_t end = line.find_last_not_of(" \t\r");
+    if (end == std::string::npos) {
+        return 0;
+    }
+    if (line[end] == ',') {
+        --end;
+    }
+    return static_cast<int>(std::count(line.begin(), line.begin() + end + 1, ',')) + 1;
+}
+
+// True if a header row's first field is "Part" (any case, optionally quoted)
+bool isPartHeader(const std::string& line) {
+    std::string field(line.substr(0, line.find(',')));
+    field.erase(0, std::min(field.size(), field.find_first_not_of(" \t\"")));
+    field.erase(field.find_last_not_of(" \t\r\"") + 1);
+    std::transform(field.begin(), field.end(), field.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return field == "part";
+}
 
-bool gaden::Surface3::read(std::istream& is, double epsilon) {
+} // end anonymous namespace
+
+
+bool gaden::Surface3::read(std::istream& is, double epsilon, bool singlePrecision) {
     if (!is.good()) {
         Log_Error("Cannot read from bad stream");
         return false;
     }
+
+    // Rows of one part, merged only within the part.  Without a part column, everything is part
+    // 0 and its rows become the members directly.  Points are kept in one precision only.
+    struct PartRows {
+        index_t id;
+        std::vector<index_t> faceNumbers;
+        std::vector<Vector3> points;
+        std::vector<Vector3f> singlePoints;
+        std::vector<Vector3> normals;
+        std::unique_ptr<AutoMergingPointCloud> merger;
+        std::unique_ptr<AutoMergingPointCloudf> singleMerger;
+    };
+    std::vector<PartRows> parts;
+    std::unordered_map<index_t, size_t> partSlots;
+    size_t slot = 0;
+
     std::string buffer;
     char comma;
-    BoundBox bb;
-    int nMerged = 0;
+    index_t nMerged = 0;
     int nLines = 0;
     int nValidLines = 0;
-    if (epsilon <= 0.0) {
-        while (std::getline(is, buffer)) {
-            Log_Debug4("Line=[" << buffer << "]");
-            ++nLines;
-            std::istringstream lineIss(buffer);
-            char c = lineIss.peek();
-            if (!Tools::isNumber(c)) {
-                Log_Debug("First character is not a number, c=" << int(c));
-                continue;
+    int nRejected = 0;
+    int hasPartColumn = -1;
+    while (std::getline(is, buffer)) {
+        Log_Debug4("Line=[" << buffer << "]");
+        ++nLines;
+        std::istringstream lineIss(buffer);
+        char c = lineIss.peek();
+        if (!Tools::isNumber(c)) {
+            Log_Debug("First character is not a number, c=" << int(c));
+            if (hasPartColumn < 0 && csvFieldCount(buffer) > 1) {
+                // The header names the columns, a leading "Part" column holds part ids
+                hasPartColumn = isPartHeader(buffer) ? 1 : 0;
             }
-            ++nValidLines;
-            m_faceNumber.readElem(lineIss);
-            lineIss >> comma;
-            m_points.readElem(lineIss);
-            bb.append(m_points.back());
-            lineIss >> comma;
-            m_normals.readElem(lineIss);
+            continue;
         }
-    } else {
-        AutoMergingPointCloud amp(0, epsilon, name());
-        while (std::getline(is, buffer)) {
-            Log_Debug4("Line=[" << buffer << "]");
-            ++nLines;
-            std::istringstream lineIss(buffer);
-            char c = lineIss.peek();
-            if (!Tools::isNumber(c)) {
-                Log_Debug("First character is not a number, c=" << int(c));
-                continue;
+        const int nFields = csvFieldCount(buffer);
+        if (hasPartColumn < 0) {
+            // No header, a part id makes 8 fields instead of 7
+            hasPartColumn = nFields == 8 ? 1 : 0;
+        }
+        index_t partId = 0;
+        index_t fn = 0;
+        Vector3 pt;
+        Vector3 nm;
+        if (nFields == (hasPartColumn ? 8 : 7)) {
+            if (hasPartColumn) {
+                lineIss >> partId;
+                lineIss >> comma;
             }
-            ++nValidLines;
-            int fn;
-            Vector3 pt;
-            Vector3 nm;
             lineIss >> fn;
             lineIss >> comma;
-            lineIss >> pt;
+            pt.fromCsv(lineIss);
             lineIss >> comma;
-            lineIss >> nm;
-
-            std::pair<bool, int> newPtAndId = amp.append(pt);
-            if (!newPtAndId.first) {
+            nm.fromCsv(lineIss);
+        } else {
+            lineIss.setstate(std::ios::failbit);
+        }
+        if (lineIss.fail()) {
+            Log_Warn(""
+                << "Rejected line " << nLines << ", expected " << (hasPartColumn ? 8 : 7)
+                << " numeric fields: [" << buffer << "]"
+            );
+            ++nRejected;
+            continue;
+        }
+        ++nValidLines;
+        if (parts.empty() || parts[slot].id != partId) {
+            // Rows of a part usually come together, only look up the slot when the part changes
+            const auto found = partSlots.emplace(partId, parts.size());
+            if (found.second) {
+                parts.push_back({partId, {}, {}, {}, {}, nullptr, nullptr});
+                if (epsilon > 0.0 && singlePrecision) {
+                    parts.back().singleMerger =
+                        std::make_unique<AutoMergingPointCloudf>(0, epsilon, name());
+                } else if (epsilon > 0.0) {
+                    parts.back().merger =
+                        std::make_unique<AutoMergingPointCloud>(0, epsilon, name());
+                }
+            }
+            slot = found.first->second;
+        }
+        PartRows& rows = parts[slot];
+        if (rows.merger) {
+            if (!rows.merger->append(pt).first) {
                 // Point merged, skip
                 ++nMerged;
                 continue;
             }
-            // faceNumber - fn?  or newPtAndId.second?
-            m_faceNumber.push_back(fn);
-            // m_points.push_back(pt);
-            m_normals.push_back(nm);
-            bb.append(pt);
+        } else if (rows.singleMerger) {
+            if (!rows.singleMerger->append(Vector3f(pt)).first) {
+                ++nMerged;
+                continue;
+            }
+        } else if (singlePrecision) {
+            rows.singlePoints.push_back(Vector3f(pt));
+        } else {
+            rows.points.push_back(pt);
         }
-        m_points = std::move(amp).transfer();
+        rows.faceNumbers.push_back(fn);
+        rows.normals.push_back(nm);
+    }
+    for (PartRows& rows : parts) {
+        if (rows.merger) {
+            rows.points = std::move(*rows.merger).transfer().vec();
+            rows.merger.reset();
+        }
+        if (rows.singleMerger) {
+            rows.singlePoints = std::move(*rows.singleMerger).transfer().vec();
+            rows.singleMerger.reset();
+        }
+    }
+
+    clear();
+    m_singlePrecision = singlePrecision;
+    if (hasPartColumn == 1) {
+        // Concatenate, in order of first appearance
+        size_t nPts = 0;
+        for (const PartRows& rows : parts) {
+            nPts += rows.faceNumbers.size();
+        }
+        m_faceNumber.reserve(nPts);
+        if (singlePrecision) {
+            m_singlePoints.reserve(nPts);
+        } else {
+            m_points.reserve(nPts);
+        }
+        m_normals.reserve(nPts);
+        m_partOffsets.push_back(0);
+        for (const PartRows& rows : parts) {
+            m_faceNumber.vec().insert(
+                m_faceNumber.vec().end(), rows.faceNumbers.begin(), rows.faceNumbers.end()
+            );
+            m_points.vec().insert(m_points.vec().end(), rows.points.begin(), rows.points.end());
+            m_singlePoints.vec().insert(
+                m_singlePoints.vec().end(), rows.singlePoints.begin(), rows.singlePoints.end()
+            );
+            m_normals.vec().insert(m_normals.vec().end(), rows.normals.begin(), rows.normals.end());
+            m_partIds.push_back(rows.id);
+            m_partOffsets.push_back(static_cast<index_t>(m_faceNumber.size()));
+        }
+    } else if (!parts.empty()) {
+        m_faceNumber.vec().swap(parts[0].faceNumbers);
+        m_points.vec().swap(parts[0].points);
+        m_singlePoints.vec().swap(parts[0].singlePoints);
+        m_normals.vec().swap(parts[0].normals);
     }
     Log_Info(""
         << "Read results:\n"
         << "\tLines         : " << nLines << "\n"
         << "\tValid points  : " << nValidLines << "\n"
+        << "\tRejected rows : " << nRejected << "\n"
         << "\tMerged points : " << nMerged << "\n"
-        << "\tUnique points : " << m_points.size()
+        << "\tUnique points : " << m_faceNumber.size() << "\n"
+        << "\tParts         : " << nParts()
     );
     return true;
 }
+
+
+gaden::Surface3 gaden::Surface3::extractPart(index_t i) const {
+    Surface3 part(name());
+    if (m_partIds.empty()) {
+        part.m_faceNumber = m_faceNumber;
+        part.m_points = m_points;
+        part.m_singlePoints = m_singlePoints;
+        part.m_singlePrecision = m_singlePrecision;
+        part.m_normals = m_normals;
+        part.m_latticePoints = m_latticePoints;
+        part.m_lattice = m_lattice;
+        return part;
+    }
+    const index_t begin = m_partOffsets[i];
+    const index_t end = m_partOffsets[i + 1];
+    part.m_faceNumber.vec().assign(m_faceNumber.begin() + begin, m_faceNumber.begin() + end);
+    if (m_singlePrecision) {
+        part.m_singlePoints.vec().assign(
+            m_singlePoints.begin() + begin, m_singlePoints.begin() + end
+        );
+    } else {
+        part.m_points.vec().assign(m_points.begin() + begin, m_points.begin() + end);
+    }
+    part.m_singlePrecision = m_singlePrecision;
+    part.m_normals.vec().assign(m_normals.begin() + begin, m_normals.begin() + end);
+    return part;
+}
+
+
+gaden::index_t gaden::Surface3::quantize(double spacing) {
+    if (m_points.empty()) {
+        return 0;
+    }
+    m_lattice = Lattice::fit(BoundBox::calculateAxisAlignedBoundBox(m_points), spacing);
+    IndexField map;
+    PointCloudTools::mergeLatticeSubset(m_lattice.quantize(m_points), map, m_latticePoints);
+
+    // Keep the face number and normal of the first point at each lattice point
+    const index_t nPts = static_cast<index_t>(m_points.size());
+    index_t nKept = 0;
+    for (index_t i = 0; i < nPts; ++i) {
+        if (map[i] == nKept) {
+            m_faceNumber[nKept] = m_faceNumber[i];
+            m_normals[nKept] = m_normals[i];
+            ++nKept;
+        }
+    }
+    m_faceNumber.resize(nKept);
+    m_normals.resize(nKept);
+
+    // Release the real coordinates
+    Vector3Field().swap(m_points);
+    const index_t nMerged = nPts - nKept;
+    Log_Info(""
+        << "Quantized points onto a lattice with spacing " << m_lattice.spacing() << ", merged "
+        << nMerged << " points, " << nKept << " remain"
+    );
+    return nMerged;
+}
@@ -0,0 +1,142 @@
+#include "gaden/ThreadPool.hpp"
+
+#include <algorithm>
+
+
+namespace { // anonymous namespace for local-only functionality
+
+    // Pool and queue of the calling thread, if it is a worker
+    thread_local const gaden::ThreadPool* t_pool = nullptr;
+    thread_local int t_queue = -1;
+
+} // end anonymous namespace
+
+
+gaden::ThreadPool::ThreadPool(int nThreads) :
+    m_nQueued(0),
+    m_nPending(0),
+    m_nextQueue(0),
+    m_nWaiting(0),
+    m_stop(false)
+{
+    if (nThreads <= 0) {
+        nThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < nThreads; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < nThreads; ++i) {
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+
+gaden::ThreadPool::~ThreadPool() {
+    waitIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+
+void gaden::ThreadPool::submit(std::function<void()> task) {
+    const int nQueues = static_cast<int>(m_queues.size());
+    const int q = (t_pool == this) ? t_queue : static_cast<int>(m_nextQueue++ % nQueues);
+    m_nPending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[q]->m_mutex);
+        m_queues[q]->m_tasks.push_back(std::move(task));
+    }
+    bool waiting;
+    {
+        // Under the sleep mutex, so a worker or waiter cannot miss it between checking and
+        // sleeping
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_nQueued.fetch_add(1);
+        waiting = m_nWaiting > 0;
+    }
+    m_wake.notify_one();
+    if (waiting) {
+        m_done.notify_all();
+    }
+}
+
+
+bool gaden::ThreadPool::take(std::function<void()>& taskOut) {
+    const int nQueues = static_cast<int>(m_queues.size());
+    const int own = (t_pool == this) ? t_queue : -1;
+    if (own >= 0) {
+        Queue& queue = *m_queues[own];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if (!queue.m_tasks.empty()) {
+            taskOut = std::move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+            m_nQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    const int start = own >= 0 ? own + 1 : 0;
+    for (int k = 0; k < nQueues; ++k) {
+        Queue& queue = *m_queues[(start + k) % nQueues];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if (!queue.m_tasks.empty()) {
+            taskOut = std::move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+            m_nQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool gaden::ThreadPool::runOne() {
+    std::function<void()> task;
+    if (!take(task)) {
+        return false;
+    }
+    task();
+    if (m_nPending.fetch_sub(1) == 1) {
+        notifyDone();
+    }
+    return true;
+}
+
+
+void gaden::ThreadPool::notifyDone() {
+    bool waiting;
+    {
+        // Taking the mutex orders this after any waiter's test of its condition
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        waiting = m_nWaiting > 0;
+    }
+    if (waiting) {
+        m_done.notify_all();
+    }
+}
+
+
+void gaden::ThreadPool::waitIdle() {
+    waitUntil([this]() { return m_nPending.load() == 0; });
+}
+
+
+void gaden::ThreadPool::work(int i) {
+    t_pool = this;
+    t_queue = i;
+    for (;;) {
+        if (runOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_stop || m_nQueued.load() > 0; });
+        if (m_stop && m_nQueued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -1,11 +1,24 @@
 #include "gaden/VectorNField.hpp"
 
+// Both precisions are compiled in full here, so any member that does not work for one of them
+// fails the build rather than its first user
+template class gaden::Vector2T<double>;
+template class gaden::Vector2T<float>;
+template class gaden::Vector3T<double>;
+template class gaden::Vector3T<float>;
+template class gaden::IndexedVector2T<double>;
+template class gaden::IndexedVector2T<float>;
+template class gaden::IndexedVector3T<double>;
+template class gaden::IndexedVector3T<float>;
+template class gaden::VectorNField<gaden::Vector3>;
+template class gaden::VectorNField<gaden::Vector3f>;
+
 gaden::IndexedVector2Field gaden::convertToIndexed(
-    const Vector2Field& fldIn, int start, int step
+    const Vector2Field& fldIn, index_t start, index_t step
 ) {
     IndexedVector2Field fldOut(fldIn.name());
     fldOut.reserve(fldIn.size());
-    int idx = start;
+    index_t idx = start;
     for (const Vector2& elemIn : fldIn) {
         fldOut.emplace_back(elemIn, idx);
         idx += step;
@@ -15,11 +28,11 @@ gaden::IndexedVector2Field gaden::convertToIndexed(
 
 
 gaden::IndexedVector3Field gaden::convertToIndexed(
-    const Vector3Field& fldIn, int start, int step
+    const Vector3Field& fldIn, index_t start, index_t step
 ) {
     IndexedVector3Field fldOut(fldIn.name());
     fldOut.reserve(fldIn.size());
-    int idx = start;
+    index_t idx = start;
     for (const Vector3& elemIn : fldIn) {
         fldOut.emplace_back(elemIn, idx);
         idx += step;
@@ -28,6 +41,20 @@ gaden::IndexedVector3Field gaden::convertToIndexed(
 }
 
 
+gaden::IndexedVector3fField gaden::convertToIndexed(
+    const Vector3fField& fldIn, index_t start, index_t step
+) {
+    IndexedVector3fField fldOut(fldIn.name());
+    fldOut.reserve(fldIn.size());
+    index_t idx = start;
+    for (const Vector3f& elemIn : fldIn) {
+        fldOut.emplace_back(elemIn, idx);
+        idx += step;
+    }
+    return fldOut;
+}
+
+
 gaden::Vector2Field gaden::stripIndexing(const IndexedVector2Field& fldIn) {
     Vector2Field fldOut(fldIn.name());
     fldOut.reserve(fldIn.size());
@@ -46,3 +73,13 @@ gaden::Vector3Field gaden::stripIndexing(const IndexedVector3Field& fldIn) {
     }
     return fldOut;
 }
+
+
+gaden::Vector3fField gaden::stripIndexing(const IndexedVector3fField& fldIn) {
+    Vector3fField fldOut(fldIn.name());
+    fldOut.reserve(fldIn.size());
+    for (const IndexedVector3f& elemIn : fldIn) {
+        fldOut.push_back(Vector3f(elemIn.x(), elemIn.y(), elemIn.z()));
+    }
+    return fldOut;
+}
@@ -1,63 +1,39 @@
+#include <atomic>
+#include <csignal>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "gaden/AppOptions.hpp"
+#include "gaden/BatchTools.hpp"
+#include "gaden/BatchWriter.hpp"
 #include "gaden/BoundBox.hpp"
 #include "gaden/ConvexHullTools.hpp"
 #include "gaden/Logger.hpp"
 #include "gaden/LoggerConfigurator.hpp"
+#include "gaden/PartTools.hpp"
+#include "gaden/ServiceTools.hpp"
 #include "gaden/Surface3.hpp"
+#include "gaden/ThreadPool.hpp"
 #include "gaden/version.hpp"
 
 using namespace gaden;
 
 namespace { // anonymous namespace for local-only functionality
-    struct AppOptions {
-        double epsilon = 1.0e-9;
-        bool hasEpsilon = false;
-
-        int steps = 7;
-        bool hasSteps = false;
-
-        int passes = 1;
-        bool hasPasses = false;
-
-        // present => true
-        bool mergePoints = false;
-
-        std::string filePath;
-
-        friend std::ostream& operator<<(std::ostream& os, const AppOptions& ao) {
-            if (ao.hasEpsilon) {
-                os << "Found 'epsilon': " << ao.epsilon << "\n";
-            } else {
-                os << "No 'epsilon' option found, using default: " << ao.epsilon << "\n";
-            }
-            if (ao.hasSteps) {
-                os << "Found 'steps': " << ao.steps << "\n";
-            } else {
-                os << "No 'steps' option found, using default: " << ao.steps << "\n";
-            }
-            if (ao.hasPasses) {
-                os << "Found 'passes': " << ao.passes << "\n";
-            } else {
-                os << "No 'passes' option found, using default: " << ao.passes << "\n";
-            }
-            if (ao.mergePoints) {
-                os << "Found 'mergePoints': true\n";
-            }
-            os << "File path = " << ao.filePath << "\n";
-            return os;
-        }
-
-    };
-
     static bool parse_app_options(const std::vector<std::string>& rest, AppOptions& out)
     {
         // Simple positional/flag parse:
         // Accept: --epsilon/-e <val>, --steps/-s <val>, --passes/-p <val>, --merge-points/-m
+        //         --beam/-b <val>, --coherent, --float32 <val>, --quantize, --kernel <val>
+        //         --single-points
+        //         --ladder <val>, --ladder-change <val>, --time-budget-ms <val>
+        //         --auto <val>, --axis <x|y|z|x,y,z>, --cone <val>
+        //         --batch <manifest|dir>, --batch-output <file>, --threads <val>
+        //         --pipeline <val>, --serve <socket|->
+        //         --solver <grid|bnb|seeded|normals>, --gap <val>, --max-evals <val>, --seed
         // Last bare token is treated as filePath.
         for (size_t i = 0; i < rest.size(); ++i) {
             const std::string& a = rest[i];
@@ -88,19 +64,217 @@ namespace { // anonymous namespace for local-only functionality
                 if (out.passes < 1) {
                     out.passes = 1;
                 }
+            } else if (a == "--beam" || a == "-b") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.beam = std::stoi(rest[++i]);
+                out.hasBeam = true;
+                if (out.beam < 1) {
+                    out.beam = 1;
+                }
+            } else if (a == "--float32") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.float32 = std::stoi(rest[++i]);
+                out.hasFloat32 = true;
+                if (out.float32 < 0) {
+                    out.float32 = 0;
+                }
+            } else if (a == "--kernel") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.kernel = std::stod(rest[++i]);
+                out.hasKernel = true;
+                if (out.kernel < 0.0) {
+                    out.kernel = 0.0;
+                }
+            } else if (a == "--ladder") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.ladderTolerance = std::stod(rest[++i]);
+                out.ladder = true;
+            } else if (a == "--ladder-change") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.ladderChange = std::stod(rest[++i]);
+                out.hasLadderChange = true;
+                if (out.ladderChange < 0.0) {
+                    out.ladderChange = 0.0;
+                }
+            } else if (a == "--auto") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.autoAccuracy = std::stod(rest[++i]);
+                if (out.autoAccuracy < 0.0) {
+                    out.autoAccuracy = 0.0;
+                }
+            } else if (a == "--axis") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                const std::string& val = rest[++i];
+                if (val == "x" || val == "X") {
+                    out.axis = Vector3(1.0, 0.0, 0.0);
+                } else if (val == "y" || val == "Y") {
+                    out.axis = Vector3(0.0, 1.0, 0.0);
+                } else if (val == "z" || val == "Z") {
+                    out.axis = Vector3(0.0, 0.0, 1.0);
+                } else {
+                    double x = 0.0;
+                    double y = 0.0;
+                    double z = 0.0;
+                    if (std::sscanf(val.c_str(), "%lf,%lf,%lf", &x, &y, &z) != 3) {
+                        std::cerr << "Expected x, y, z or x,y,z after " << a << "\n";
+                        return false;
+                    }
+                    out.axis = Vector3(x, y, z);
+                }
+                if (!out.axis.normalise()) {
+                    std::cerr << "Zero length " << a << "\n";
+                    return false;
+                }
+                out.hasAxis = true;
+            } else if (a == "--cone") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.coneDegrees = std::stod(rest[++i]);
+                if (out.coneDegrees < 0.0) {
+                    out.coneDegrees = 0.0;
+                }
+            } else if (a == "--time-budget-ms") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.timeBudgetMs = std::stoi(rest[++i]);
+                if (out.timeBudgetMs < 0) {
+                    out.timeBudgetMs = 0;
+                }
+            } else if (a == "--batch") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.batchPath = rest[++i];
+            } else if (a == "--batch-output") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.batchOutput = rest[++i];
+            } else if (a == "--threads") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.threads = std::stoi(rest[++i]);
+                out.hasThreads = true;
+                if (out.threads < 0) {
+                    out.threads = 0;
+                }
+            } else if (a == "--pipeline") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.pipelineDepth = std::stoi(rest[++i]);
+                if (out.pipelineDepth < 0) {
+                    out.pipelineDepth = 0;
+                }
+            } else if (a == "--serve") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.servePath = rest[++i];
             } else if (a == "--merge-points" || a == "-m") {
                 out.mergePoints = true;
+            } else if (a == "--coherent") {
+                out.coherent = true;
+            } else if (a == "--quantize") {
+                out.quantize = true;
+            } else if (a == "--single-points") {
+                out.singlePoints = true;
+            } else if (a == "--seed") {
+                out.seed = true;
+            } else if (a == "--solver") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.solver = rest[++i];
+                out.hasSolver = true;
+                if (
+                    out.solver != "grid" && out.solver != "bnb" && out.solver != "seeded"
+                 && out.solver != "normals"
+                ) {
+                    std::cerr << "Unknown solver '" << out.solver << "'\n";
+                    return false;
+                }
+            } else if (a == "--gap") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.gap = std::stod(rest[++i]);
+                out.hasGap = true;
+                if (out.gap < 0.0) {
+                    out.gap = 0.0;
+                }
+            } else if (a == "--max-evals") {
+                if (i + 1 >= rest.size()) {
+                    std::cerr << "Missing value after " << a << "\n";
+                    return false;
+                }
+                out.maxEvals = std::stoi(rest[++i]);
+                out.hasMaxEvals = true;
+                if (out.maxEvals < 1) {
+                    out.maxEvals = 1;
+                }
             } else {
                 // treat as positional; keep last one as filePath
                 out.filePath = a;
             }
         }
-        if (out.filePath.empty()) {
+        if (out.pipelineDepth > 0 && out.batchPath.empty()) {
+            std::cerr << "--pipeline needs --batch\n";
+            return false;
+        }
+        if (out.coneDegrees > 0.0 && !out.hasAxis) {
+            std::cerr << "--cone needs --axis\n";
+            return false;
+        }
+        if (!out.servePath.empty() && !out.batchPath.empty()) {
+            std::cerr << "--serve and --batch are exclusive\n";
+            return false;
+        }
+        if (out.filePath.empty() && out.batchPath.empty() && out.servePath.empty()) {
             std::cerr << "Missing filePath argument.\n";
             return false;
         }
         return true;
     }
+
+
+    // Stop a time-budgeted search on SIGINT, with the best box so far
+    void onInterrupt(int) {
+        PartTools::interrupted.store(true);
+    }
 }
 
 
@@ -124,84 +298,87 @@ int main(int argc, char** argv)
             << "[--epsilon <double>] "
             << "[--steps <int>] "
             << "[--passes <int>] "
-            << "[--merge-points] filePath\n";
+            << "[--beam <int>] "
+            << "[--coherent] "
+            << "[--float32 <int>] "
+            << "[--quantize] "
+            << "[--single-points] "
+            << "[--kernel <double>] "
+            << "[--ladder <double>] "
+            << "[--ladder-change <double>] "
+            << "[--solver <grid|bnb|seeded|normals>] "
+            << "[--seed] "
+            << "[--gap <double>] "
+            << "[--max-evals <int>] "
+            << "[--time-budget-ms <int>] "
+            << "[--auto <double>] "
+            << "[--axis <x|y|z|x,y,z>] "
+            << "[--cone <double>] "
+            << "[--threads <int>] "
+            << "[--merge-points] filePath\n"
+            << "  sandbox.exe [logger options] [options] --batch <manifest|dir> "
+            << "[--batch-output <file.csv|file.jsonl>] [--threads <int>] [--pipeline <int>]\n"
+            << "  sandbox.exe [logger options] [options] --serve <socket|-> [--threads <int>]\n";
         return 1;
     }
 
     Log_Info("Command line options\n--------------------\n" << opt << "\n");
 
-    Log_Info("Reading " << opt.filePath);
-    std::ifstream iss(opt.filePath);
-    if (!iss.is_open()) {
-        Log_Error("Failed to open file '" << opt.filePath << "'");
-        return -1;
+    if (opt.hasAxis && opt.ladder) {
+        Log_Warn("--axis solves the points directly, ignoring --ladder");
+        opt.ladder = false;
     }
-
-    double readEpsilon = 0;
-    if (opt.mergePoints) {
-        readEpsilon = opt.epsilon;
+    if (opt.ladder && opt.quantize) {
+        Log_Warn("--ladder merges with a tolerance, ignoring --quantize");
+        opt.quantize = false;
     }
-
-    // Read in from csv, throw away all unnecessary data, keep only pruned points.
-    Vector3Field pts;
-    {
-        Surface3 surface(iss, readEpsilon);
-        pts.swap(surface.points());
+    if (opt.timeBudgetMs > 0) {
+        // Ctrl+C stops the anytime search early, with the best box so far
+        std::signal(SIGINT, onInterrupt);
     }
-    double chEpsilon = opt.epsilon;
-
-    // Create 3d convex hull to prune internal points
-    Vector3Field chPts;
-    IntField chVerts_unused;
-    std::vector<Face> chFaces_unused;
-
-    int nPts = static_cast<int>(pts.size());
-    Log_Info(""
-        << "Calculating 3D convex hull from " << nPts << " unique points (after merging)...\n"
-        << "This identifies critical points, allowing the application to reduce the size of the \n"
-        << "problem, improving CPU."
-    );
-
-    int nDims = ConvexHullTools::calculateConvexHull3d(
-        // Inputs
-        pts,
-        chEpsilon,
-
-        // Outputs
-        chPts,
-        chVerts_unused,
-        chFaces_unused
-    );
-
-    const int nChPts = static_cast<int>(chPts.size());
-    Log_Info(""
-        << "Found a convex hull enclosing a " << ConvexHullTools::nDimsToWord(nDims)
-        << ", formed by " << nChPts << " critical points, a further reduction of "
-        << (nPts - nChPts) << " points"
-    );
-
-    // Peak memory here
-    // Throw away unnecessary data
-    pts.clear();
-    chVerts_unused.clear();
-    chFaces_unused.clear();
 
-    Axes resultAxes;
-    Vector3 resultRotations;
-    BoundBox minBb = BoundBox::solveMinimumRotatedBoundBox(
-        // outputs
-        resultAxes, resultRotations,
-
-        // inputs
-        chPts, opt.steps, opt.passes, opt.epsilon
-    );
+    if (!opt.servePath.empty()) {
+        return ServiceTools::serve(opt);
+    }
+    if (!opt.batchPath.empty()) {
+        const int nFailed = BatchTools::solveBatch(opt);
+        return nFailed < 0 ? -1 : (nFailed > 0 ? 2 : 0);
+    }
 
-    Log_Info(""
-        << "Done calculations.  Results:\n"
-        << "BoundBox : " << minBb << "\n"
-        << "Axes     : " << resultAxes << "\n"
-        << "Rotations: " << resultRotations
-    );
+    std::unique_ptr<ThreadPool> pool;
+    if (opt.hasThreads) {
+        pool = std::make_unique<ThreadPool>(opt.threads);
+    }
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    Surface3 surface;
+    std::string error;
+    if (!PartTools::readSurface(surface, error, opt, opt.filePath)) {
+        Log_Error(error);
+        return -1;
+    }
+    if (!surface.partIds().empty()) {
+        // Multi-part file, one result line per part, as in batch mode
+        std::ofstream file;
+        std::ostream* os = BatchWriter::openOutput(file, opt);
+        if (!os) {
+            return -1;
+        }
+        BatchWriter writer(*os, BatchWriter::outputIsJson(opt));
+        if (!pool) {
+            pool = std::make_unique<ThreadPool>(opt.threads);
+        }
+        const int nFailed = PartTools::solveParts(
+            [&](const PartResult& partResult) { writer.write(opt.filePath, partResult); },
+            opt, surface, *pool
+        );
+        return nFailed > 0 ? 2 : 0;
+    }
+    PartResult result;
+    PartTools::solveSurface(result, opt, surface, pool.get(), startTime);
+    if (!result.m_ok) {
+        Log_Error(result.m_error);
+        return -1;
+    }
 
     std::cout << "\nDone.\n";
     return 0;
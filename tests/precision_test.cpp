@@ -0,0 +1,193 @@
+// Single vs double precision agreement test
+//  Usage: sandbox_precision_test <part.csv>
+//  Merges and hulls the same clouds stored in double and in single precision, and checks the
+//  merged counts, hull counts and hull points agree to single precision.  The part file is read
+//  both ways through Surface3 and PartTools, as --single-points does.  Exit code 0 on success.
+//  Build with -DSANDBOX_BUILD_TESTS=ON, run by ctest.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gaden/AppOptions.hpp"
+#include "gaden/ConvexHullTools.hpp"
+#include "gaden/PartTools.hpp"
+#include "gaden/PointCloudTools.hpp"
+#include "gaden/Surface3.hpp"
+
+using namespace gaden;
+
+namespace { // anonymous namespace for local-only functionality
+
+    int g_nFailed = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (!ok) {
+            std::printf("FAILED: %s\n", what.c_str());
+            ++g_nFailed;
+        }
+    }
+
+    // Largest coordinate magnitude, the scale of single precision rounding
+    double coordinateScale(const Vector3Field& pts) {
+        double scale = 1.0;
+        for (const Vector3& p : pts) {
+            scale = std::max({scale, std::fabs(p.x()), std::fabs(p.y()), std::fabs(p.z())});
+        }
+        return scale;
+    }
+
+    // True if every point of a lies within tol of a point of b, and the reverse
+    bool samePoints(const Vector3Field& a, const Vector3Field& b, double tol) {
+        const auto covered = [tol](const Vector3Field& from, const Vector3Field& to) {
+            for (const Vector3& p : from) {
+                double best = 1e300;
+                for (const Vector3& q : to) {
+                    best = std::min(best, (p - q).mag());
+                }
+                if (best > tol) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        return a.size() == b.size() && covered(a, b) && covered(b, a);
+    }
+
+    // Merge and hull pts and its single precision copy fpts, and compare
+    void checkCloud(
+        const std::string& name,
+        const Vector3Field& pts,
+        const Vector3fField& fpts,
+        double mergeTol
+    ) {
+        const index_t n = static_cast<index_t>(pts.size());
+        IndexField map;
+        Vector3Field merged;
+        Vector3fField fmerged;
+        PointCloudTools::mergePointsSubset(pts, mergeTol, n, map, merged);
+        PointCloudTools::mergePointsSubset(fpts, mergeTol, n, map, fmerged);
+        check(
+            merged.size() == fmerged.size(),
+            name + ": merged " + std::to_string(merged.size()) + " points in double, "
+                + std::to_string(fmerged.size()) + " in single precision"
+        );
+
+        Vector3Field chPts[2];
+        IndexField chVertices;
+        std::vector<Face> chFaces;
+        const int nDims = ConvexHullTools::calculateConvexHull3d(
+            merged, 1e-9, chPts[0], chVertices, chFaces
+        );
+        const int nfDims = ConvexHullTools::calculateConvexHull3d(
+            fmerged, 1e-9, chPts[1], chVertices, chFaces
+        );
+        check(nDims == 3 && nfDims == 3, name + ": hull is not 3d");
+        const double tol = 4.0*coordinateScale(pts)*std::numeric_limits<float>::epsilon();
+        check(
+            samePoints(chPts[0], chPts[1], tol),
+            name + ": hull of " + std::to_string(chPts[0].size()) + " points in double, "
+                + std::to_string(chPts[1].size()) + " in single precision, or they differ"
+        );
+        std::printf("%-24s %8d points %8d merged %8d hull\n", name.c_str(),
+            static_cast<int>(n), static_cast<int>(merged.size()),
+            static_cast<int>(chPts[0].size()));
+    }
+
+    // Points on a random ellipsoid, each of the first nRepeats also repeated within mergeTol
+    Vector3Field randomEllipsoidPoints(int n, int nRepeats, double mergeTol, std::mt19937& rng) {
+        std::normal_distribution<double> normal(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(1.0, 5.0);
+        const Vector3 radii(uniform(rng), uniform(rng), uniform(rng));
+        Vector3Field pts;
+        pts.reserve(n + nRepeats);
+        while (static_cast<int>(pts.size()) < n) {
+            Vector3 d(normal(rng), normal(rng), normal(rng));
+            if (!d.normalise()) {
+                continue;
+            }
+            pts.emplace_back(d.x()*radii.x(), d.y()*radii.y(), d.z()*radii.z());
+        }
+        for (int i = 0; i < nRepeats; ++i) {
+            pts.push_back(pts[i] + Vector3(0.1, -0.2, 0.1)*mergeTol);
+        }
+        return pts;
+    }
+
+    // Read filePath in both precisions and hull it as the application does
+    void checkPartFile(const std::string& filePath) {
+        AppOptions opt;
+        opt.mergePoints = true;
+        PreparedHull hulls[2];
+        for (int single = 0; single < 2; ++single) {
+            opt.singlePoints = single == 1;
+            Surface3 surface;
+            std::string error;
+            if (!PartTools::readSurface(surface, error, opt, filePath)) {
+                check(false, error);
+                return;
+            }
+            check(
+                surface.singlePrecision() == opt.singlePoints,
+                filePath + ": read in the wrong precision"
+            );
+            if (single) {
+                // Merging and hulling from the single precision read, as read
+                Vector3Field widened;
+                for (const Vector3f& p : surface.singlePoints()) {
+                    widened.push_back(Vector3(p));
+                }
+                checkCloud("part file, as read", widened, surface.singlePoints(), opt.epsilon);
+            }
+            PartResult result;
+            PartTools::prepareHull(
+                hulls[single], result, opt, surface, std::chrono::steady_clock::now()
+            );
+        }
+        check(
+            hulls[0].m_nPoints == hulls[1].m_nPoints,
+            filePath + ": read " + std::to_string(hulls[0].m_nPoints) + " points in double, "
+                + std::to_string(hulls[1].m_nPoints) + " in single precision"
+        );
+        const double tol =
+            4.0*coordinateScale(hulls[0].m_chPts)*std::numeric_limits<float>::epsilon();
+        check(
+            samePoints(hulls[0].m_chPts, hulls[1].m_chPts, tol),
+            filePath + ": hulls differ between double and single precision reads"
+        );
+        std::printf("%-24s %8d points %8s        %8d hull\n", "part file",
+            static_cast<int>(hulls[0].m_nPoints), "",
+            static_cast<int>(hulls[0].m_nHullPoints));
+    }
+
+} // end anonymous namespace
+
+
+int main(int argc, char** argv) {
+    std::mt19937 rng(13579);
+    const double mergeTol = 1e-6;
+    const int sizes[] = {100, 1000, 3000};
+    for (const int n : sizes) {
+        const Vector3Field pts(randomEllipsoidPoints(n, n/10, mergeTol, rng));
+        Vector3fField fpts;
+        fpts.reserve(pts.size());
+        for (const Vector3& p : pts) {
+            fpts.push_back(Vector3f(p));
+        }
+        checkCloud("ellipsoid " + std::to_string(n), pts, fpts, mergeTol);
+    }
+    for (int i = 1; i < argc; ++i) {
+        checkPartFile(argv[i]);
+    }
+    if (g_nFailed > 0) {
+        std::printf("%d checks failed\n", g_nFailed);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}